@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include "nhbase/api.h"
@@ -14,4 +15,13 @@ NB_API
 bool
 file_rename(const std::string &from, const std::string &to, bool force);
 
+/// @brief Map the whole file into memory, read-only.
+/// @return nullptr if it fails or the file is empty.
+NB_API
+const void *
+file_map(const std::string &path, std::size_t *size);
+NB_API
+void
+file_unmap(const void *data, std::size_t size);
+
 } // namespace nb
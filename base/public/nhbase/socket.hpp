@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "nhbase/api.h"
+
+namespace nb {
+
+/// @brief Non-blocking datagram socket, -1 if invalid.
+typedef std::intptr_t socket_t;
+
+/// @brief UDP, bound to "port" on all interfaces, 0 for any free one.
+NB_API
+socket_t
+udp_open(std::uint16_t port);
+/// @brief Send to and receive from "host" at "port" only.
+NB_API
+bool
+udp_connect(socket_t sock, const std::string &host, std::uint16_t port);
+
+/// @brief Unix-domain, bound to "path", replaced if it exists.
+NB_API
+socket_t
+local_open(const std::string &path);
+/// @brief Send to and receive from the one bound to "path" only.
+/// @return false until it's bound.
+NB_API
+bool
+local_connect(socket_t sock, const std::string &path);
+
+/// @return If it's sent whole.
+NB_API
+bool
+socket_send(socket_t sock, const void *data, std::size_t size);
+/// @return Size of the datagram taken, 0 if there is none.
+NB_API
+std::size_t
+socket_recv(socket_t sock, void *data, std::size_t size);
+NB_API
+void
+socket_close(socket_t sock);
+
+} // namespace nb
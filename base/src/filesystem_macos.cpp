@@ -1,6 +1,9 @@
 #include "nhbase/filesystem.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace nb {
 
@@ -11,4 +14,38 @@ file_exists(const std::string &path)
     return (stat(path.c_str(), &st) == 0) && !(st.st_mode & S_IFDIR);
 }
 
+const void *
+file_map(const std::string &path, std::size_t *size)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        data = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+    }
+    // The mapping keeps the file.
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    *size = std::size_t(st.st_size);
+    return data;
+}
+
+void
+file_unmap(const void *data, std::size_t size)
+{
+    if (data)
+    {
+        munmap(const_cast<void *>(data), size);
+    }
+}
+
 } // namespace nb
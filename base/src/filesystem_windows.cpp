@@ -12,4 +12,47 @@ file_exists(const std::string &path)
            !(attr & FILE_ATTRIBUTE_DIRECTORY);
 }
 
+const void *
+file_map(const std::string &path, std::size_t *size)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+    LARGE_INTEGER file_size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        mapping =
+            CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    void *data = nullptr;
+    if (mapping)
+    {
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // The view keeps them.
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if (!data)
+    {
+        return nullptr;
+    }
+    *size = std::size_t(file_size.QuadPart);
+    return data;
+}
+
+void
+file_unmap(const void *data, std::size_t size)
+{
+    (void)size;
+    if (data)
+    {
+        UnmapViewOfFile(data);
+    }
+}
+
 } // namespace nb
@@ -0,0 +1,122 @@
+#include "nhbase/socket.hpp"
+
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace nb {
+
+static socket_t
+pv_open(int domain, const sockaddr *addr, socklen_t len);
+static bool
+pv_local_addr(const std::string &path, sockaddr_un &addr);
+
+socket_t
+udp_open(std::uint16_t port)
+{
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    return pv_open(AF_INET, (const sockaddr *)&addr, sizeof(addr));
+}
+
+bool
+udp_connect(socket_t sock, const std::string &host, std::uint16_t port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *info = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &info) || !info)
+    {
+        return false;
+    }
+    sockaddr_in addr;
+    std::memcpy(&addr, info->ai_addr, sizeof(addr));
+    freeaddrinfo(info);
+    addr.sin_port = htons(port);
+    return connect(int(sock), (const sockaddr *)&addr, sizeof(addr)) == 0;
+}
+
+socket_t
+local_open(const std::string &path)
+{
+    sockaddr_un addr;
+    if (!pv_local_addr(path, addr))
+    {
+        return -1;
+    }
+    unlink(path.c_str());
+    return pv_open(AF_UNIX, (const sockaddr *)&addr, sizeof(addr));
+}
+
+bool
+local_connect(socket_t sock, const std::string &path)
+{
+    sockaddr_un addr;
+    return pv_local_addr(path, addr) &&
+           connect(int(sock), (const sockaddr *)&addr, sizeof(addr)) == 0;
+}
+
+bool
+socket_send(socket_t sock, const void *data, std::size_t size)
+{
+    return send(int(sock), data, size, 0) == ssize_t(size);
+}
+
+std::size_t
+socket_recv(socket_t sock, void *data, std::size_t size)
+{
+    // Errors of what was sent before, e.g. the peer not there yet, count as
+    // nothing received.
+    ssize_t got = recv(int(sock), data, size, 0);
+    return got > 0 ? std::size_t(got) : 0;
+}
+
+void
+socket_close(socket_t sock)
+{
+    if (sock >= 0)
+    {
+        close(int(sock));
+    }
+}
+
+socket_t
+pv_open(int domain, const sockaddr *addr, socklen_t len)
+{
+    int sock = socket(domain, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return -1;
+    }
+    if (bind(sock, addr, len) ||
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK))
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+bool
+pv_local_addr(const std::string &path, sockaddr_un &addr)
+{
+    std::memset(&addr, 0, sizeof(addr));
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    {
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+} // namespace nb
@@ -0,0 +1,63 @@
+#include "nhbase/socket.hpp"
+
+namespace nb {
+
+// @TODO: Browsers have no datagram sockets, WebRTC data channels are the
+// nearest.
+
+socket_t
+udp_open(std::uint16_t port)
+{
+    (void)port;
+    return -1;
+}
+
+bool
+udp_connect(socket_t sock, const std::string &host, std::uint16_t port)
+{
+    (void)sock;
+    (void)host;
+    (void)port;
+    return false;
+}
+
+socket_t
+local_open(const std::string &path)
+{
+    (void)path;
+    return -1;
+}
+
+bool
+local_connect(socket_t sock, const std::string &path)
+{
+    (void)sock;
+    (void)path;
+    return false;
+}
+
+bool
+socket_send(socket_t sock, const void *data, std::size_t size)
+{
+    (void)sock;
+    (void)data;
+    (void)size;
+    return false;
+}
+
+std::size_t
+socket_recv(socket_t sock, void *data, std::size_t size)
+{
+    (void)sock;
+    (void)data;
+    (void)size;
+    return 0;
+}
+
+void
+socket_close(socket_t sock)
+{
+    (void)sock;
+}
+
+} // namespace nb
@@ -0,0 +1,109 @@
+#include "nhbase/socket.hpp"
+
+#include <cstring>
+
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+namespace nb {
+
+static bool
+pv_startup();
+
+socket_t
+udp_open(std::uint16_t port)
+{
+    if (!pv_startup())
+    {
+        return -1;
+    }
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET)
+    {
+        return -1;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    u_long non_blocking = 1;
+    if (bind(sock, (const sockaddr *)&addr, sizeof(addr)) ||
+        ioctlsocket(sock, FIONBIO, &non_blocking))
+    {
+        closesocket(sock);
+        return -1;
+    }
+    return socket_t(sock);
+}
+
+bool
+udp_connect(socket_t sock, const std::string &host, std::uint16_t port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *info = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &info) || !info)
+    {
+        return false;
+    }
+    sockaddr_in addr;
+    std::memcpy(&addr, info->ai_addr, sizeof(addr));
+    freeaddrinfo(info);
+    addr.sin_port = htons(port);
+    return connect(SOCKET(sock), (const sockaddr *)&addr, sizeof(addr)) == 0;
+}
+
+socket_t
+local_open(const std::string &path)
+{
+    // @TODO: Unix-domain sockets on Windows are stream only.
+    (void)path;
+    return -1;
+}
+
+bool
+local_connect(socket_t sock, const std::string &path)
+{
+    (void)sock;
+    (void)path;
+    return false;
+}
+
+bool
+socket_send(socket_t sock, const void *data, std::size_t size)
+{
+    return send(SOCKET(sock), (const char *)data, int(size), 0) == int(size);
+}
+
+std::size_t
+socket_recv(socket_t sock, void *data, std::size_t size)
+{
+    // Errors of what was sent before, e.g. the peer not there yet, count as
+    // nothing received.
+    int got = recv(SOCKET(sock), (char *)data, int(size), 0);
+    return got > 0 ? std::size_t(got) : 0;
+}
+
+void
+socket_close(socket_t sock)
+{
+    if (sock >= 0)
+    {
+        closesocket(SOCKET(sock));
+    }
+}
+
+bool
+pv_startup()
+{
+    // Once for the process, never cleaned up.
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+} // namespace nb
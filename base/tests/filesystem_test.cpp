@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
 
 #include "nhbase/filesystem.hpp"
+#include "nhbase/vc_intrinsics.hpp"
+
+#include <cstdio>
+#include <cstring>
 
 TEST(filesystem_test, file_exists)
 {
@@ -9,3 +13,26 @@ TEST(filesystem_test, file_exists)
     // directory input
     EXPECT_FALSE(nb::file_exists("./"));
 }
+
+TEST(filesystem_test, file_map)
+{
+    std::size_t size = 0;
+    // nonexistent file
+    EXPECT_EQ(nb::file_map("./nonexistent_file_map_test", &size), nullptr);
+
+    const char content[] = "nesish";
+    NB_VC_WARNING_PUSH
+    NB_VC_WARNING_DISABLE(4996)
+    std::FILE *fp = std::fopen("./file_map_test", "wb");
+    NB_VC_WARNING_POP
+    ASSERT_NE(fp, nullptr);
+    std::fwrite(content, 1, sizeof(content), fp);
+    std::fclose(fp);
+
+    const void *data = nb::file_map("./file_map_test", &size);
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(size, sizeof(content));
+    EXPECT_EQ(std::memcmp(data, content, sizeof(content)), 0);
+    nb::file_unmap(data, size);
+    std::remove("./file_map_test");
+}
@@ -0,0 +1,315 @@
+// Headless throughput benchmark for the core.
+// Runs each ROM uncapped for a number of frames with scripted input, then
+// reports the results as JSON on stdout.
+//
+// Usage: nesish-bench [--frames N] [--warmup N] [rom ...]
+// Without ROM arguments, the default workload copied next to the executable
+// is used, see CMakeLists.txt.
+
+#include "nesish/nesish.h"
+#include "nhbase/path.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#define BENCH_FRAMES_DEF 600
+#define BENCH_WARMUP_DEF 60
+
+// Must be in sync with the workload copied in CMakeLists.txt
+static const char *g_default_roms[] = {
+    "nestest.nes",          //
+    "official_only.nes",    //
+    "cpu_timing_test.nes",  //
+    "oam_stress.nes",       //
+    "09.timing_basics.nes", //
+    "apu_test.nes",         //
+    "dma_2007_read.nes",    //
+};
+
+struct BenchCtrl {
+    NHByte mask; // bit i for NHKey i
+    bool strobing;
+    unsigned int idx;
+};
+
+struct BenchResult {
+    std::string rom;
+    bool ok;
+    int frames;
+    NHCycle cycles;
+    double seconds;
+};
+
+static void
+pv_strobe(int enabled, void *user);
+static int
+pv_report(void *user);
+static void
+pv_reset(void *user);
+
+static NHByte
+pv_script_mask(int i_frame);
+static bool
+pv_bench_rom(const std::string &i_path, int i_frames, int i_warmup,
+             BenchResult &o_result);
+
+static long
+pv_peak_rss_kb();
+static std::string
+pv_json_escape(const std::string &i_str);
+
+int
+main(int argc, char **argv)
+{
+    int frames = BENCH_FRAMES_DEF;
+    int warmup = BENCH_WARMUP_DEF;
+    std::vector<std::string> roms;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc)
+        {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--warmup") && i + 1 < argc)
+        {
+            warmup = std::atoi(argv[++i]);
+        }
+        else if (argv[i][0] == '-')
+        {
+            std::fprintf(stderr,
+                         "Usage: %s [--frames N] [--warmup N] [rom ...]\n",
+                         argv[0]);
+            return 1;
+        }
+        else
+        {
+            roms.push_back(argv[i]);
+        }
+    }
+    if (frames <= 0 || warmup < 0)
+    {
+        std::fprintf(stderr, "Invalid frame count\n");
+        return 1;
+    }
+    if (roms.empty())
+    {
+        for (const char *name : g_default_roms)
+        {
+            roms.push_back(nb::resolve_exe_dir(nb::path_join("bench", name)));
+        }
+    }
+
+    std::vector<BenchResult> results;
+    int total_frames = 0;
+    NHCycle total_cycles = 0;
+    double total_seconds = 0;
+    bool all_ok = true;
+    for (const auto &rom : roms)
+    {
+        BenchResult result;
+        if (!pv_bench_rom(rom, frames, warmup, result))
+        {
+            all_ok = false;
+        }
+        else
+        {
+            total_frames += result.frames;
+            total_cycles += result.cycles;
+            total_seconds += result.seconds;
+        }
+        results.push_back(result);
+    }
+
+    std::printf("{\n");
+    std::printf("  \"frames_per_rom\": %d,\n", frames);
+    std::printf("  \"warmup_frames\": %d,\n", warmup);
+    std::printf("  \"roms\": [\n");
+    for (decltype(results.size()) i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &r = results[i];
+        const char *sep = i + 1 < results.size() ? "," : "";
+        if (!r.ok)
+        {
+            std::printf("    {\"rom\": \"%s\", \"error\": \"failed to load\"}%s\n",
+                        pv_json_escape(r.rom).c_str(), sep);
+            continue;
+        }
+        std::printf("    {\"rom\": \"%s\", \"frames\": %d, \"cpu_cycles\": %zu, "
+                    "\"seconds\": %.6f, \"fps\": %.2f, \"ns_per_cycle\": "
+                    "%.3f}%s\n",
+                    pv_json_escape(r.rom).c_str(), r.frames, r.cycles,
+                    r.seconds, r.frames / r.seconds,
+                    r.seconds * 1e9 / double(r.cycles), sep);
+    }
+    std::printf("  ],\n");
+    std::printf("  \"total\": {\"frames\": %d, \"cpu_cycles\": %zu, "
+                "\"seconds\": %.6f, \"fps\": %.2f, \"ns_per_cycle\": %.3f},\n",
+                total_frames, total_cycles, total_seconds,
+                total_seconds > 0 ? total_frames / total_seconds : 0.0,
+                total_cycles ? total_seconds * 1e9 / double(total_cycles)
+                             : 0.0);
+    std::printf("  \"peak_rss_kb\": %ld\n", pv_peak_rss_kb());
+    std::printf("}\n");
+
+    return all_ok ? 0 : 1;
+}
+
+void
+pv_strobe(int enabled, void *user)
+{
+    BenchCtrl *ctrl = (BenchCtrl *)user;
+    ctrl->strobing = enabled;
+    if (!enabled)
+    {
+        ctrl->idx = NH_KEY_BEGIN;
+    }
+}
+
+int
+pv_report(void *user)
+{
+    BenchCtrl *ctrl = (BenchCtrl *)user;
+    if (ctrl->strobing)
+    {
+        return ctrl->mask & (1 << NH_KEY_A) ? 1 : 0;
+    }
+    if (ctrl->idx < NH_KEY_END)
+    {
+        return (ctrl->mask >> ctrl->idx++) & 0x01;
+    }
+    return 1;
+}
+
+void
+pv_reset(void *user)
+{
+    BenchCtrl *ctrl = (BenchCtrl *)user;
+    ctrl->strobing = false;
+    ctrl->idx = NH_KEY_END;
+}
+
+NHByte
+pv_script_mask(int i_frame)
+{
+    // Deterministic input: tap START every 2 seconds, hold a direction that
+    // rotates every second, and press A on and off in between. This keeps menu
+    // driven ROMs (e.g. nestest) moving while being identical across runs.
+    NHByte mask = 0;
+    if (i_frame % 120 < 4)
+    {
+        mask |= 1 << NH_KEY_START;
+    }
+    static const NHKey dirs[] = {NH_KEY_DOWN, NH_KEY_RIGHT, NH_KEY_UP,
+                                 NH_KEY_LEFT};
+    mask |= 1 << dirs[(i_frame / 60) % 4];
+    if (i_frame % 16 < 8)
+    {
+        mask |= 1 << NH_KEY_A;
+    }
+    return mask;
+}
+
+bool
+pv_bench_rom(const std::string &i_path, int i_frames, int i_warmup,
+             BenchResult &o_result)
+{
+    o_result.rom = i_path;
+    o_result.ok = false;
+    o_result.frames = 0;
+    o_result.cycles = 0;
+    o_result.seconds = 0;
+
+    NHConsole console = nh_new_console(nullptr);
+    if (!NH_VALID(console))
+    {
+        return false;
+    }
+
+    BenchCtrl p1{0, false, NH_KEY_END};
+    NHController ctrl{pv_strobe, pv_report, pv_reset, &p1};
+    nh_plug_ctrl(console, NH_CTRL_P1, &ctrl);
+
+    if (NH_FAILED(nh_insert_cartridge(console, i_path.c_str())))
+    {
+        nh_release_console(console);
+        return false;
+    }
+    nh_power_up(console);
+
+    for (int i = 0; i < i_warmup; ++i)
+    {
+        p1.mask = pv_script_mask(i);
+        (void)nh_run_frame(console);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    NHCycle cycles = 0;
+    for (int i = 0; i < i_frames; ++i)
+    {
+        p1.mask = pv_script_mask(i_warmup + i);
+        cycles += nh_run_frame(console);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    o_result.ok = true;
+    o_result.frames = i_frames;
+    o_result.cycles = cycles;
+    o_result.seconds = std::chrono::duration<double>(end - start).count();
+
+    nh_unplug_ctrl(console, NH_CTRL_P1);
+    nh_release_console(console);
+    return true;
+}
+
+long
+pv_peak_rss_kb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    {
+        return -1;
+    }
+    return long(pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+    {
+        return -1;
+    }
+#if defined(__APPLE__)
+    // In bytes on macOS
+    return long(usage.ru_maxrss / 1024);
+#else
+    // In kilobytes on Linux
+    return long(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::string
+pv_json_escape(const std::string &i_str)
+{
+    std::string escaped;
+    for (char c : i_str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
@@ -3,6 +3,7 @@
 #include "nesish/api.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,7 @@ typedef size_t NHCycle;
 
 #define NH_NES_WIDTH 256
 #define NH_NES_HEIGHT 240
+#define NH_RAM_SIZE 2048 // Internal RAM of the console
 
 typedef int NHErr;
 enum {
@@ -62,6 +64,13 @@ NH_API NHConsole
 nh_new_console(NHLogger *logger);
 NH_API void
 nh_release_console(NHConsole console);
+/// @brief Another console at the same point, independent of this one but
+/// sharing the ROM. Controllers and debug flags are carried over, but not the
+/// audio sink, frame target, rewind or run-ahead. The first frame shown is the
+/// next completed.
+/// @param clone Released by nh_release_console().
+NH_API NHErr
+nh_clone_console(NHConsole console, NHConsole *clone);
 
 /// @note Valid as array index
 typedef int NHCtrlPort;
@@ -98,39 +107,355 @@ NH_API void
 nh_plug_ctrl(NHConsole console, NHCtrlPort slot, NHController *ctrl);
 NH_API void
 nh_unplug_ctrl(NHConsole console, NHCtrlPort slot);
+/// @brief Plug a standard controller emulated in the core into "slot", in
+/// place of any NHController, with "buttons" held, bit i for NHKey i. Set them
+/// whenever they change, e.g. before each frame; nothing is called back. The
+/// shift register they're read through is part of states, they are not.
+NH_API void
+nh_set_buttons(NHConsole console, NHCtrlPort slot, NHByte buttons);
 
 NH_API NHErr
 nh_insert_cartridge(NHConsole console, const char *rom_path);
 NH_API void
 nh_remove_cartridge(NHConsole console);
 
+typedef struct NHRomTy *NHRom;
+
+/// @brief Load a ROM once to insert into any number of consoles, which share
+/// it. Only RAM and mapper registers are of each console.
+/// @param logger Optional
+NH_API NHErr
+nh_load_rom(const char *rom_path, NHLogger *logger, NHRom *rom);
+/// @brief Consoles it's inserted into keep the ROM on their own.
+NH_API void
+nh_release_rom(NHRom rom);
+NH_API NHErr
+nh_insert_rom(NHConsole console, NHRom rom);
+
 NH_API void
 nh_power_up(NHConsole console);
 NH_API void
 nh_reset(NHConsole console);
 
+/// @brief Convert elapsed time to CPU cycles to run. Time is accumulated in
+/// integer units across calls, so no cycle drifts away over long sessions.
 NH_API NHCycle
 nh_advance(NHConsole console, double delta);
 NH_API int
 nh_tick(NHConsole console, int *cpu_instr);
 
+typedef int NHEvent;
+enum {
+    NH_EVENT_NONE = 0,
+    NH_EVENT_FRAME = 1 << 0,     // A frame is completed.
+    NH_EVENT_CPU_INSTR = 1 << 1, // A CPU instruction is completed.
+};
+
+/// @brief Run the given number of CPU cycles.
+NH_API void
+nh_run_cycles(NHConsole console, NHCycle cycles);
+/// @brief Run until a frame is completed.
+/// @return CPU cycles run.
+NH_API NHCycle
+nh_run_frame(NHConsole console);
+/// @brief Run until any of "events" occurs or "max_cycles" CPU cycles are run.
+/// @param cycles Optional, CPU cycles run.
+/// @return Events occurred among "events", NH_EVENT_NONE if budget ran out.
+NH_API NHEvent
+nh_run_until(NHConsole console, NHEvent events, NHCycle max_cycles,
+             NHCycle *cycles);
+
+/// @brief Bytes of a state saved by nh_save_state(), fixed for the inserted
+/// cartridge.
+/// @return 0 if no cartridge is inserted.
+NH_API size_t
+nh_state_size(NHConsole console);
+/// @brief Save the whole console into "buf", without allocation. Frames and
+/// what the host owns, e.g. controllers, are not part of it.
+/// @return NH_ERR_INVALID_ARGUMENT if "size" is less than nh_state_size().
+NH_API NHErr
+nh_save_state(NHConsole console, void *buf, size_t size);
+/// @brief Load a state saved by nh_save_state() for the same cartridge. The
+/// console is left untouched on failure.
+/// @return NH_ERR_CORRUPTED if it isn't a state of this version,
+/// NH_ERR_INVALID_ARGUMENT if it's of another cartridge.
+NH_API NHErr
+nh_load_state(NHConsole console, const void *buf, size_t size);
+/// @brief 64-bit hash of what nh_save_state() saves, in a few microseconds
+/// and without allocation, to tell whether consoles are in the same state,
+/// e.g. netplay peers or a replay against its recording, or whether one has
+/// been visited. The same across hosts.
+/// @return 0 if no cartridge is inserted.
+NH_API uint64_t
+nh_state_hash(NHConsole console);
+
+/// @brief Take a snapshot every "interval" frames to step back to. Only the
+/// latest is whole, older ones are kept as deltas within "capacity" bytes, the
+/// oldest dropped first. 0 "interval" turns it off and frees them.
+NH_API NHErr
+nh_set_rewind(NHConsole console, int interval, size_t capacity);
+/// @brief Step back to the latest snapshot at least "frames" frames ago, or
+/// the oldest kept. Snapshots after it are dropped. The frame is left as it is
+/// until the next one completes.
+/// @param rewound Optional, frames actually stepped back.
+/// @return NH_ERR_UNAVAILABLE if there is no snapshot yet.
+NH_API NHErr
+nh_rewind(NHConsole console, int frames, int *rewound);
+
+/// @brief Hide the game's own input lag: whenever nh_run_cycles() or
+/// nh_run_frame() completes a frame, run "frames" more with the same input and
+/// show the last of them, then take them back. Nothing of them is heard or
+/// captured for debugging. 0 turns it off.
+NH_API NHErr
+nh_set_run_ahead(NHConsole console, int frames);
+
+/// @brief Skip iterations of loops that only wait, e.g. polling VBL or RAM an
+/// NMI changes, with the same outcome to the cycle. Saves the CPU's share of
+/// the time it idles. Only nh_tick() and nh_run_until() with
+/// NH_EVENT_CPU_INSTR run every instruction regardless. Off by default.
+NH_API void
+nh_set_idle_skip(NHConsole console, int enabled);
+
+typedef struct NHMovieTy *NHMovie;
+
+typedef int NHMovieEvent;
+enum {
+    NH_MOVIE_EVENT_NONE = 0,
+    NH_MOVIE_EVENT_POWER = 1 << 0, // Powered up as a new console.
+    NH_MOVIE_EVENT_RESET = 1 << 1,
+};
+
+/// @brief Input of a session frame by frame, to play it back exactly, e.g. as
+/// a benchmark workload or a regression case, headless and at full speed.
+/// Both ports have the controllers of nh_set_buttons() throughout. The first
+/// frame powers up, into the same state as a new console whatever ran before.
+/// @param logger Optional
+NH_API NHMovie
+nh_new_movie(NHLogger *logger);
+NH_API void
+nh_release_movie(NHMovie movie);
+/// @brief Load a movie saved by nh_save_movie(), compact with runs of the
+/// same input squeezed.
+/// @return NH_ERR_CORRUPTED if it isn't a movie of this version.
+NH_API NHErr
+nh_load_movie(const char *path, NHLogger *logger, NHMovie *movie);
+NH_API NHErr
+nh_save_movie(NHMovie movie, const char *path);
+NH_API size_t
+nh_movie_frames(NHMovie movie);
+/// @brief Append a frame and run the console through it the way
+/// nh_movie_play() will, events first.
+/// @return NH_ERR_INVALID_ARGUMENT if the cartridge isn't the one of the
+/// frames before.
+NH_API NHErr
+nh_movie_record(NHMovie movie, NHConsole console, NHByte p1, NHByte p2,
+                NHMovieEvent events);
+/// @brief Run the console through frame "frame", played in order from 0.
+/// @return NH_ERR_INVALID_ARGUMENT if out of range or of another cartridge.
+NH_API NHErr
+nh_movie_play(NHMovie movie, NHConsole console, size_t frame);
+
+typedef struct NHMovieIndexTy *NHMovieIndex;
+
+/// @brief Save the state of the console every "interval" frames while playing
+/// "movie" on it from frame 0, for nh_movie_seek() to start from the closest
+/// one rather than the beginning. Worth it for long movies seeked around.
+NH_API NHErr
+nh_build_movie_index(NHMovie movie, NHConsole console, int interval,
+                     const char *path);
+/// @brief Map an index built by nh_build_movie_index() into memory, states
+/// loaded from it only as seeked to. Frames recorded since still go.
+/// @param movie Must outlive the index
+/// @param logger Optional
+/// @return NH_ERR_CORRUPTED if it isn't an index of this version,
+/// NH_ERR_INVALID_ARGUMENT if the frames it covers aren't those of "movie".
+NH_API NHErr
+nh_open_movie_index(const char *path, NHMovie movie, NHLogger *logger,
+                    NHMovieIndex *index);
+NH_API void
+nh_close_movie_index(NHMovieIndex index);
+/// @brief Put the console where it is after the frames before "frame" are
+/// played, so that nh_movie_play() continues from "frame". Its frame buffer
+/// is left as it was until the next frame.
+/// @return NH_ERR_INVALID_ARGUMENT if out of range or of another cartridge.
+NH_API NHErr
+nh_movie_seek(NHMovieIndex index, NHConsole console, size_t frame);
+
+/// @brief Carries datagrams between the two peers of a netplay, e.g. over an
+/// NHNetSocket. They may be lost, duplicated or reordered; nothing blocks.
+typedef struct NHNetTransport {
+    void (*send)(const void *data, size_t size, void *user);
+    /// @return Size of the datagram taken, 0 if there is none.
+    size_t (*recv)(void *data, size_t size, void *user);
+    void *user;
+} NHNetTransport;
+
+typedef struct NHNetSocketTy *NHNetSocket;
+
+/// @brief UDP bound to "port" on all interfaces, to the peer at
+/// "remote_host":"remote_port".
+/// @param logger Optional
+NH_API NHErr
+nh_open_udp_socket(int port, const char *remote_host, int remote_port,
+                   NHLogger *logger, NHNetSocket *socket);
+/// @brief Unix-domain bound to "path", to the peer bound to "remote_path",
+/// for both on one machine. Sent datagrams are dropped until the peer binds.
+/// @param logger Optional
+NH_API NHErr
+nh_open_local_socket(const char *path, const char *remote_path,
+                     NHLogger *logger, NHNetSocket *socket);
+NH_API void
+nh_close_socket(NHNetSocket socket);
+/// @brief Hold every datagram sent "latency" ms, plus up to "jitter" more at
+/// random, to try netplay out on one machine as over a network.
+NH_API void
+nh_socket_set_lag(NHNetSocket socket, int latency, int jitter);
+/// @return Valid until the socket is closed
+NH_API NHNetTransport *
+nh_socket_transport(NHNetSocket socket);
+
+typedef struct NHNetplayTy *NHNetplay;
+
+typedef struct NHNetplayStats {
+    size_t frame;      // Frames run.
+    size_t confirmed;  // Frames the remote input is known for.
+    size_t rollbacks;  // Times input was mispredicted.
+    size_t reruns;     // Frames run over again for it.
+} NHNetplayStats;
+
+/// @brief Two players on two consoles, each with this session over
+/// "transport" to the other. The console is powered up as new, the local
+/// player on "port" and the remote one on the other, both with the
+/// controllers of nh_set_buttons(). Remote input is predicted to be what it
+/// last was, frames are rolled back and run again when it turns out not.
+/// @param max_rollback Frames run ahead of the remote input at most, 1 to 64.
+/// A rollback re-runs all its frames within one nh_netplay_run_frame().
+/// @param logger Optional
+NH_API NHErr
+nh_new_netplay(NHConsole console, NHCtrlPort port, NHNetTransport *transport,
+               int max_rollback, NHLogger *logger, NHNetplay *netplay);
+NH_API void
+nh_release_netplay(NHNetplay netplay);
+/// @brief Take in remote input, correcting the frames before, and run a frame
+/// with "buttons" of the local player. Call it each host frame.
+/// @return NH_ERR_UNAVAILABLE if "max_rollback" frames are already run ahead
+/// of the remote input; nothing is run, the local input is dropped.
+NH_API NHErr
+nh_netplay_run_frame(NHNetplay netplay, NHByte buttons);
+NH_API void
+nh_netplay_get_stats(NHNetplay netplay, NHNetplayStats *stats);
+
+/// @brief Receives samples generated by the run APIs above in batches, at the
+/// rate of nh_get_sample_rate(). "samples" is valid only during the call.
+typedef struct NHAudioSink {
+    void (*write)(const double *samples, size_t count, void *user);
+    void *user;
+} NHAudioSink;
+
+NH_API void
+nh_plug_audio_sink(NHConsole console, NHAudioSink *sink);
+NH_API void
+nh_unplug_audio_sink(NHConsole console);
+
 typedef struct NHFrameTy *NHFrame;
 
+typedef enum NHPixelFormat {
+    NH_PIXEL_FORMAT_RGB888 = 0,   // 3 bytes: R, G, B
+    NH_PIXEL_FORMAT_RGBA8888 = 1, // 4 bytes: R, G, B, A
+    NH_PIXEL_FORMAT_BGRA8888 = 2, // 4 bytes: B, G, R, A
+    NH_PIXEL_FORMAT_RGB565 = 3,   // 16-bit native endian, red in high bits
+} NHPixelFormat;
+
 NH_API int
 nh_frm_width(NHFrame frame);
 NH_API int
 nh_frm_height(NHFrame frame);
+/// @brief RGB888 pixels, row by row. Converted from palette colors on the first
+/// call after the frame changes.
 NH_API const NHByte *
 nh_frm_data(NHFrame frame);
+/// @brief Palette colors of the pixels, 1 byte each, row by row. The lower 6
+/// bits index nh_frm_palette(), e.g. for lookup in a shader.
+NH_API const NHByte *
+nh_frm_indices(NHFrame frame);
+/// @brief RGB888 of the 64 palette colors.
+NH_API const NHByte *
+nh_frm_palette(NHFrame frame);
+/// @brief Convert the pixels to "format" into "dst", with rows "pitch" bytes
+/// apart.
+NH_API void
+nh_frm_convert(NHFrame frame, void *dst, int pitch, NHPixelFormat format);
 
 NH_API NHFrame
 nh_get_frm(NHConsole console);
+/// @brief Have each frame converted into "pixels" as it completes, the current
+/// one included, so no copy from nh_get_frm() is needed. Row i starts at
+/// "pixels" + i * "pitch", so a negative pitch gives bottom-up rows. "pixels"
+/// must stay valid until replaced or NH_NULL is set.
+/// @return NH_ERR_INVALID_ARGUMENT if "format" is unknown or rows overlap.
+NH_API NHErr
+nh_set_frame_target(NHConsole console, void *pixels, int pitch,
+                    NHPixelFormat format);
+
+/// @brief Have frames also in grayscale at "width" x "height", each pixel the
+/// average of those it covers, written into "pixels" by the PPU as it renders,
+/// so there's no pass over the frame after. Rows are "pitch" bytes apart. A
+/// frame is all there once it completes. NH_NULL "pixels" stops it.
+/// @return NH_ERR_INVALID_ARGUMENT if larger than a frame or rows overlap.
+NH_API NHErr
+nh_set_observation(NHConsole console, NHByte *pixels, int width, int height,
+                   int pitch);
+
+/// @brief The internal RAM, NH_RAM_SIZE bytes, read as it is without any side
+/// effect of a CPU read. Valid as long as the console.
+NH_API const NHByte *
+nh_get_ram(NHConsole console);
+/// @brief PRG RAM of the cartridge, read as it is, valid until the cartridge
+/// is removed.
+/// @return NH_NULL if there's none.
+NH_API const NHByte *
+nh_get_prg_ram(NHConsole console, size_t *size);
 
 NH_API int
 nh_get_sample_rate(NHConsole console);
 NH_API double
 nh_get_sample(NHConsole console);
 
+typedef struct NHPoolTy *NHPool;
+
+/// @brief "consoles" consoles of "rom" powered up, to step a frame at a time
+/// all together over "threads" threads, the calling one included, 0 for one
+/// per hardware thread. Each has a controller of its own on NH_CTRL_P1.
+/// @param logger Optional
+NH_API NHErr
+nh_new_pool(NHRom rom, int consoles, int threads, NHLogger *logger,
+            NHPool *pool);
+NH_API void
+nh_release_pool(NHPool pool);
+/// @brief Console at "index", e.g. to save or load its state between steps.
+/// It's owned by the pool.
+/// @return NH_NULL if "index" is out of range.
+NH_API NHConsole
+nh_pool_get_console(NHPool pool, int index);
+/// @brief End an episode after "frames" frames, 0 for no limit, the default.
+NH_API void
+nh_pool_set_episode(NHPool pool, int frames);
+/// @brief nh_set_frame_target() of console i to "pixels" + i * "stride", so
+/// that all frames end up in one batch. NH_NULL "pixels" stops it.
+NH_API NHErr
+nh_pool_set_frame_targets(NHPool pool, void *pixels, ptrdiff_t stride,
+                          int pitch, NHPixelFormat format);
+/// @brief nh_set_observation() of console i to "pixels" + i * "stride".
+NH_API NHErr
+nh_pool_set_observations(NHPool pool, NHByte *pixels, ptrdiff_t stride,
+                         int width, int height, int pitch);
+/// @brief Run every console a frame, without allocation.
+/// @param actions Optional, keys pressed on each console, bit i for NHKey i.
+/// @param dones Optional, set to 1 for each console whose episode ended, by
+/// the frame limit or the CPU halting, and which starts over from power up.
+NH_API void
+nh_pool_step(NHPool pool, const NHByte *actions, NHByte *dones);
+
 typedef enum NHDFlag {
     NHD_DBG_OFF = 0,
     NHD_DBG_PALETTE = 1 << 0,
@@ -2,6 +2,7 @@
 
 #include "spec.hpp"
 #include "apu/apu_clock.hpp"
+#include "state_io.hpp"
 
 namespace nh {
 
@@ -144,6 +145,19 @@ APU::interrupt() const
     return m_fc.interrupt() || m_dmc.interrupt();
 }
 
+bool
+APU::may_interrupt() const
+{
+    // The DMC's only at the end of a sample.
+    return m_fc.may_interrupt() || m_dmc.bytes_remained();
+}
+
+bool
+APU::dmc_fetching() const
+{
+    return m_dmc.bytes_remained();
+}
+
 void
 APU::put_dmc_sample(Address i_sample_addr, Byte i_sample)
 {
@@ -404,4 +418,17 @@ APU::MixerLookup::MixerLookup()
     }
 }
 
+void
+APU::serialize(StateIO &io_state)
+{
+    io_state.bytes(m_regs, sizeof(m_regs));
+
+    m_fc.serialize(io_state);
+    m_pulse1.serialize(io_state);
+    m_pulse2.serialize(io_state);
+    m_triangle.serialize(io_state);
+    m_noise.serialize(io_state);
+    m_dmc.serialize(io_state);
+}
+
 } // namespace nh
@@ -12,6 +12,7 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
 struct APUClock;
 struct DMCDMA;
 
@@ -35,6 +36,12 @@ struct APU {
     amplitude() const;
     bool
     interrupt() const;
+    /// @return If interrupt() may turn true with no register written
+    bool
+    may_interrupt() const;
+    /// @return If the DMC is to fetch more samples by DMA
+    bool
+    dmc_fetching() const;
 
     void
     put_dmc_sample(Address i_sample_addr, Byte i_sample);
@@ -88,6 +95,10 @@ struct APU {
     static Register
     addr_to_regsiter(Address i_addr);
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     static double
     mix(Byte i_pulse1, Byte i_pulse2, Byte i_triangle, Byte i_noise,
@@ -1,5 +1,7 @@
 #include "apu_clock.hpp"
 
+#include "state_io.hpp"
+
 namespace nh {
 
 APUClock::APUClock()
@@ -49,4 +51,10 @@ APUClock::odd() const
     return !even();
 }
 
+void
+APUClock::serialize(StateIO &io_state)
+{
+    io_state.field(m_cycle);
+}
+
 } // namespace nh
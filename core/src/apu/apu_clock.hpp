@@ -6,6 +6,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 /// @brief A struct to sync get/put cycle for APU and DMA(OAM/DMC)
 struct APUClock {
   public:
@@ -32,6 +34,10 @@ struct APUClock {
     bool
     odd() const;
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     // This may wrap around back to 0, which is fine, since current
     // implementation doesn't assume infinite range.
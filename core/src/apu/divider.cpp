@@ -1,5 +1,7 @@
 #include "divider.hpp"
 
+#include "state_io.hpp"
+
 namespace nh {
 
 Divider::Divider()
@@ -52,4 +54,11 @@ Divider::tick()
     }
 }
 
+void
+Divider::serialize(StateIO &io_state)
+{
+    io_state.field(m_reload);
+    io_state.field(m_ctr);
+}
+
 } // namespace nh
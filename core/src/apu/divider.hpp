@@ -6,6 +6,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 struct Divider {
   public:
     Divider();
@@ -27,6 +29,10 @@ struct Divider {
     bool
     tick();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Byte2 m_reload;
     Byte2 m_ctr;
@@ -1,6 +1,7 @@
 #include "dmc.hpp"
 
 #include "assert.hpp"
+#include "state_io.hpp"
 
 #include "apu/dmc_dma.hpp"
 
@@ -266,4 +267,27 @@ DMC::restart_playback()
     m_sample_bytes_left = m_sample_length;
 }
 
+void
+DMC::serialize(StateIO &io_state)
+{
+    io_state.field(m_irq_enabled);
+    io_state.field(m_loop);
+    io_state.field(m_sample_addr);
+    io_state.field(m_sample_length);
+
+    m_timer.serialize(io_state);
+    io_state.field(m_shift);
+    io_state.field(m_bits_remaining);
+    io_state.field(m_level);
+    io_state.field(m_silence);
+
+    io_state.field(m_sample_buffer);
+    io_state.field(m_sample_buffer_empty);
+
+    io_state.field(m_sample_curr);
+    io_state.field(m_sample_bytes_left);
+
+    io_state.field(m_irq);
+}
+
 } // namespace nh
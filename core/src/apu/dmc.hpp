@@ -9,6 +9,7 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
 struct DMCDMA;
 
 struct DMC {
@@ -52,6 +53,10 @@ struct DMC {
     bool
     bytes_remained() const;
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     void
     restart_playback();
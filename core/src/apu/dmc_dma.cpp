@@ -1,5 +1,7 @@
 #include "dmc_dma.hpp"
 
+#include "state_io.hpp"
+
 // https://www.nesdev.org/wiki/DMA
 
 /* There are 2 bugs regarding to DMC DMA, we don't emulate them
@@ -157,4 +159,25 @@ DMCDMA::rdy() const
     return m_rdy;
 }
 
+bool
+DMCDMA::idle() const
+{
+    return !m_rdy && !m_working && !m_swap;
+}
+
+void
+DMCDMA::serialize(StateIO &io_state)
+{
+    io_state.field(m_reload);
+    io_state.field(m_load_counter);
+    io_state.field(m_rdy);
+    io_state.field(m_working);
+    io_state.field(m_sample_addr);
+    io_state.field(m_dummy);
+
+    io_state.field(m_swap);
+    io_state.field(m_reload_tmp);
+    io_state.field(m_sample_addr_tmp);
+}
+
 } // namespace nh
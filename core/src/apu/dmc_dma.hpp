@@ -6,6 +6,7 @@
 
 namespace nh {
 
+struct StateIO;
 struct APUClock;
 struct Memory;
 struct APU;
@@ -32,6 +33,13 @@ struct DMCDMA {
 
     bool
     rdy() const;
+    /// @return If neither working nor about to
+    bool
+    idle() const;
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     const APUClock &m_clock;
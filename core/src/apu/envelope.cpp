@@ -1,5 +1,7 @@
 #include "envelope.hpp"
 
+#include "state_io.hpp"
+
 // https://www.nesdev.org/wiki/APU_Envelope
 
 namespace nh {
@@ -88,4 +90,16 @@ Envelope::restart()
     m_start = true;
 }
 
+void
+Envelope::serialize(StateIO &io_state)
+{
+    io_state.field(m_start);
+    m_divider.serialize(io_state);
+    io_state.field(m_decay_level);
+
+    io_state.field(m_loop);
+    io_state.field(m_const);
+    io_state.field(m_const_vol);
+}
+
 } // namespace nh
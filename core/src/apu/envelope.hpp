@@ -7,6 +7,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 struct Envelope {
   public:
     Envelope();
@@ -33,6 +35,10 @@ struct Envelope {
     void
     restart();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     bool m_start; // start flag
     Divider m_divider;
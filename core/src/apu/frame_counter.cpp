@@ -3,6 +3,7 @@
 #include "apu/pulse.hpp"
 #include "apu/triangle.hpp"
 #include "apu/noise.hpp"
+#include "state_io.hpp"
 
 // https://www.nesdev.org/wiki/APU_Frame_Counter
 
@@ -140,6 +141,13 @@ FrameCounter::interrupt() const
     return m_irq;
 }
 
+bool
+FrameCounter::may_interrupt() const
+{
+    // Whatever the mode, which may be about to change.
+    return !m_irq_inhibit;
+}
+
 void
 FrameCounter::reset_timer()
 {
@@ -200,4 +208,18 @@ FrameCounter::tick_envelope_and_linear_counter()
     m_noise.tick_envelope();
 }
 
+void
+FrameCounter::serialize(StateIO &io_state)
+{
+    io_state.field(m_timer);
+    io_state.field(m_irq);
+
+    io_state.field(m_mode);
+    io_state.field(m_irq_inhibit);
+
+    io_state.field(m_first_loop);
+    io_state.field(m_reset_counter);
+    io_state.field(m_mode_tmp);
+}
+
 } // namespace nh
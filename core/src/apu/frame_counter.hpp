@@ -4,6 +4,7 @@
 
 namespace nh {
 
+struct StateIO;
 struct Pulse;
 struct Triangle;
 struct Noise;
@@ -25,6 +26,9 @@ struct FrameCounter {
 
     bool
     interrupt() const;
+    /// @return If interrupt() may turn true with no register written
+    bool
+    may_interrupt() const;
 
     void
     reset_timer();
@@ -36,6 +40,10 @@ struct FrameCounter {
     void
     clear_interrupt();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     void
     tick_length_counter_and_sweep();
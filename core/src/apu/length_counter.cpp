@@ -1,6 +1,7 @@
 #include "length_counter.hpp"
 
 #include "assert.hpp"
+#include "state_io.hpp"
 
 // https://www.nesdev.org/wiki/APU_Length_Counter
 
@@ -111,4 +112,17 @@ LengthCounter::check_load(Byte i_index)
     m_counter = length_table[i_index];
 }
 
+void
+LengthCounter::serialize(StateIO &io_state)
+{
+    io_state.field(m_counter);
+    io_state.field(m_halt);
+    io_state.field(m_enabled);
+
+    io_state.field(m_to_set_halt);
+    io_state.field(m_halt_val);
+    io_state.field(m_to_load);
+    io_state.field(m_load_val);
+}
+
 } // namespace nh
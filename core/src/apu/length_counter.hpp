@@ -8,6 +8,8 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
+
 struct LengthCounter {
   public:
     LengthCounter(NHLogger *i_logger);
@@ -37,6 +39,10 @@ struct LengthCounter {
     void
     flush_load_set();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     void
     check_load(Byte i_index);
@@ -1,5 +1,7 @@
 #include "linear_counter.hpp"
 
+#include "state_io.hpp"
+
 /* Basically like length counter, but with a higher resolution (quarter frame
  * instead of half frame). */
 // https://www.nesdev.org/wiki/APU_Triangle
@@ -59,4 +61,13 @@ LinearCounter::set_reload_val(Byte i_reload)
     m_reload_val = i_reload;
 }
 
+void
+LinearCounter::serialize(StateIO &io_state)
+{
+    io_state.field(m_counter);
+    io_state.field(m_control);
+    io_state.field(m_reload);
+    io_state.field(m_reload_val);
+}
+
 } // namespace nh
@@ -6,6 +6,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 struct LinearCounter {
   public:
     LinearCounter();
@@ -27,6 +29,10 @@ struct LinearCounter {
     void
     set_reload_val(Byte i_reload);
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Byte m_counter;
     bool m_control;
@@ -1,6 +1,7 @@
 #include "noise.hpp"
 
 #include "assert.hpp"
+#include "state_io.hpp"
 
 // https://www.nesdev.org/wiki/APU_Noise
 
@@ -95,4 +96,15 @@ Noise::length_counter()
     return m_length;
 }
 
+void
+Noise::serialize(StateIO &io_state)
+{
+    m_envel.serialize(io_state);
+    m_timer.serialize(io_state);
+    io_state.field(m_shift);
+    m_length.serialize(io_state);
+
+    io_state.field(m_mode);
+}
+
 } // namespace nh
@@ -12,6 +12,8 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
+
 struct Noise {
   public:
     Noise(NHLogger *i_logger);
@@ -44,6 +46,10 @@ struct Noise {
     LengthCounter &
     length_counter();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Envelope m_envel;
     Divider m_timer;
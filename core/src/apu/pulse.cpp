@@ -1,5 +1,7 @@
 #include "pulse.hpp"
 
+#include "state_io.hpp"
+
 // https://www.nesdev.org/wiki/APU_Pulse
 
 namespace nh {
@@ -86,4 +88,14 @@ Pulse::length_counter()
     return m_length;
 }
 
+void
+Pulse::serialize(StateIO &io_state)
+{
+    m_envel.serialize(io_state);
+    m_sweep.serialize(io_state);
+    m_timer.serialize(io_state);
+    m_seq.serialize(io_state);
+    m_length.serialize(io_state);
+}
+
 } // namespace nh
@@ -14,6 +14,8 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
+
 struct Pulse {
   public:
     Pulse(bool i_mode_1, NHLogger *i_logger);
@@ -46,6 +48,10 @@ struct Pulse {
     LengthCounter &
     length_counter();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Envelope m_envel;
     Sweep m_sweep;
@@ -1,6 +1,7 @@
 #include "sequencer.hpp"
 
 #include "assert.hpp"
+#include "state_io.hpp"
 
 // https://www.nesdev.org/wiki/APU_Pulse
 
@@ -54,4 +55,11 @@ Sequencer::reset()
     m_seq_idx = 0;
 }
 
+void
+Sequencer::serialize(StateIO &io_state)
+{
+    io_state.field(m_duty_idx);
+    io_state.field(m_seq_idx);
+}
+
 } // namespace nh
@@ -6,6 +6,8 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
+
 /// @brief Sequencer for pulse channel
 struct Sequencer {
   public:
@@ -25,6 +27,10 @@ struct Sequencer {
     void
     reset();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     int m_duty_idx;
     int m_seq_idx;
@@ -1,5 +1,7 @@
 #include "sweep.hpp"
 
+#include "state_io.hpp"
+
 // https://www.nesdev.org/wiki/APU_Sweep
 
 namespace nh {
@@ -107,4 +109,15 @@ Sweep::target_reload() const
     return target;
 }
 
+void
+Sweep::serialize(StateIO &io_state)
+{
+    m_divider.serialize(io_state);
+    io_state.field(m_reload);
+
+    io_state.field(m_enabled);
+    io_state.field(m_negate);
+    io_state.field(m_shift);
+}
+
 } // namespace nh
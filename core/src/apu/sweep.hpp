@@ -7,6 +7,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 struct Sweep {
   public:
     Sweep(Divider &io_ch_timer, bool i_mode_1);
@@ -32,6 +34,10 @@ struct Sweep {
     void
     reload();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Byte2
     target_reload() const;
@@ -1,5 +1,7 @@
 #include "triangle.hpp"
 
+#include "state_io.hpp"
+
 // https://www.nesdev.org/wiki/APU_Triangle
 
 #define SEQ_SIZE 32
@@ -87,4 +89,15 @@ Triangle::length_counter()
     return m_length;
 }
 
+void
+Triangle::serialize(StateIO &io_state)
+{
+    m_timer.serialize(io_state);
+    m_linear.serialize(io_state);
+    m_length.serialize(io_state);
+
+    io_state.field(m_amp);
+    io_state.field(m_seq_idx);
+}
+
 } // namespace nh
@@ -12,6 +12,8 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
+
 struct Triangle {
   public:
     Triangle(NHLogger *i_logger);
@@ -43,6 +45,10 @@ struct Triangle {
     LengthCounter &
     length_counter();
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     Divider m_timer;
     LinearCounter m_linear;
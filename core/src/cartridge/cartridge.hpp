@@ -4,8 +4,13 @@
 #include "memory/memory.hpp"
 #include "memory/video_memory.hpp"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace nh {
 
+struct StateIO;
+
 struct Cartridge {
   public:
     virtual ~Cartridge() = default;
@@ -13,6 +18,11 @@ struct Cartridge {
     virtual NHErr
     validate() const = 0;
 
+    /// @return Another of the same ROM, sharing it, to be mapped and powered
+    /// up or loaded into.
+    virtual Cartridge *
+    clone(NHLogger *i_logger) const = 0;
+
     virtual void
     power_up() = 0;
     virtual void
@@ -22,6 +32,16 @@ struct Cartridge {
     map_memory(Memory *o_memory, VideoMemory *o_video_memory) = 0;
     virtual void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) = 0;
+
+    /// @return PRG RAM as the CPU sees it, nullptr if none.
+    virtual const Byte *
+    get_prg_ram(std::size_t *o_size) const = 0;
+
+    /// @return Hash of the ROM, to tell states of other games apart.
+    virtual std::uint32_t
+    rom_hash() const = 0;
+    virtual void
+    serialize(StateIO &io_state) = 0;
 };
 
 } // namespace nh
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <memory>
 
 #include "nesish/nesish.h"
 #include "cartridge/ines.hpp"
@@ -195,7 +196,8 @@ CartridgeLoader::pv_load_ines_prg_rom(std::FILE *i_file, INES *io_ines,
 
     constexpr int KiB = 1024;
     std::size_t rom_bytes = io_ines->m_header.prg_rom_size * 16 * KiB;
-    io_ines->m_prg_rom = new Byte[rom_bytes]();
+    io_ines->m_prg_rom.reset(new Byte[rom_bytes](),
+                             std::default_delete<Byte[]>());
     io_ines->m_prg_rom_size = rom_bytes;
 
     constexpr std::size_t EACH_READ = KiB;
@@ -204,7 +206,8 @@ CartridgeLoader::pv_load_ines_prg_rom(std::FILE *i_file, INES *io_ines,
         NB_VC_WARNING_PUSH
         NB_VC_WARNING_DISABLE(6386) // false positive
         auto got =
-            std::fread(io_ines->m_prg_rom + byte_idx, 1, EACH_READ, i_file);
+            std::fread(io_ines->m_prg_rom.get() + byte_idx, 1, EACH_READ,
+                       i_file);
         NB_VC_WARNING_POP
         if (got < EACH_READ)
         {
@@ -218,8 +221,7 @@ CartridgeLoader::pv_load_ines_prg_rom(std::FILE *i_file, INES *io_ines,
 l_cleanup:
     if (NH_FAILED(err))
     {
-        delete[] io_ines->m_prg_rom;
-        io_ines->m_prg_rom = nullptr;
+        io_ines->m_prg_rom.reset();
     }
 
     return err;
@@ -240,7 +242,8 @@ CartridgeLoader::pv_load_ines_chr_rom(std::FILE *i_file, INES *io_ines,
 
     constexpr int KiB = 1024;
     std::size_t rom_bytes = io_ines->m_header.chr_rom_size * 8 * KiB;
-    io_ines->m_chr_rom = new Byte[rom_bytes]();
+    io_ines->m_chr_rom.reset(new Byte[rom_bytes](),
+                             std::default_delete<Byte[]>());
     io_ines->m_chr_rom_size = rom_bytes;
 
     constexpr std::size_t EACH_READ = KiB;
@@ -249,7 +252,8 @@ CartridgeLoader::pv_load_ines_chr_rom(std::FILE *i_file, INES *io_ines,
         NB_VC_WARNING_PUSH
         NB_VC_WARNING_DISABLE(6386) // false positive
         auto got =
-            std::fread(io_ines->m_chr_rom + byte_idx, 1, EACH_READ, i_file);
+            std::fread(io_ines->m_chr_rom.get() + byte_idx, 1, EACH_READ,
+                       i_file);
         NB_VC_WARNING_POP
         if (got < EACH_READ)
         {
@@ -263,8 +267,7 @@ CartridgeLoader::pv_load_ines_chr_rom(std::FILE *i_file, INES *io_ines,
 l_cleanup:
     if (NH_FAILED(err))
     {
-        delete[] io_ines->m_chr_rom;
-        io_ines->m_chr_rom = nullptr;
+        io_ines->m_chr_rom.reset();
     }
 
     return err;
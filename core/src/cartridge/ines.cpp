@@ -9,13 +9,14 @@ namespace nh {
 
 static Mapper *
 pv_get_mapper(Byte i_mapper_number, const INES::RomAccessor *i_accessor);
+static std::uint32_t
+pv_fnv1a(const Byte *i_data, std::size_t i_size, std::uint32_t i_hash);
 
 INES::INES(NHLogger *i_logger)
-    : m_prg_rom(nullptr)
-    , m_prg_rom_size(0)
-    , m_chr_rom(nullptr)
+    : m_prg_rom_size(0)
     , m_chr_rom_size(0)
     , m_use_chr_ram(false)
+    , m_rom_hash(0)
     , m_rom_accessor(this)
     , m_logger(i_logger)
 {
@@ -23,16 +24,6 @@ INES::INES(NHLogger *i_logger)
 
 INES::~INES()
 {
-    if (m_prg_rom)
-    {
-        delete[] m_prg_rom;
-    }
-    m_prg_rom = nullptr;
-    if (m_chr_rom)
-    {
-        delete[] m_chr_rom;
-    }
-    m_chr_rom = nullptr;
 }
 
 NHErr
@@ -49,6 +40,11 @@ INES::resolve()
     }
     m_mapper.reset(mapper);
 
+    // Once here, rather than on every save.
+    m_rom_hash = pv_fnv1a(m_prg_rom.get(), m_prg_rom_size, 2166136261u);
+    m_rom_hash = pv_fnv1a(m_chr_rom.get(), m_chr_rom_size, m_rom_hash);
+    m_rom_hash = pv_fnv1a(&m_mapper_number, 1, m_rom_hash);
+
     return NH_ERR_OK;
 }
 
@@ -93,6 +89,22 @@ INES::validate() const
     return NH_ERR_OK;
 }
 
+Cartridge *
+INES::clone(NHLogger *i_logger) const
+{
+    INES *ines = new INES(i_logger);
+    ines->m_header = m_header;
+    ines->m_mapper_number = m_mapper_number;
+    ines->m_mapper.reset(pv_get_mapper(m_mapper_number, &ines->m_rom_accessor));
+    ines->m_prg_rom = m_prg_rom;
+    ines->m_prg_rom_size = m_prg_rom_size;
+    ines->m_chr_rom = m_chr_rom;
+    ines->m_chr_rom_size = m_chr_rom_size;
+    ines->m_use_chr_ram = m_use_chr_ram;
+    ines->m_rom_hash = m_rom_hash;
+    return ines;
+}
+
 void
 INES::power_up()
 {
@@ -117,6 +129,24 @@ INES::unmap_memory(Memory *o_memory, VideoMemory *o_video_memory)
     m_mapper->unmap_memory(o_memory, o_video_memory);
 }
 
+const Byte *
+INES::get_prg_ram(std::size_t *o_size) const
+{
+    return m_mapper->get_prg_ram(o_size);
+}
+
+std::uint32_t
+INES::rom_hash() const
+{
+    return m_rom_hash;
+}
+
+void
+INES::serialize(StateIO &io_state)
+{
+    m_mapper->serialize(io_state);
+}
+
 Mapper *
 pv_get_mapper(Byte i_mapper_number, const INES::RomAccessor *i_accessor)
 {
@@ -140,6 +170,16 @@ pv_get_mapper(Byte i_mapper_number, const INES::RomAccessor *i_accessor)
     }
 }
 
+std::uint32_t
+pv_fnv1a(const Byte *i_data, std::size_t i_size, std::uint32_t i_hash)
+{
+    for (std::size_t i = 0; i < i_size; ++i)
+    {
+        i_hash = (i_hash ^ i_data[i]) * 16777619u;
+    }
+    return i_hash;
+}
+
 } // namespace nh
 
 namespace nh {
@@ -159,7 +199,7 @@ void
 INES::RomAccessor::get_prg_rom(Byte **o_addr, std::size_t *o_size) const
 {
     if (o_addr)
-        *o_addr = m_ines->m_prg_rom;
+        *o_addr = m_ines->m_prg_rom.get();
     if (o_size)
         *o_size = m_ines->m_prg_rom_size;
 }
@@ -174,7 +214,7 @@ void
 INES::RomAccessor::get_chr_rom(Byte **o_addr, std::size_t *o_size) const
 {
     if (o_addr)
-        *o_addr = m_ines->m_chr_rom;
+        *o_addr = m_ines->m_chr_rom.get();
     if (o_size)
         *o_size = m_ines->m_chr_rom_size;
 }
@@ -21,6 +21,9 @@ struct INES : public Cartridge {
     NHErr
     validate() const override;
 
+    Cartridge *
+    clone(NHLogger *i_logger) const override;
+
     void
     power_up() override;
     void
@@ -31,6 +34,14 @@ struct INES : public Cartridge {
     void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) override;
 
+    const Byte *
+    get_prg_ram(std::size_t *o_size) const override;
+
+    std::uint32_t
+    rom_hash() const override;
+    void
+    serialize(StateIO &io_state) override;
+
   public:
     struct RomAccessor {
       public:
@@ -96,11 +107,13 @@ struct INES : public Cartridge {
     Byte m_mapper_number;
     std::unique_ptr<Mapper> m_mapper;
 
-    Byte *m_prg_rom;
+    // Never written once loaded, so that clones can share them.
+    std::shared_ptr<Byte> m_prg_rom;
     std::size_t m_prg_rom_size;
-    Byte *m_chr_rom;
+    std::shared_ptr<Byte> m_chr_rom;
     std::size_t m_chr_rom_size;
     bool m_use_chr_ram;
+    std::uint32_t m_rom_hash;
 
     RomAccessor m_rom_accessor;
 
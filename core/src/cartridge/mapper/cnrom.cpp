@@ -1,5 +1,7 @@
 #include "cnrom.hpp"
 
+#include "state_io.hpp"
+
 #define NH_128_PRG_RAM_SIZE 16 * 1024
 #define NH_256_PRG_RAM_SIZE 32 * 1024
 
@@ -7,6 +9,7 @@ namespace nh {
 
 CNROM::CNROM(const INES::RomAccessor *i_accessor)
     : Mapper{i_accessor}
+    , m_video_memory(nullptr)
 {
 }
 
@@ -33,6 +36,11 @@ void
 CNROM::power_up()
 {
     m_chr_bnk = 0;
+    if (m_video_memory)
+    {
+        m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                     NH_PATTERN_ADDR_TAIL);
+    }
 }
 
 void
@@ -44,6 +52,8 @@ CNROM::reset()
 void
 CNROM::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
 {
+    m_video_memory = o_video_memory;
+
     // PRG ROM
     {
         Byte *mem_base;
@@ -73,8 +83,9 @@ CNROM::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
         Byte *mem_base;
         std::size_t mem_size;
         m_rom_accessor->get_chr_rom(&mem_base, &mem_size);
-        auto get = [mem_base, mem_size](const MappingEntry *i_entry,
-                                        Address i_addr, Byte &o_val) -> NHErr {
+        auto decode = [mem_base, mem_size](const MappingEntry *i_entry,
+                                           Address i_addr,
+                                           Byte *&o_addr) -> NHErr {
             auto thiz = (CNROM *)i_entry->opaque;
 
             Byte bank = thiz->m_chr_bnk;
@@ -89,7 +100,7 @@ CNROM::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
                 mem_idx = mem_idx % mem_size;
             }
 
-            o_val = *(mem_base + mem_idx);
+            o_addr = mem_base + mem_idx;
             return NH_ERR_OK;
         };
         auto set = [](const MappingEntry *i_entry, Address i_addr,
@@ -98,12 +109,14 @@ CNROM::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
             auto thiz = (CNROM *)i_entry->opaque;
 
             thiz->m_chr_bnk = i_val;
+            thiz->m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                               NH_PATTERN_ADDR_TAIL);
             return NH_ERR_OK;
         };
 
         o_video_memory->set_mapping(VideoMemoryMappingPoint::PATTERN,
                                     {NH_PATTERN_ADDR_HEAD, NH_PATTERN_ADDR_TAIL,
-                                     false, get, set, this});
+                                     false, decode, set, this});
     }
 
     // mirroring
@@ -117,6 +130,20 @@ CNROM::unmap_memory(Memory *o_memory, VideoMemory *o_video_memory)
 
     o_video_memory->unset_mapping(VideoMemoryMappingPoint::PATTERN);
     unset_fixed_vh_mirror(o_video_memory);
+
+    m_video_memory = nullptr;
+}
+
+void
+CNROM::serialize(StateIO &io_state)
+{
+    io_state.field(m_chr_bnk);
+
+    if (io_state.loading() && m_video_memory)
+    {
+        m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                     NH_PATTERN_ADDR_TAIL);
+    }
 }
 
 } // namespace nh
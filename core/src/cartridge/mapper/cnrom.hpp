@@ -23,8 +23,15 @@ struct CNROM : public Mapper {
     void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) override;
 
+    void
+    serialize(StateIO &io_state) override;
+
   private:
     Byte m_chr_bnk;
+
+  private:
+    // To refresh the page table on bank switching, nullptr if not mapped.
+    VideoMemory *m_video_memory;
 };
 
 } // namespace nh
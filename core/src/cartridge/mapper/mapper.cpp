@@ -7,6 +7,13 @@ Mapper::Mapper(const INES::RomAccessor *i_accessor)
 {
 }
 
+const Byte *
+Mapper::get_prg_ram(std::size_t *o_size) const
+{
+    *o_size = 0;
+    return nullptr;
+}
+
 void
 Mapper::set_fixed_vh_mirror(VideoMemory *o_video_memory)
 {
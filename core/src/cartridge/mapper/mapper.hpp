@@ -7,6 +7,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 struct Mapper {
   public:
     Mapper(const INES::RomAccessor *i_accessor);
@@ -25,6 +27,15 @@ struct Mapper {
     virtual void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) = 0;
 
+    /// @return PRG RAM as the CPU sees it, nullptr if none, the default.
+    virtual const Byte *
+    get_prg_ram(std::size_t *o_size) const;
+
+    /// @brief Registers and RAM on the board, refreshing the page tables on
+    /// load.
+    virtual void
+    serialize(StateIO &io_state) = 0;
+
   protected:
     void
     set_fixed_vh_mirror(VideoMemory *o_video_memory);
@@ -1,5 +1,7 @@
 #include "mmc1.hpp"
 
+#include "state_io.hpp"
+
 /* Variants exists in these forms:
  * 1. The use of the bit4(and 3) of the PRG bank register: MMC1/MMC1A/...
  * 2. The use of CHR bank registerS when CHR is used in RAM mode:
@@ -11,9 +13,16 @@ namespace nh {
 MMC1::MMC1(const INES::RomAccessor *i_accessor, Variant i_var)
     : Mapper{i_accessor}
     , m_variant(i_var)
+    , m_shift(0x10)
+    , m_ctrl(0)
+    , m_chr0_bnk(0)
+    , m_chr1_bnk(0)
+    , m_prg_bnk(0)
     , m_prg_ram{}
     , m_chr_ram{}
     , m_no_prg_banking_32K(false)
+    , m_memory(nullptr)
+    , m_video_memory(nullptr)
 {
     std::size_t prg_rom_size;
     m_rom_accessor->get_prg_rom(nullptr, &prg_rom_size);
@@ -95,6 +104,56 @@ MMC1::prg_ram_enabled() const
     }
 }
 
+void
+MMC1::update_pages()
+{
+    // Banks, PRG RAM enable and mirroring all affect decoding.
+    if (m_memory)
+    {
+        m_memory->update_pages(0x6000, 0xFFFF);
+    }
+    if (m_video_memory)
+    {
+        m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                     NH_NT_MIRROR_ADDR_TAIL);
+    }
+}
+
+void
+MMC1::update_register_pages(Address i_addr)
+{
+    if (0x8000 <= i_addr && i_addr <= 0x9FFF)
+    {
+        // Control: PRG and CHR bank modes, and mirroring
+        if (m_memory)
+        {
+            m_memory->update_pages(0x8000, 0xFFFF);
+        }
+        if (m_video_memory)
+        {
+            m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                         NH_NT_MIRROR_ADDR_TAIL);
+        }
+    }
+    else if (0xA000 <= i_addr && i_addr <= 0xDFFF)
+    {
+        // CHR banks
+        if (m_video_memory)
+        {
+            m_video_memory->update_pages(NH_PATTERN_ADDR_HEAD,
+                                         NH_PATTERN_ADDR_TAIL);
+        }
+    }
+    else
+    {
+        // PRG bank and PRG RAM enable
+        if (m_memory)
+        {
+            m_memory->update_pages(0x6000, 0xFFFF);
+        }
+    }
+}
+
 NHErr
 MMC1::validate() const
 {
@@ -135,6 +194,8 @@ MMC1::power_up()
         }
         break;
     }
+
+    update_pages();
 }
 
 void
@@ -146,13 +207,17 @@ MMC1::reset()
 void
 MMC1::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
 {
+    m_memory = o_memory;
+    m_video_memory = o_video_memory;
+
     // PRG ROM
     {
         Byte *mem_base;
         std::size_t mem_size;
         m_rom_accessor->get_prg_rom(&mem_base, &mem_size);
-        auto get = [mem_base, mem_size](const MappingEntry *i_entry,
-                                        Address i_addr, Byte &o_val) -> NHErr {
+        auto decode = [mem_base, mem_size](const MappingEntry *i_entry,
+                                           Address i_addr,
+                                           Byte *&o_addr) -> NHErr {
             auto thiz = (MMC1 *)i_entry->opaque;
 
             Address mem_idx = 0;
@@ -233,7 +298,7 @@ MMC1::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
             {
                 mem_idx = mem_idx % mem_size;
             }
-            o_val = *(mem_base + mem_idx);
+            o_addr = mem_base + mem_idx;
             return NH_ERR_OK;
         };
         auto set = [](const MappingEntry *i_entry, Address i_addr,
@@ -244,6 +309,7 @@ MMC1::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
             {
                 thiz->clear_shift();
                 thiz->reset_prg_bank_mode();
+                thiz->update_register_pages(0x8000);
             }
             else
             {
@@ -271,6 +337,7 @@ MMC1::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
                 {
                     thiz->regsiter_of_addr(i_addr) = thiz->m_shift & 0x1F;
                     thiz->clear_shift();
+                    thiz->update_register_pages(i_addr);
                 }
             }
 
@@ -278,7 +345,7 @@ MMC1::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
         };
         // This is writable to use the serial port.
         o_memory->set_mapping(MemoryMappingPoint::PRG_ROM,
-                              {0x8000, 0xFFFF, false, get, set, this});
+                              {0x8000, 0xFFFF, false, decode, set, this});
     }
 
     // PRG RAM
@@ -414,6 +481,46 @@ MMC1::unmap_memory(Memory *o_memory, VideoMemory *o_video_memory)
 
     o_video_memory->unset_mapping(VideoMemoryMappingPoint::PATTERN);
     o_video_memory->unset_mirror();
+
+    m_memory = nullptr;
+    m_video_memory = nullptr;
+}
+
+const Byte *
+MMC1::get_prg_ram(std::size_t *o_size) const
+{
+    // Only the first bank is mapped, see map_memory().
+    *o_size = 8 * 1024;
+    return m_prg_ram;
+}
+
+void
+MMC1::serialize(StateIO &io_state)
+{
+    io_state.field(m_shift);
+    io_state.field(m_ctrl);
+    io_state.field(m_chr0_bnk);
+    io_state.field(m_chr1_bnk);
+    io_state.field(m_prg_bnk);
+
+    // Only the first bank is mapped, see map_memory().
+    io_state.pages(m_prg_ram, 8 * 1024,
+                   m_memory ? m_memory->get_dirty(0x6000, 32)
+                            : ~std::uint64_t(0));
+    if (m_rom_accessor->use_chr_ram())
+    {
+        // CHR banks move pages around, so a write to any flags all.
+        bool written =
+            !m_video_memory ||
+            m_video_memory->get_dirty(NH_PATTERN_ADDR_HEAD, 32);
+        io_state.pages(m_chr_ram, sizeof(m_chr_ram),
+                       written ? ~std::uint64_t(0) : 0);
+    }
+
+    if (io_state.loading())
+    {
+        update_pages();
+    }
 }
 
 } // namespace nh
@@ -27,6 +27,12 @@ struct MMC1 : public Mapper {
     void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) override;
 
+    const Byte *
+    get_prg_ram(std::size_t *o_size) const override;
+
+    void
+    serialize(StateIO &io_state) override;
+
   private:
     void
     clear_shift();
@@ -36,6 +42,10 @@ struct MMC1 : public Mapper {
     regsiter_of_addr(Address i_addr);
     bool
     prg_ram_enabled() const;
+    void
+    update_pages();
+    void
+    update_register_pages(Address i_addr);
 
   private:
     Variant m_variant;
@@ -53,6 +63,12 @@ struct MMC1 : public Mapper {
 
   private:
     bool m_no_prg_banking_32K;
+
+  private:
+    // To refresh page tables on bank switching and find RAM pages written
+    // since the last state, nullptr if not mapped.
+    Memory *m_memory;
+    VideoMemory *m_video_memory;
 };
 
 } // namespace nh
@@ -1,5 +1,7 @@
 #include "nrom.hpp"
 
+#include "state_io.hpp"
+
 #define NH_128_PRG_RAM_SIZE 16 * 1024
 #define NH_256_PRG_RAM_SIZE 32 * 1024
 
@@ -9,6 +11,8 @@ NROM::NROM(const INES::RomAccessor *i_accessor)
     : Mapper{i_accessor}
     , m_prg_ram{}
     , m_chr_ram{}
+    , m_memory(nullptr)
+    , m_video_memory(nullptr)
 {
 }
 
@@ -39,6 +43,9 @@ NROM::reset()
 void
 NROM::map_memory(Memory *o_memory, VideoMemory *o_video_memory)
 {
+    m_memory = o_memory;
+    m_video_memory = o_video_memory;
+
     // PRG ROM
     {
         Byte *mem_base;
@@ -115,6 +122,31 @@ NROM::unmap_memory(Memory *o_memory, VideoMemory *o_video_memory)
 
     o_video_memory->unset_mapping(VideoMemoryMappingPoint::PATTERN);
     unset_fixed_vh_mirror(o_video_memory);
+
+    m_memory = nullptr;
+    m_video_memory = nullptr;
+}
+
+const Byte *
+NROM::get_prg_ram(std::size_t *o_size) const
+{
+    *o_size = sizeof(m_prg_ram);
+    return m_prg_ram;
+}
+
+void
+NROM::serialize(StateIO &io_state)
+{
+    io_state.pages(m_prg_ram, sizeof(m_prg_ram),
+                   m_memory ? m_memory->get_dirty(0x6000, 32)
+                            : ~std::uint64_t(0));
+    if (m_rom_accessor->use_chr_ram())
+    {
+        io_state.pages(m_chr_ram, sizeof(m_chr_ram),
+                       m_video_memory
+                           ? m_video_memory->get_dirty(NH_PATTERN_ADDR_HEAD, 32)
+                           : ~std::uint64_t(0));
+    }
 }
 
 } // namespace nh
@@ -22,9 +22,20 @@ struct NROM : public Mapper {
     void
     unmap_memory(Memory *o_memory, VideoMemory *o_video_memory) override;
 
+    const Byte *
+    get_prg_ram(std::size_t *o_size) const override;
+
+    void
+    serialize(StateIO &io_state) override;
+
   private:
     Byte m_prg_ram[8 * 1024]; // 8KB max
     Byte m_chr_ram[8 * 1024];
+
+  private:
+    // To find RAM pages written since the last state, nullptr if not mapped.
+    Memory *m_memory;
+    VideoMemory *m_video_memory;
 };
 
 } // namespace nh
@@ -5,10 +5,27 @@
 #include "spec.hpp"
 #include "log.hpp"
 #include "assert.hpp"
+#include "state_io.hpp"
 
 namespace nh {
 
 constexpr int Console::CTRL_SIZE;
+constexpr int Console::SAMPLE_BUF_SIZE;
+
+// "NHST" in little-endian
+static constexpr std::uint32_t STATE_MAGIC = 0x5453484E;
+// Bump on any change to what serialize() covers or in which order.
+static constexpr std::uint32_t STATE_VERSION = 2;
+
+struct StateHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t size; // including the header
+    std::uint32_t rom_hash;
+};
+
+static void
+pv_serialize_header(StateIO &io_state, StateHeader &io_header);
 
 Console::Console(NHLogger *i_logger)
     : m_cpu(&m_memory, &m_ppu, &m_apu, i_logger)
@@ -21,9 +38,21 @@ Console::Console(NHLogger *i_logger)
     , m_cart(nullptr)
     , m_ctrl_regs{}
     , m_ctrls{}
+    , m_pads_on{}
+    , m_pad_buttons{}
+    , m_pad_shifts{}
+    , m_state_size(0)
+    , m_rewind_frame(0)
+    , m_run_ahead(0)
+    , m_running_ahead(false)
+    , m_idle_skip(false)
+    , m_oam_dma_started(false)
     , m_logger(i_logger)
     , m_debug_flags(NHD_DBG_OFF)
-    , m_time(0)
+    , m_time_rem(0)
+    , m_audio_sink(nullptr)
+    , m_samples{}
+    , m_sample_count(0)
 {
     hard_wire();
 }
@@ -116,6 +145,7 @@ Console::hard_wire()
             {
                 // OAM DMA high address (this port is located on the CPU)
                 thiz->m_oam_dma.initiate(i_val);
+                thiz->m_oam_dma_started = true;
                 return NH_ERR_OK;
             }
             else if (NH_CTRL1_REG_ADDR == i_addr)
@@ -162,7 +192,19 @@ Console::read_ctrl_reg(CtrlReg i_reg)
                 auto ctrl = m_ctrls[index];
                 // @TODO: Other control bits
                 bool primaryBit{0};
-                if (!ctrl)
+                if (m_pads_on[index])
+                {
+                    // Loaded all the time while strobing.
+                    if (m_ctrl_regs[CTRL_REG_4016] & 0x01)
+                    {
+                        m_pad_shifts[index] = Byte2(0xFF00) |
+                                              m_pad_buttons[index];
+                    }
+                    primaryBit = m_pad_shifts[index] & 0x01;
+                    m_pad_shifts[index] =
+                        Byte2((m_pad_shifts[index] >> 1) | 0x8000);
+                }
+                else if (!ctrl)
                 {
                     // Report 0 for unconnected controller.
                     // https://www.nesdev.org/wiki/Standard_controller#Output_($4016/$4017_read)
@@ -188,6 +230,7 @@ Console::read_ctrl_reg(CtrlReg i_reg)
 void
 Console::write_ctrl_reg(CtrlReg i_reg, Byte i_val)
 {
+    bool strobeWas = m_ctrl_regs[i_reg] & 0x01;
     m_ctrl_regs[i_reg] = i_val;
 
     switch (i_reg)
@@ -197,6 +240,16 @@ Console::write_ctrl_reg(CtrlReg i_reg, Byte i_val)
             bool strobeOn = i_val & 0x01;
             for (NHCtrlPort i = 0; i < CTRL_SIZE; ++i)
             {
+                if (m_pads_on[i])
+                {
+                    // Latched as strobing ends.
+                    if (strobeWas || strobeOn)
+                    {
+                        m_pad_shifts[i] = Byte2(0xFF00) | m_pad_buttons[i];
+                    }
+                    continue;
+                }
+
                 auto ctrl = m_ctrls[i];
                 if (!ctrl)
                 {
@@ -217,57 +270,127 @@ void
 Console::plug_controller(NHCtrlPort i_slot, NHController *i_controller)
 {
     m_ctrls[i_slot] = i_controller;
+    m_pads_on[i_slot] = false;
 }
 
 void
 Console::unplug_controller(NHCtrlPort i_slot)
 {
     m_ctrls[i_slot] = nullptr;
+    m_pads_on[i_slot] = false;
+}
+
+void
+Console::set_buttons(NHCtrlPort i_slot, Byte i_buttons)
+{
+    m_ctrls[i_slot] = nullptr;
+    m_pads_on[i_slot] = true;
+    m_pad_buttons[i_slot] = i_buttons;
 }
 
 NHErr
-Console::insert_cartridge(const std::string &i_rom_path)
+Console::load_rom(const std::string &i_rom_path, NHLogger *i_logger,
+                  Cartridge **o_rom)
 {
     if (!nb::file_exists(i_rom_path))
     {
-        NH_LOG_ERROR(m_logger, "Invalid cartridge path: \"{}\"", i_rom_path);
+        NH_LOG_ERROR(i_logger, "Invalid cartridge path: \"{}\"", i_rom_path);
         return NH_ERR_INVALID_ARGUMENT;
     }
 
-    NHErr err = NH_ERR_OK;
-
-    // 1. load cartridge
-    NH_LOG_INFO(m_logger, "Loading cartridge...");
+    NH_LOG_INFO(i_logger, "Loading cartridge...");
     Cartridge *cart = nullptr;
-    err = CartridgeLoader::load_cartridge(i_rom_path, CartridgeType::INES,
-                                          &cart, m_logger);
+    NHErr err = CartridgeLoader::load_cartridge(
+        i_rom_path, CartridgeType::INES, &cart, i_logger);
     if (NH_FAILED(err))
     {
-        goto l_end;
+        return err;
     }
     err = cart->validate();
     if (NH_FAILED(err))
     {
-        goto l_end;
+        delete cart;
+        return err;
     }
 
-    // 2. map to address space
-    NH_LOG_INFO(m_logger, "Mapping cartridge...");
-    cart->map_memory(&m_memory, &m_video_memory);
+    *o_rom = cart;
+    return NH_ERR_OK;
+}
 
-l_end:
+NHErr
+Console::insert_cartridge(const std::string &i_rom_path)
+{
+    Cartridge *cart = nullptr;
+    NHErr err = load_rom(i_rom_path, m_logger, &cart);
     if (NH_FAILED(err))
     {
-        delete cart;
-        cart = nullptr;
+        return err;
     }
-    else
+
+    insert(cart);
+    return NH_ERR_OK;
+}
+
+void
+Console::insert_rom(const Cartridge &i_rom)
+{
+    insert(i_rom.clone(m_logger));
+}
+
+void
+Console::insert(Cartridge *i_cart)
+{
+    // Before mapping, or unmapping the old one would undo it.
+    release_cartridge();
+
+    NH_LOG_INFO(m_logger, "Mapping cartridge...");
+    i_cart->map_memory(&m_memory, &m_video_memory);
+    m_cart = i_cart;
+}
+
+NHErr
+Console::clone(Console **o_console)
+{
+    if (!o_console)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    Console *console = new Console(m_logger);
+    for (NHCtrlPort i = 0; i < CTRL_SIZE; ++i)
+    {
+        console->m_ctrls[i] = m_ctrls[i];
+    }
+    for (NHCtrlPort i = 0; i < CTRL_SIZE; ++i)
+    {
+        console->m_pads_on[i] = m_pads_on[i];
+        console->m_pad_buttons[i] = m_pad_buttons[i];
+    }
+    console->m_debug_flags = m_debug_flags;
+    console->m_idle_skip = m_idle_skip;
+    console->m_time_rem = m_time_rem;
+
+    if (m_cart)
     {
-        release_cartridge();
-        m_cart = cart;
+        console->insert_rom(*m_cart);
+
+        // Nothing is left out of states but the frames.
+        std::size_t size = state_size();
+        std::vector<Byte> state(size);
+        NHErr err = save_state(state.data(), size);
+        if (!NH_FAILED(err))
+        {
+            err = console->load_state(state.data(), size);
+        }
+        if (NH_FAILED(err))
+        {
+            delete console;
+            return err;
+        }
     }
 
-    return err;
+    *o_console = console;
+    return NH_ERR_OK;
 }
 
 void
@@ -281,9 +404,12 @@ Console::release_cartridge()
 {
     if (m_cart)
     {
+        m_ppu.sync();
         m_cart->unmap_memory(&m_memory, &m_video_memory);
         delete m_cart;
         m_cart = nullptr;
+        m_state_size = 0;
+        m_rewind.clear();
     }
 }
 
@@ -311,11 +437,46 @@ Console::power_up()
     m_dmc_dma.power_up();
     m_apu_clock.power_up();
 
-    m_time = 0;
+    // Not all of it goes through the buses.
+    m_memory.set_dirty();
+    m_video_memory.set_dirty();
+
+    m_time_rem = 0;
 
     reset_trivial();
 }
 
+NHErr
+Console::power_up_as_new()
+{
+    if (!m_cart)
+    {
+        NH_LOG_ERROR(m_logger, "Power up without cartridge inserted");
+        return NH_ERR_UNINITIALIZED;
+    }
+
+    // Take over the state of one.
+    Console *console = new Console(m_logger);
+    console->insert_rom(*m_cart);
+    console->power_up();
+    std::vector<Byte> state(console->state_size());
+    NHErr err = console->save_state(state.data(), state.size());
+    delete console;
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+
+    err = load_state(state.data(), state.size());
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    m_time_rem = 0;
+    reset_trivial();
+    return NH_ERR_OK;
+}
+
 void
 Console::reset()
 {
@@ -352,20 +513,33 @@ Console::reset_trivial()
         {
             m_ctrls[i]->reset(m_ctrls[i]->user);
         }
+        // Nothing latched, reports as after 8 reads.
+        m_pad_shifts[i] = 0xFFFF;
     }
 }
 
 Cycle
 Console::advance(double i_delta)
 {
-    double next = m_time + i_delta;
-    Cycle cpu_ticks = Cycle(next * NH_CPU_HZ) - Cycle(m_time * NH_CPU_HZ);
-    m_time = next;
-    return cpu_ticks;
+    if (i_delta <= 0)
+    {
+        return 0;
+    }
+
+    // Integer accounting, so that rounding errors don't build up as the
+    // elapsed time grows, which they did with a floating point timestamp.
+    constexpr std::uint64_t NANO = 1000000000;
+    std::uint64_t delta_ns = std::uint64_t(i_delta * NANO + 0.5);
+    // Split up to avoid overflow for large delta.
+    std::uint64_t cpu_ticks = (delta_ns / NANO) * NH_CPU_HZ;
+    std::uint64_t nano_ticks = m_time_rem + (delta_ns % NANO) * NH_CPU_HZ;
+    cpu_ticks += nano_ticks / NANO;
+    m_time_rem = nano_ticks % NANO;
+    return Cycle(cpu_ticks);
 }
 
 bool
-Console::tick(bool *o_cpu_instr)
+Console::tick(bool *o_cpu_instr, Cycle i_idle_budget)
 {
     // @NOTE: Tick DMA before CPU, since CPU may be halted by them
     // @NOTE: the RDY disable implementation depends on this order.
@@ -389,11 +563,19 @@ Console::tick(bool *o_cpu_instr)
      * operation). This suppression behavior is due to the $2002 read pulling
      * the NMI line back up too quickly after it drops (NMI is active low) for
      * the CPU to see it. (CPU inputs like NMI are sampled each clock.) */
+    Cycle frame_count = m_ppu.frame_count();
     m_ppu.tick();
 
     bool read_2002 = false;
-    bool instr_done = m_cpu.pre_tick(m_dmc_dma.rdy() || m_oam_dma.rdy(),
-                                     dmc_dma_get || oam_dma_op, read_2002);
+    // Not while a DMA might halt the CPU, nor as a frame ends, when runs stop
+    // after this tick. The CPU sees to the rest.
+    Cycle idle_budget = m_oam_dma.idle() && m_dmc_dma.idle() &&
+                                m_ppu.frame_count() == frame_count
+                            ? i_idle_budget
+                            : 0;
+    bool instr_done =
+        m_cpu.pre_tick(m_dmc_dma.rdy() || m_oam_dma.rdy(),
+                       dmc_dma_get || oam_dma_op, idle_budget, read_2002);
     if (o_cpu_instr)
     {
         *o_cpu_instr = instr_done;
@@ -416,16 +598,538 @@ Console::tick(bool *o_cpu_instr)
     // Tick the clock last
     m_apu_clock.tick();
 
+    if (m_rewind.enabled() && !m_running_ahead &&
+        m_ppu.frame_count() != m_rewind_frame)
+    {
+        m_rewind_frame = m_ppu.frame_count();
+        if (m_rewind.count_frame())
+        {
+            take_snapshot();
+        }
+    }
+
     // APU generates a sample every CPU cycle.
     return true;
 }
 
+Cycle
+Console::step(bool *o_cpu_instr, Cycle i_budget, bool i_idle_skip)
+{
+    // Checked once, at what would be the first get cycle.
+    if (m_oam_dma_started && m_cpu.dma_halt() && m_apu_clock.get())
+    {
+        m_oam_dma_started = false;
+
+        // No DMC DMA to get in the way, nor anything done with OAM or at PPU
+        // events meanwhile. Runs don't end halfway either.
+        if (i_budget >= Cycle(OAMDMA::BURST_TICKS) &&
+            m_oam_dma.burstable(true) && m_dmc_dma.idle() &&
+            !m_apu.dmc_fetching() && m_ppu.oam_idle(3 * OAMDMA::BURST_TICKS))
+        {
+            burst_oam_dma();
+            if (o_cpu_instr)
+            {
+                *o_cpu_instr = false;
+            }
+            return OAMDMA::BURST_TICKS;
+        }
+    }
+
+    tick(o_cpu_instr, i_idle_skip ? i_budget : 0);
+    push_sample();
+    return 1;
+}
+
+void
+Console::burst_oam_dma()
+{
+    m_oam_dma.burst();
+    // Nothing it does is seen before the next event.
+    m_ppu.defer_ticks(3 * OAMDMA::BURST_TICKS);
+
+    // The rest as in tick(), with the CPU halted and its reads masked, and DMC
+    // DMA idle.
+    for (int i = 0; i < OAMDMA::BURST_TICKS; ++i)
+    {
+        bool read_2002 = false;
+        (void)m_cpu.pre_tick(true, true, 0, read_2002);
+        m_cpu.post_tick();
+
+        m_apu.tick();
+        m_apu_clock.tick();
+        push_sample();
+    }
+}
+
+void
+Console::run_cycles(Cycle i_cycles)
+{
+    Cycle frame_count = m_ppu.frame_count();
+    // The frames shown come from running ahead.
+    m_ppu.set_output(!m_run_ahead, true);
+    for (Cycle i = 0; i < i_cycles;)
+    {
+        i += step(nullptr, i_cycles - i, m_idle_skip);
+    }
+    flush_samples();
+    m_ppu.set_output(true, true);
+
+    if (m_run_ahead && m_ppu.frame_count() != frame_count)
+    {
+        run_ahead();
+    }
+}
+
+Cycle
+Console::run_frame()
+{
+    m_ppu.set_output(!m_run_ahead, true);
+    Cycle cycles = step_frame();
+    m_ppu.set_output(true, true);
+
+    if (m_run_ahead)
+    {
+        run_ahead();
+    }
+    return cycles;
+}
+
+Cycle
+Console::rerun_frame()
+{
+    // Kept from audio and rewind like frames run ahead.
+    m_running_ahead = true;
+    m_ppu.set_output(false, false);
+    Cycle cycles = step_frame();
+    m_ppu.set_output(true, true);
+    m_running_ahead = false;
+    return cycles;
+}
+
+Cycle
+Console::step_frame()
+{
+    Cycle cycles = 0;
+    Cycle frame_count = m_ppu.frame_count();
+    // Skipping stops short of PPU events, the frame ending among them.
+    do
+    {
+        cycles += step(nullptr, ~Cycle(0), m_idle_skip);
+    } while (m_ppu.frame_count() == frame_count);
+    flush_samples();
+    return cycles;
+}
+
+void
+Console::run_ahead()
+{
+    if (!m_cart)
+    {
+        return;
+    }
+
+    std::size_t size = state_size();
+    m_run_ahead_state.resize(size);
+    if (NH_FAILED(save_state(m_run_ahead_state.data(), size)))
+    {
+        return;
+    }
+
+    // Nothing of these frames is heard or captured, and only the last is
+    // shown.
+    m_running_ahead = true;
+    for (int i = 1; i <= m_run_ahead; ++i)
+    {
+        m_ppu.set_output(i == m_run_ahead, false);
+        step_frame();
+    }
+    m_ppu.set_output(true, true);
+    m_running_ahead = false;
+
+    if (NH_FAILED(load_state(m_run_ahead_state.data(), size)))
+    {
+        NH_LOG_ERROR(m_logger, "Failed to take back frames run ahead");
+    }
+}
+
+NHEvent
+Console::run_until(NHEvent i_events, Cycle i_max_cycles, Cycle *o_cycles)
+{
+    NHEvent events = NH_EVENT_NONE;
+    Cycle cycles = 0;
+    Cycle frame_count = m_ppu.frame_count();
+    // Instructions skipped could be stopped at.
+    bool idle_skip = m_idle_skip && !(i_events & NH_EVENT_CPU_INSTR);
+    while (cycles < i_max_cycles)
+    {
+        bool instr_done = false;
+        cycles += step(&instr_done, i_max_cycles - cycles, idle_skip);
+
+        if (instr_done)
+        {
+            events |= NH_EVENT_CPU_INSTR;
+        }
+        if (m_ppu.frame_count() != frame_count)
+        {
+            events |= NH_EVENT_FRAME;
+        }
+        events &= i_events;
+        if (events)
+        {
+            break;
+        }
+    }
+    flush_samples();
+
+    if (o_cycles)
+    {
+        *o_cycles = cycles;
+    }
+    return events;
+}
+
+bool
+Console::halted() const
+{
+    return m_cpu.instr_halt();
+}
+
+std::uint32_t
+Console::rom_hash() const
+{
+    return m_cart ? m_cart->rom_hash() : 0;
+}
+
+std::size_t
+Console::state_size()
+{
+    if (!m_cart)
+    {
+        return 0;
+    }
+
+    if (!m_state_size)
+    {
+        StateIO io_state;
+        StateHeader header{};
+        pv_serialize_header(io_state, header);
+        serialize(io_state);
+        m_state_size = io_state.size();
+    }
+    return m_state_size;
+}
+
+NHErr
+Console::save_state(void *o_buf, std::size_t i_size)
+{
+    if (!m_cart)
+    {
+        NH_LOG_ERROR(m_logger, "Save state without cartridge inserted");
+        return NH_ERR_UNINITIALIZED;
+    }
+    std::size_t size = state_size();
+    if (!o_buf || i_size < size)
+    {
+        NH_LOG_ERROR(m_logger, "State buffer too small: {} < {}", i_size,
+                     size);
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    StateIO io_state(o_buf, i_size);
+    StateHeader header{STATE_MAGIC, STATE_VERSION, std::uint32_t(size),
+                       m_cart->rom_hash()};
+    pv_serialize_header(io_state, header);
+    serialize(io_state);
+    return io_state.ok() ? NH_ERR_OK : NH_ERR_PROGRAMMING;
+}
+
+NHErr
+Console::load_state(const void *i_buf, std::size_t i_size)
+{
+    if (!m_cart)
+    {
+        NH_LOG_ERROR(m_logger, "Load state without cartridge inserted");
+        return NH_ERR_UNINITIALIZED;
+    }
+
+    // Check everything before touching any component, so that a bad state
+    // doesn't leave the console half loaded.
+    if (!i_buf)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    StateIO io_state(i_buf, i_size);
+    StateHeader header{};
+    pv_serialize_header(io_state, header);
+    if (!io_state.ok() || header.magic != STATE_MAGIC ||
+        header.version != STATE_VERSION)
+    {
+        NH_LOG_ERROR(m_logger, "Not a state of version {}", STATE_VERSION);
+        return NH_ERR_CORRUPTED;
+    }
+    if (header.rom_hash != m_cart->rom_hash())
+    {
+        NH_LOG_ERROR(m_logger, "State of another cartridge");
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    if (header.size != state_size() || i_size < header.size)
+    {
+        NH_LOG_ERROR(m_logger, "State truncated or of wrong size: {}",
+                     i_size);
+        return NH_ERR_CORRUPTED;
+    }
+
+    serialize(io_state);
+    if (!io_state.ok())
+    {
+        return NH_ERR_PROGRAMMING;
+    }
+
+    // Pages written since the last snapshot tell nothing now.
+    m_memory.set_dirty();
+    m_video_memory.set_dirty();
+    m_rewind_frame = m_ppu.frame_count();
+    return NH_ERR_OK;
+}
+
+std::uint64_t
+Console::state_hash()
+{
+    if (!m_cart)
+    {
+        return 0;
+    }
+
+    StateHash hash(m_cart->rom_hash());
+    StateIO io_state(hash);
+    serialize(io_state);
+    return hash.digest();
+}
+
+NHErr
+Console::set_rewind(int i_interval, std::size_t i_capacity)
+{
+    if (i_interval < 0)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    m_rewind.configure(i_interval, i_capacity);
+    m_rewind_frame = m_ppu.frame_count();
+    return NH_ERR_OK;
+}
+
+NHErr
+Console::rewind(int i_frames, int *o_frames)
+{
+    if (!m_cart)
+    {
+        NH_LOG_ERROR(m_logger, "Rewind without cartridge inserted");
+        return NH_ERR_UNINITIALIZED;
+    }
+    if (i_frames < 0)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    std::uint64_t frames = m_rewind.step_back(std::uint64_t(i_frames));
+    if (!m_rewind.has_snapshot())
+    {
+        return NH_ERR_UNAVAILABLE;
+    }
+
+    std::size_t size = state_size();
+    NHErr err = load_state(m_rewind.snapshot(size), size);
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    // It's the snapshot now.
+    m_memory.clear_dirty();
+    m_video_memory.clear_dirty();
+
+    if (o_frames)
+    {
+        *o_frames = int(frames);
+    }
+    return NH_ERR_OK;
+}
+
+NHErr
+Console::set_run_ahead(int i_frames)
+{
+    if (i_frames < 0)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    m_run_ahead = i_frames;
+    if (!m_run_ahead)
+    {
+        std::vector<Byte>().swap(m_run_ahead_state);
+    }
+    return NH_ERR_OK;
+}
+
+void
+Console::set_idle_skip(bool i_on)
+{
+    m_idle_skip = i_on;
+}
+
+void
+Console::take_snapshot()
+{
+    if (!m_cart)
+    {
+        return;
+    }
+
+    std::size_t size = state_size();
+    Byte *snapshot = m_rewind.snapshot(size);
+    if (!m_rewind.has_snapshot())
+    {
+        if (NH_FAILED(save_state(snapshot, size)))
+        {
+            return;
+        }
+        m_rewind.commit(0);
+    }
+    else
+    {
+        // Save over the last one, so that clean pages are skipped and the
+        // delta back to it comes out on the way.
+        StateDelta delta(m_rewind.delta_buf(), StateDelta::bound(size));
+        StateIO io_state(snapshot, size, delta);
+        StateHeader header{STATE_MAGIC, STATE_VERSION, std::uint32_t(size),
+                           m_cart->rom_hash()};
+        pv_serialize_header(io_state, header);
+        serialize(io_state);
+        std::size_t delta_size = delta.finish();
+        if (!io_state.ok() || !delta.ok())
+        {
+            m_rewind.clear();
+            return;
+        }
+        m_rewind.commit(delta_size);
+    }
+
+    m_memory.clear_dirty();
+    m_video_memory.clear_dirty();
+}
+
+void
+Console::serialize(StateIO &io_state)
+{
+    m_cpu.serialize(io_state);
+    m_memory.serialize(io_state);
+    m_ppu.serialize(io_state);
+    m_oam_dma.serialize(io_state);
+    m_video_memory.serialize(io_state);
+    m_apu_clock.serialize(io_state);
+    m_apu.serialize(io_state);
+    m_dmc_dma.serialize(io_state);
+    m_cart->serialize(io_state);
+
+    io_state.bytes(m_ctrl_regs, sizeof(m_ctrl_regs));
+    for (NHCtrlPort i = 0; i < CTRL_SIZE; ++i)
+    {
+        io_state.field(m_pad_shifts[i]);
+    }
+}
+
+void
+Console::plug_audio_sink(NHAudioSink *i_sink)
+{
+    flush_samples();
+    m_audio_sink = i_sink;
+}
+
+void
+Console::unplug_audio_sink()
+{
+    flush_samples();
+    m_audio_sink = nullptr;
+}
+
+void
+Console::push_sample()
+{
+    if (!m_audio_sink || m_running_ahead)
+    {
+        return;
+    }
+
+    // APU generates a sample every CPU cycle.
+    m_samples[m_sample_count++] = m_apu.amplitude();
+    if (m_sample_count >= SAMPLE_BUF_SIZE)
+    {
+        flush_samples();
+    }
+}
+
+void
+Console::flush_samples()
+{
+    if (m_audio_sink && m_sample_count)
+    {
+        m_audio_sink->write(m_samples, std::size_t(m_sample_count),
+                            m_audio_sink->user);
+    }
+    m_sample_count = 0;
+}
+
 const FrameBuffer &
 Console::get_frame() const
 {
     return m_ppu.get_frame();
 }
 
+NHErr
+Console::set_frame_target(void *o_target, int i_pitch, NHPixelFormat i_format)
+{
+    if (o_target)
+    {
+        int row_size = FrameBuffer::WIDTH * FrameBuffer::pixel_size(i_format);
+        if (!row_size || (i_pitch < row_size && -i_pitch < row_size))
+        {
+            return NH_ERR_INVALID_ARGUMENT;
+        }
+    }
+
+    m_ppu.set_frame_target(o_target, i_pitch, i_format);
+    return NH_ERR_OK;
+}
+
+NHErr
+Console::set_observation(Byte *o_target, int i_width, int i_height,
+                         int i_pitch)
+{
+    if (!m_ppu.set_observation(o_target, i_width, i_height, i_pitch))
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return NH_ERR_OK;
+}
+
+const Byte *
+Console::get_ram() const
+{
+    static_assert(NH_RAM_SIZE == NH_INTERNAL_RAM_SIZE, "Public size differs");
+    return m_memory.get_ram();
+}
+
+const Byte *
+Console::get_prg_ram(std::size_t *o_size) const
+{
+    if (!m_cart)
+    {
+        *o_size = 0;
+        return nullptr;
+    }
+    return m_cart->get_prg_ram(o_size);
+}
+
 int
 Console::get_sample_rate() const
 {
@@ -481,4 +1185,13 @@ Console::test_get_cpu()
     return &m_cpu;
 }
 
+void
+pv_serialize_header(StateIO &io_state, StateHeader &io_header)
+{
+    io_state.field(io_header.magic);
+    io_state.field(io_header.version);
+    io_state.field(io_header.size);
+    io_state.field(io_header.rom_hash);
+}
+
 } // namespace nh
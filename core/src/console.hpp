@@ -19,12 +19,18 @@
 
 #include "spec.hpp"
 #include "types.hpp"
+#include "rewind.hpp"
 #include "debug/debug_flags.hpp"
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace nh {
 
+struct StateIO;
+
 struct Console {
   public:
     Console(NHLogger *i_logger);
@@ -35,14 +41,38 @@ struct Console {
     plug_controller(NHCtrlPort i_slot, NHController *i_controller);
     void
     unplug_controller(NHCtrlPort i_slot);
+    /// @brief Plug a standard controller emulated here, with "i_buttons"
+    /// held, bit i for NHKey i, in place of any other.
+    void
+    set_buttons(NHCtrlPort i_slot, Byte i_buttons);
+
+    /// @param o_rom A cartridge never inserted but cloned for insert_rom()
+    static NHErr
+    load_rom(const std::string &i_rom_path, NHLogger *i_logger,
+             Cartridge **o_rom);
 
     NHErr
     insert_cartridge(const std::string &i_rom_path);
+    /// @brief Insert a clone of "i_rom", sharing the ROM with it.
+    void
+    insert_rom(const Cartridge &i_rom);
     void
     remove_cartridge();
 
+    /// @brief Another console at the same point, sharing the ROM. Controllers
+    /// and debug flags are carried over, but not the audio sink, frame target,
+    /// rewind or run-ahead. Frames are output rather than state, the first
+    /// shown is the next completed.
+    NHErr
+    clone(Console **o_console);
+
     void
     power_up();
+    /// @brief Power up into the same state as a new console, rather than
+    /// leaving what power up doesn't touch, e.g. OAM and cartridge RAM, as it
+    /// was. Allocates.
+    NHErr
+    power_up_as_new();
     void
     reset();
 
@@ -50,12 +80,83 @@ struct Console {
     advance(double i_delta);
     /// @brief Advance 1 tick
     /// @param o_cpu_instr If a CPU instruction has completed
+    /// @param i_idle_budget Ticks sure to follow, this one included, to skip
+    /// idle loop iterations within, see set_idle_skip().
     /// @return If a new audio sample is available
     bool
-    tick(bool *o_cpu_instr = nullptr);
+    tick(bool *o_cpu_instr = nullptr, Cycle i_idle_budget = 0);
+
+    void
+    run_cycles(Cycle i_cycles);
+    /// @return CPU cycles run
+    Cycle
+    run_frame();
+    /// @brief Run a frame over again after loading an earlier state, e.g. to
+    /// correct input predicted. Nothing of it is shown, heard or captured.
+    /// @return CPU cycles run
+    Cycle
+    rerun_frame();
+    /// @param o_cycles CPU cycles run, optional
+    /// @return Events occurred among "i_events", NH_EVENT_NONE if budget ran
+    /// out
+    NHEvent
+    run_until(NHEvent i_events, Cycle i_max_cycles, Cycle *o_cycles = nullptr);
+    /// @return If the CPU is stuck on an instruction that halts it, until
+    /// reset.
+    bool
+    halted() const;
+
+    /// @return 0 without cartridge
+    std::uint32_t
+    rom_hash() const;
+
+    /// @return 0 without cartridge
+    std::size_t
+    state_size();
+    NHErr
+    save_state(void *o_buf, std::size_t i_size);
+    NHErr
+    load_state(const void *i_buf, std::size_t i_size);
+    /// @return Hash of what save_state() saves, 0 without cartridge
+    std::uint64_t
+    state_hash();
+
+    NHErr
+    set_rewind(int i_interval, std::size_t i_capacity);
+    /// @param o_frames Frames stepped back, optional
+    NHErr
+    rewind(int i_frames, int *o_frames);
+
+    /// @brief Frames to run ahead and take back after run_cycles() or
+    /// run_frame() completes a frame, showing the last. 0 to turn off.
+    NHErr
+    set_run_ahead(int i_frames);
+
+    /// @brief Have the CPU skip iterations of loops that only wait, e.g. for
+    /// VBL or an NMI to change RAM, as long as nothing could tell, in
+    /// run_cycles(), run_frame() and run_until() without NH_EVENT_CPU_INSTR.
+    void
+    set_idle_skip(bool i_on);
+
+    void
+    plug_audio_sink(NHAudioSink *i_sink);
+    void
+    unplug_audio_sink();
 
     const FrameBuffer &
     get_frame() const;
+    NHErr
+    set_frame_target(void *o_target, int i_pitch, NHPixelFormat i_format);
+    /// @brief See PPU::set_observation().
+    NHErr
+    set_observation(Byte *o_target, int i_width, int i_height, int i_pitch);
+
+    /// @return The internal RAM as is, NH_INTERNAL_RAM_SIZE bytes
+    const Byte *
+    get_ram() const;
+    /// @return PRG RAM of the cartridge, nullptr if none
+    const Byte *
+    get_prg_ram(std::size_t *o_size) const;
 
     int
     get_sample_rate() const;
@@ -108,9 +209,39 @@ struct Console {
     void
     reset_trivial();
 
+    void
+    push_sample();
+    void
+    flush_samples();
+
+    /// @brief tick() and push the sample, or run an OAM DMA transfer as a
+    /// whole if one is starting that nothing else could step in.
+    /// @param i_budget Ticks sure to follow, this one included
+    /// @param i_idle_skip Whether to skip idle loop iterations within
+    /// @return Ticks run
+    Cycle
+    step(bool *o_cpu_instr, Cycle i_budget, bool i_idle_skip);
+    /// @brief The ticks of the OAM DMA transfer, copied at once.
+    void
+    burst_oam_dma();
+
+    /// @brief Takes "i_cart" over.
+    void
+    insert(Cartridge *i_cart);
     void
     release_cartridge();
 
+    void
+    serialize(StateIO &io_state);
+
+    void
+    take_snapshot();
+
+    Cycle
+    step_frame();
+    void
+    run_ahead();
+
   private:
     CPU m_cpu;
     Memory m_memory;
@@ -127,6 +258,26 @@ struct Console {
     static constexpr int CTRL_SIZE = 2;
     static_assert(CTRL_SIZE == CTRL_REG_SIZE, "?");
     NHController *m_ctrls[CTRL_SIZE]; // References
+    // Standard controllers of set_buttons(), read through their 4021 shift
+    // registers, padded with 1s as official ones report after 8 reads.
+    bool m_pads_on[CTRL_SIZE];
+    Byte m_pad_buttons[CTRL_SIZE];
+    Byte2 m_pad_shifts[CTRL_SIZE];
+
+    // Of the inserted cartridge, 0 until measured.
+    std::size_t m_state_size;
+
+    Rewind m_rewind;
+    Cycle m_rewind_frame; // frame count last seen
+
+    int m_run_ahead;                     // frames
+    bool m_running_ahead;                // to be taken back
+    std::vector<Byte> m_run_ahead_state; // to take them back to
+
+    bool m_idle_skip;
+    // Since $4014 was written, until the transfer's first get cycle. Only
+    // tells when to check whether it can be burst, so not state.
+    bool m_oam_dma_started;
 
   private:
     NHLogger *m_logger;
@@ -135,7 +286,15 @@ struct Console {
     NHDFlag m_debug_flags;
 
   private:
-    double m_time;
+    // Fraction of CPU cycle left over by advance(), in nanocycles, i.e.
+    // always less than 1e9.
+    std::uint64_t m_time_rem;
+
+  private:
+    NHAudioSink *m_audio_sink; // Reference
+    static constexpr int SAMPLE_BUF_SIZE = 1024;
+    double m_samples[SAMPLE_BUF_SIZE];
+    int m_sample_count;
 };
 
 } // namespace nh
@@ -0,0 +1,173 @@
+#include "console_pool.hpp"
+
+#include "cartridge/cartridge.hpp"
+#include "console.hpp"
+
+namespace nh {
+
+ConsolePool::ConsolePool(int i_threads, NHLogger *i_logger)
+    : m_episode(0)
+    , m_actions(nullptr)
+    , m_dones(nullptr)
+    , m_threads(i_threads)
+    , m_logger(i_logger)
+{
+}
+
+ConsolePool::~ConsolePool()
+{
+    release();
+}
+
+NHErr
+ConsolePool::init(const Cartridge &i_rom, int i_consoles)
+{
+    release();
+    if (i_consoles <= 0)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    m_slots.resize(std::size_t(i_consoles));
+    for (auto &slot : m_slots)
+    {
+        slot.console = new Console(m_logger);
+        slot.frames = 0;
+
+        slot.console->set_buttons(NH_CTRL_P1, 0);
+        slot.console->insert_rom(i_rom);
+        slot.console->power_up();
+    }
+
+    Console *first = m_slots[0].console;
+    m_power_up_state.assign(first->state_size(), 0);
+    NHErr err = first->save_state(m_power_up_state.data(),
+                                  m_power_up_state.size());
+    if (NH_FAILED(err))
+    {
+        release();
+    }
+    return err;
+}
+
+int
+ConsolePool::size() const
+{
+    return int(m_slots.size());
+}
+
+Console *
+ConsolePool::get_console(int i_index)
+{
+    if (i_index < 0 || i_index >= size())
+    {
+        return nullptr;
+    }
+    return m_slots[std::size_t(i_index)].console;
+}
+
+void
+ConsolePool::set_episode(int i_frames)
+{
+    m_episode = i_frames > 0 ? i_frames : 0;
+}
+
+NHErr
+ConsolePool::set_frame_targets(void *o_targets, std::ptrdiff_t i_stride,
+                               int i_pitch, NHPixelFormat i_format)
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        void *target = nullptr;
+        if (o_targets)
+        {
+            target = (Byte *)o_targets + std::ptrdiff_t(i) * i_stride;
+        }
+        NHErr err = m_slots[i].console->set_frame_target(target, i_pitch,
+                                                         i_format);
+        if (NH_FAILED(err))
+        {
+            // All or none.
+            for (auto &slot : m_slots)
+            {
+                (void)slot.console->set_frame_target(nullptr, 0, i_format);
+            }
+            return err;
+        }
+    }
+    return NH_ERR_OK;
+}
+
+NHErr
+ConsolePool::set_observations(Byte *o_targets, std::ptrdiff_t i_stride,
+                              int i_width, int i_height, int i_pitch)
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        Byte *target =
+            o_targets ? o_targets + std::ptrdiff_t(i) * i_stride : nullptr;
+        NHErr err = m_slots[i].console->set_observation(target, i_width,
+                                                        i_height, i_pitch);
+        if (NH_FAILED(err))
+        {
+            // All or none.
+            for (auto &slot : m_slots)
+            {
+                (void)slot.console->set_observation(nullptr, 0, 0, 0);
+            }
+            return err;
+        }
+    }
+    return NH_ERR_OK;
+}
+
+void
+ConsolePool::step(const Byte *i_actions, Byte *o_dones)
+{
+    m_actions = i_actions;
+    m_dones = o_dones;
+    // Frames are converted to the targets on the worker threads too.
+    m_threads.run(m_slots.size(), step_one, this);
+    m_actions = nullptr;
+    m_dones = nullptr;
+}
+
+void
+ConsolePool::release()
+{
+    for (auto &slot : m_slots)
+    {
+        delete slot.console;
+    }
+    m_slots.clear();
+    m_power_up_state.clear();
+}
+
+void
+ConsolePool::step_one(std::size_t i_index, void *io_user)
+{
+    ConsolePool *pool = (ConsolePool *)io_user;
+    Slot &slot = pool->m_slots[i_index];
+
+    slot.console->set_buttons(NH_CTRL_P1, pool->m_actions
+                                              ? pool->m_actions[i_index]
+                                              : 0);
+    slot.console->run_frame();
+    ++slot.frames;
+
+    bool done = slot.console->halted() ||
+                (pool->m_episode && slot.frames >= pool->m_episode);
+    if (done)
+    {
+        // Same size as they're all of the same ROM, can't fail.
+        (void)slot.console->load_state(pool->m_power_up_state.data(),
+                                       pool->m_power_up_state.size());
+        slot.frames = 0;
+    }
+    if (pool->m_dones)
+    {
+        pool->m_dones[i_index] = done;
+    }
+}
+
+} // namespace nh
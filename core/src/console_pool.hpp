@@ -0,0 +1,83 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "nesish/nesish.h"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace nh {
+
+struct Console;
+struct Cartridge;
+
+/// @brief Consoles of one ROM stepped a frame at a time all together, each on
+/// whichever thread gets to it.
+struct ConsolePool {
+  public:
+    /// @param i_threads See ThreadPool
+    ConsolePool(int i_threads, NHLogger *i_logger);
+    ~ConsolePool();
+    NB_KLZ_DELETE_COPY_MOVE(ConsolePool);
+
+    /// @brief Consoles of "i_rom" powered up, in place of any before.
+    NHErr
+    init(const Cartridge &i_rom, int i_consoles);
+
+    int
+    size() const;
+    Console *
+    get_console(int i_index);
+
+    /// @param i_frames 0 for no limit
+    void
+    set_episode(int i_frames);
+    /// @brief Frames of console i are converted into "o_targets" +
+    /// i * "i_stride", see Console::set_frame_target().
+    NHErr
+    set_frame_targets(void *o_targets, std::ptrdiff_t i_stride, int i_pitch,
+                      NHPixelFormat i_format);
+    /// @brief Observations of console i are in "o_targets" + i * "i_stride",
+    /// see Console::set_observation().
+    NHErr
+    set_observations(Byte *o_targets, std::ptrdiff_t i_stride, int i_width,
+                     int i_height, int i_pitch);
+
+    /// @param i_actions Buttons pressed on P1 of each console, bit i for
+    /// NHKey i
+    /// @param o_dones Optional, if the episode of each console ended, it's
+    /// started over from power up then
+    void
+    step(const Byte *i_actions, Byte *o_dones);
+
+  private:
+    void
+    release();
+
+    static void
+    step_one(std::size_t i_index, void *io_user);
+
+  private:
+    struct Slot {
+        Console *console;
+        int frames; // into the episode
+    };
+    std::vector<Slot> m_slots;
+
+    // To start episodes over from
+    std::vector<Byte> m_power_up_state;
+    int m_episode; // frames
+
+    // Of the current step()
+    const Byte *m_actions;
+    Byte *m_dones;
+
+    ThreadPool m_threads;
+
+  private:
+    NHLogger *m_logger;
+};
+
+} // namespace nh
@@ -5,6 +5,7 @@
 #include "spec.hpp"
 #include "ppu/ppu.hpp"
 #include "apu/apu.hpp"
+#include "state_io.hpp"
 
 #define NH_BRK_OPCODE 0
 
@@ -14,6 +15,13 @@ CPU::CPU(Memory *i_memory, PPU *i_ppu, const APU *i_apu, NHLogger *i_logger)
     : m_memory(i_memory)
     , m_ppu(i_ppu)
     , m_apu(i_apu)
+    , m_idle_pc(0)
+    , m_idle_cycle(0)
+    , m_idle_ticks(-1)
+    , m_idle_load(0)
+    , m_idle_addr(0)
+    , m_idle_read_tick(-1)
+    , m_idle_tick(-1)
     , m_logger(i_logger)
 {
 }
@@ -31,6 +39,8 @@ CPU::power_up()
         m_instr_halt = false;
         m_dma_halt = false;
 
+        m_ppustatus_read_tmp = false;
+        m_write_tick_tmp = false;
         m_mask_read_tmp = false;
         m_prev_ppudata_read = 0;
         m_prev_joy1_read = 0;
@@ -47,7 +57,21 @@ CPU::power_up()
         m_irq_no_mem_write_tmp = false;
         m_is_nmi_tmp = false;
 
+        // Saved with states, so as a new console's are all the same.
+        m_addr_bus = 0;
+        m_data_bus = 0;
+        m_page_offset = 0;
+        m_i_eff_addr = 0;
+
         m_instr_ctx = {0x00, 0, nullptr};
+
+        m_idle_pc = 0;
+        m_idle_cycle = 0;
+        m_idle_ticks = -1;
+        m_idle_load = 0;
+        m_idle_addr = 0;
+        m_idle_read_tick = -1;
+        m_idle_tick = -1;
     }
 
     // program entry point
@@ -62,6 +86,62 @@ CPU::reset()
     m_instr_halt = false;
 }
 
+void
+CPU::serialize(StateIO &io_state)
+{
+    // Skipped iterations run to the end once started, see Console::tick().
+    NH_ASSERT(m_idle_tick < 0);
+    if (io_state.loading())
+    {
+        m_idle_ticks = -1;
+    }
+
+    io_state.field(A);
+    io_state.field(X);
+    io_state.field(Y);
+    io_state.field(PC);
+    io_state.field(S);
+    io_state.field(P);
+
+    io_state.field(m_cycle);
+    io_state.field(m_instr_halt);
+    io_state.field(m_dma_halt);
+
+    io_state.field(m_ppustatus_read_tmp);
+    io_state.field(m_write_tick_tmp);
+    io_state.field(m_mask_read_tmp);
+    io_state.field(m_prev_ppudata_read);
+    io_state.field(m_prev_joy1_read);
+    io_state.field(m_prev_joy2_read);
+
+    io_state.field(m_nmi_asserted);
+    io_state.field(m_nmi_sig);
+    io_state.field(m_irq_sig);
+    io_state.field(m_reset_sig);
+    io_state.field(m_irq_pc_no_inc);
+    io_state.field(m_irq_no_mem_write);
+    io_state.field(m_is_nmi);
+    io_state.field(m_irq_pc_no_inc_tmp);
+    io_state.field(m_irq_no_mem_write_tmp);
+    io_state.field(m_is_nmi_tmp);
+
+    io_state.field(m_addr_bus);
+    io_state.field(m_data_bus);
+    io_state.field(m_page_offset);
+    io_state.field(m_i_eff_addr);
+
+    // The instruction in progress, by opcode rather than table entry.
+    bool in_instr = m_instr_ctx.instr != nullptr;
+    io_state.field(in_instr);
+    io_state.field(m_instr_ctx.opcode);
+    io_state.field(m_instr_ctx.cycle_plus1);
+    if (io_state.loading())
+    {
+        m_instr_ctx.instr =
+            in_instr ? &s_instr_table[m_instr_ctx.opcode] : nullptr;
+    }
+}
+
 void
 CPU::test_set_entry(Address i_entry)
 {
@@ -75,7 +155,8 @@ CPU::test_set_p(Byte i_val)
 }
 
 bool
-CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read)
+CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, Cycle i_idle_budget,
+              bool &o_2002_read)
 {
     m_ppustatus_read_tmp = false;
     auto defer_ret = [&o_2002_read, this]() {
@@ -92,6 +173,22 @@ CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read)
         return false;
     }
 
+    // Iterations of idle loops that can only go as the last one did are
+    // skipped but for their load, to save decoding and running the rest.
+    if (i_idle_budget && m_idle_tick < 0 && !m_instr_ctx.instr &&
+        !m_dma_halt && !i_rdy && enter_idle(i_idle_budget))
+    {
+        m_idle_tick = 0;
+    }
+    if (m_idle_tick >= 0)
+    {
+        NH_ASSERT(!i_rdy);
+        bool instr_done = idle_tick();
+        ++m_cycle;
+        defer_ret();
+        return instr_done;
+    }
+
     // check to unset halt flag
     if (m_dma_halt)
     {
@@ -108,28 +205,26 @@ CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read)
     // -- CPU must be halted in read cycle since that's when it can be halted by
     // DMA
     m_mask_read_tmp = m_dma_halt && i_dma_op_cycle;
-    // common function to check to set halt flag
+    // Check to set halt flag before executing the cycle, the opcode fetch is a
+    // read cycle and the rest are known from the instruction.
     // won't conflict with the above unset logic due to "i_rdy"
-    auto chk_to_flag_halt = [i_rdy, this]() {
-        if (!m_dma_halt)
+    bool write_tick =
+        m_instr_ctx.instr &&
+        ((m_instr_ctx.instr->write_cycles >> m_instr_ctx.cycle_plus1) & 0x01);
+    if (!m_dma_halt)
+    {
+        // Can only halt on read cycle
+        if (i_rdy && !write_tick)
         {
-            // Can only halt on read cycle
-            if (i_rdy && !m_write_tick_tmp)
-            {
-                m_dma_halt = true;
-            }
+            m_dma_halt = true;
         }
-    };
+    }
 
     bool instr_done = false;
     // Fetch opcode
     if (!m_instr_ctx.instr)
     {
-        // default to read tick so we only need to mark write operations.
-        // i.e. each cycle is read cycle unless marked otherwise.
-        m_write_tick_tmp = false;
         Byte opcode = get_byte(PC);
-        chk_to_flag_halt();
 
         if (!m_dma_halt)
         {
@@ -151,6 +246,17 @@ CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read)
         }
     }
     // Rest cycles of the instruction
+    else if (!m_dma_halt)
+    {
+        m_write_tick_tmp = false;
+        exec_instr(m_instr_ctx.opcode, m_instr_ctx.cycle_plus1, instr_done);
+        NH_ASSERT(m_write_tick_tmp == write_tick);
+
+        ++m_instr_ctx.cycle_plus1;
+    }
+    // Halted read cycle, which is repeated after the halt. The read is still
+    // done for its side effects, then changes are restored so that the repeat
+    // gets the same result.
     else
     {
         /* Backup states that may be altered after one instruction cycle and may
@@ -166,93 +272,81 @@ CPU::pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read)
         auto prev_addr_bus = m_addr_bus;
         auto prev_data_bus = m_data_bus;
 
-        m_write_tick_tmp = false;
-        m_instr_ctx.instr->frm(m_instr_ctx.cycle_plus1, this,
-                               m_instr_ctx.instr->core, instr_done);
-        chk_to_flag_halt();
+        exec_instr(m_instr_ctx.opcode, m_instr_ctx.cycle_plus1, instr_done);
+
+        A = prevA;
+        X = prevX;
+        Y = prevY;
+        PC = prevPC;
+        S = prevS;
+        P = prevP;
 
+        m_addr_bus = prev_addr_bus;
+        m_data_bus = prev_data_bus;
+        // no need for "m_page_offset" and "m_i_eff_addr"
+    }
+    if (instr_done)
+    {
+        // ------ Current
         if (!m_dma_halt)
         {
-            ++m_instr_ctx.cycle_plus1;
+            // Use in_reset() before updating relevant flags
+            if (in_reset())
+            {
+                // Indicating RESET is handled.
+                m_reset_sig = false;
+            }
+            // Use in_nmi() before updating relevant flags
+            if (in_nmi())
+            {
+                // Indicating NMI is handled.
+                // @TEST: Right to do this at last cycle?
+                m_nmi_sig = false;
+            }
+        }
+
+        // ------ Next
+        /* Poll interrupts */
+        // Poll interrupts even it's halted by DMAs (m_dma_halt)
+        // Most instructions poll interrupts at the last cycle.
+        // Special cases are listed and handled on thier own.
+        if (m_instr_ctx.opcode == NH_BRK_OPCODE ||
+            m_instr_ctx.instr->addr_mode == AddrMode::REL)
+        {
+            // The interrupt sequences themselves do not perform
+            // interrupt polling, meaning at least one instruction from
+            // the interrupt handler will execute before another
+            // interrupt is serviced
+            // https://www.nesdev.org/wiki/CPU_interrupts#Detailed_interrupt_behavior
+            // All types of interrupts reuse the same logic as BRK for
+            // the most part.
+
+            // Branch instructions are also special, we handle it
+            // in its implementation. They are identified by address
+            // mode.
         }
-        // Restore changes, so that repeat cycles get the same result, excluding
-        // possible multiple side effects.
         else
         {
-            A = prevA;
-            X = prevX;
-            Y = prevY;
-            PC = prevPC;
-            S = prevS;
-            P = prevP;
-
-            m_addr_bus = prev_addr_bus;
-            m_data_bus = prev_data_bus;
-            // no need for "m_page_offset" and "m_i_eff_addr"
+            // Poll interrupts at the last cycle
+            poll_interrupt();
         }
-        if (instr_done)
+
+        if (!m_dma_halt)
         {
-            // ------ Current
-            if (!m_dma_halt)
+            // Swap at the end of instruction, setup states for next
+            // instruction
             {
-                // Use in_reset() before updating relevant flags
-                if (in_reset())
-                {
-                    // Indicating RESET is handled.
-                    m_reset_sig = false;
-                }
-                // Use in_nmi() before updating relevant flags
-                if (in_nmi())
-                {
-                    // Indicating NMI is handled.
-                    // @TEST: Right to do this at last cycle?
-                    m_nmi_sig = false;
-                }
-            }
+                m_irq_pc_no_inc = m_irq_pc_no_inc_tmp;
+                m_irq_no_mem_write = m_irq_no_mem_write_tmp;
+                m_is_nmi = m_is_nmi_tmp;
 
-            // ------ Next
-            /* Poll interrupts */
-            // Poll interrupts even it's halted by DMAs (m_dma_halt)
-            // Most instructions poll interrupts at the last cycle.
-            // Special cases are listed and handled on thier own.
-            if (m_instr_ctx.opcode == NH_BRK_OPCODE ||
-                m_instr_ctx.instr->addr_mode == AddrMode::REL)
-            {
-                // The interrupt sequences themselves do not perform
-                // interrupt polling, meaning at least one instruction from
-                // the interrupt handler will execute before another
-                // interrupt is serviced
-                // https://www.nesdev.org/wiki/CPU_interrupts#Detailed_interrupt_behavior
-                // All types of interrupts reuse the same logic as BRK for
-                // the most part.
-
-                // Branch instructions are also special, we handle it
-                // in its implementation. They are identified by address
-                // mode.
-            }
-            else
-            {
-                // Poll interrupts at the last cycle
-                poll_interrupt();
+                m_irq_pc_no_inc_tmp = false;
+                m_irq_no_mem_write_tmp = false;
+                m_is_nmi_tmp = false;
             }
 
-            if (!m_dma_halt)
-            {
-                // Swap at the end of instruction, setup states for next
-                // instruction
-                {
-                    m_irq_pc_no_inc = m_irq_pc_no_inc_tmp;
-                    m_irq_no_mem_write = m_irq_no_mem_write_tmp;
-                    m_is_nmi = m_is_nmi_tmp;
-
-                    m_irq_pc_no_inc_tmp = false;
-                    m_irq_no_mem_write_tmp = false;
-                    m_is_nmi_tmp = false;
-                }
-
-                // So that next instruction can continue afterwards.
-                m_instr_ctx.instr = nullptr;
-            }
+            // So that next instruction can continue afterwards.
+            m_instr_ctx.instr = nullptr;
         }
     }
     ++m_cycle;
@@ -294,12 +388,175 @@ CPU::post_tick()
     }
 }
 
+bool
+CPU::enter_idle(Cycle i_budget)
+{
+    // Loops end with a branch or jump back.
+    Byte last = m_instr_ctx.opcode;
+    if ((last & 0x1F) != 0x10 && last != 0x4C)
+    {
+        return false;
+    }
+
+    // Known not to be one
+    if (PC == m_idle_pc && !m_idle_ticks)
+    {
+        return false;
+    }
+    // Back right after an iteration, so it went as the one before, nothing
+    // read having changed, and so will the next unless something steps in.
+    bool again = m_idle_ticks > 0 && PC == m_idle_pc &&
+                 m_cycle == m_idle_cycle + Cycle(m_idle_ticks);
+    m_idle_cycle = m_cycle;
+    if (!again)
+    {
+        m_idle_pc = PC;
+        m_idle_ticks =
+            idle_loop(PC, m_idle_load, m_idle_addr, m_idle_read_tick);
+        return false;
+    }
+
+    // Interrupts polled along the way, DMAs halting it, or the PPU changing
+    // the line to NMI or what the load reads. The rest of the frame or the
+    // cycles run must not end halfway either.
+    if (Cycle(m_idle_ticks) > i_budget || m_nmi_sig || m_irq_sig ||
+        m_reset_sig || in_hardware_irq() || m_apu->dmc_fetching() ||
+        m_ppu->nmi() != m_nmi_asserted)
+    {
+        return false;
+    }
+    if (!check_flag(StatusFlag::I) &&
+        (m_apu->interrupt() || m_apu->may_interrupt()))
+    {
+        return false;
+    }
+    // 3 PPU ticks a cycle
+    if (m_ppu->ticks_to_event() <= 3 * m_idle_ticks)
+    {
+        return false;
+    }
+    // Waiting for it to be set, which it isn't until then.
+    return m_idle_read_tick < 0 || NH_PPUSTATUS_ADDR != m_idle_addr ||
+           !m_ppu->vbl();
+}
+
+int
+CPU::idle_loop(Address i_pc, Byte &o_load, Address &o_addr,
+               int &o_read_tick) const
+{
+    // Code up to 5 bytes, which can be read without side effects.
+    auto peekable = [](Address i_addr) -> bool {
+        return i_addr <= NH_RAM_ADDR_TAIL || i_addr >= NH_CARTRIDGE_ADDR_HEAD;
+    };
+    if (!peekable(i_pc) || !peekable(Address(i_pc + 4)))
+    {
+        return 0;
+    }
+    auto peek_byte2 = [this](Address i_addr) -> Address {
+        return Address(peek_byte(i_addr) |
+                       (peek_byte(Address(i_addr + 1)) << 8));
+    };
+
+    // JMP to itself
+    Byte opcode = peek_byte(i_pc);
+    if (0x4C == opcode)
+    {
+        o_read_tick = -1;
+        return peek_byte2(Address(i_pc + 1)) == i_pc ? 3 : 0;
+    }
+
+    // A load, then a branch back to it
+    int load_ticks = 0;
+    Address addr = 0;
+    switch (opcode)
+    {
+        case 0x24: // BIT zp
+        case 0xA4: // LDY zp
+        case 0xA5: // LDA zp
+        case 0xA6: // LDX zp
+            load_ticks = 3;
+            addr = peek_byte(Address(i_pc + 1));
+            break;
+
+        case 0x2C: // BIT abs
+        case 0xAC: // LDY abs
+        case 0xAD: // LDA abs
+        case 0xAE: // LDX abs
+            load_ticks = 4;
+            addr = peek_byte2(Address(i_pc + 1));
+            break;
+
+        default:
+            return 0;
+    }
+    Address branch = Address(i_pc + load_ticks - 1);
+    Byte branch_opcode = peek_byte(branch);
+    Address next = Address(branch + 2);
+    if ((branch_opcode & 0x1F) != 0x10 ||
+        Address(next + SignedByte(peek_byte(Address(branch + 1)))) != i_pc)
+    {
+        return 0;
+    }
+    // RAM, which only the CPU writes, or the VBL flag waited for by BPL,
+    // which only a PPU event sets. Other bits of $2002 aren't waited for, they
+    // change at any time.
+    if (addr > NH_RAM_ADDR_TAIL &&
+        (NH_PPUSTATUS_ADDR != addr || 0x10 != branch_opcode))
+    {
+        return 0;
+    }
+
+    o_load = opcode;
+    o_addr = addr;
+    o_read_tick = load_ticks - 1;
+    // The branch taken, a cycle more to another page
+    return load_ticks + 3 + ((next ^ i_pc) & 0xFF00 ? 1 : 0);
+}
+
+bool
+CPU::idle_tick()
+{
+    bool instr_done = false;
+    // The load alone, which may cause a change, e.g. reading $2002, or see one
+    // that doesn't end the loop. The bus is then left as the fetches after it
+    // left it.
+    if (m_idle_tick == m_idle_read_tick)
+    {
+        Byte latch = m_memory->get_latch();
+        m_addr_bus = m_idle_addr;
+        exec_instr(m_idle_load, m_idle_read_tick - 1, instr_done);
+        m_memory->override_latch(latch);
+    }
+    if (++m_idle_tick == m_idle_ticks)
+    {
+        m_idle_tick = -1;
+        instr_done = true;
+    }
+    return instr_done;
+}
+
+Byte
+CPU::peek_byte(Address i_addr) const
+{
+    Byte latch = m_memory->get_latch();
+    Byte byte = 0xFF;
+    (void)m_memory->get_byte(i_addr, byte);
+    m_memory->override_latch(latch);
+    return byte;
+}
+
 bool
 CPU::dma_halt() const
 {
     return m_dma_halt;
 }
 
+bool
+CPU::instr_halt() const
+{
+    return m_instr_halt;
+}
+
 Cycle
 CPU::test_get_cycle() const
 {
@@ -498,6 +755,11 @@ CPU::set_byte(Address i_addr, Byte i_byte)
     // At hardware, this is done by setting to line to read instead of write
     if (!m_irq_no_mem_write)
     {
+        // Mapper registers may switch what the PPU fetches.
+        if (i_addr >= NH_CARTRIDGE_ADDR_HEAD)
+        {
+            m_ppu->sync();
+        }
         auto err = m_memory->set_byte(i_addr, i_byte);
         NH_ASSERT_ERROR_COND(!NH_FAILED(err) || err == NH_ERR_READ_ONLY ||
                                  err == NH_ERR_UNAVAILABLE,
@@ -12,6 +12,7 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
 struct PPU;
 struct APU;
 
@@ -28,15 +29,24 @@ struct CPU {
 
     /// @param i_rdy RDY line input enabled
     /// @param i_dma_op_cycle If this cycle is a DMA operation cycle
+    /// @param i_idle_budget Cycles sure to be ticked from this one on with no
+    /// DMA, within which an idle loop iteration may be skipped, 0 not to.
     /// @param o_2002_read Whether $2002 was read at this tick
     /// @return Whether an instruction has completed.
     bool
-    pre_tick(bool i_rdy, bool i_dma_op_cycle, bool &o_2002_read);
+    pre_tick(bool i_rdy, bool i_dma_op_cycle, Cycle i_idle_budget,
+             bool &o_2002_read);
     void
     post_tick();
 
     bool
     dma_halt() const;
+    /// @return If halted by an instruction, until reset.
+    bool
+    instr_halt() const;
+
+    void
+    serialize(StateIO &io_state);
 
   public:
     /* Test */
@@ -126,6 +136,27 @@ struct CPU {
     void
     poll_interrupt();
 
+  private:
+    /// @brief Called at opcode fetch.
+    /// @return If the next iteration of an idle loop here can be skipped.
+    bool
+    enter_idle(Cycle i_budget);
+    /// @return Cycles of an iteration of a loop at "i_pc" that only waits,
+    /// 0 if it isn't one.
+    /// @param o_load Opcode of its load, if any
+    /// @param o_addr What its load reads
+    /// @param o_read_tick Cycle of the iteration its load reads at, -1 if none
+    int
+    idle_loop(Address i_pc, Byte &o_load, Address &o_addr,
+              int &o_read_tick) const;
+    /// @brief A cycle of an idle loop iteration being skipped.
+    /// @return Whether an instruction has completed.
+    bool
+    idle_tick();
+    /// @brief Read RAM or cartridge space without side effects.
+    Byte
+    peek_byte(Address i_addr) const;
+
   private:
     // ---- Registers
     // https://wiki.nesdev.org/w/index.php?title=CPU_registers
@@ -151,7 +182,7 @@ struct CPU {
 
     // ---- temporaries for one tick
     mutable bool m_ppustatus_read_tmp;
-    bool m_write_tick_tmp; // used in chk_to_flag_halt()
+    bool m_write_tick_tmp; // to verify InstrDesc::write_cycles
     bool m_mask_read_tmp;  // used in get_byte()
     // ---- preserve across ticks
     mutable Cycle m_prev_ppudata_read;
@@ -172,11 +203,19 @@ struct CPU {
     bool m_irq_no_mem_write_tmp;
     bool m_is_nmi_tmp;
 
+    // ---- idle loops, see enter_idle()
+    // Not state, they only tell iterations alike apart, so reset on loading.
+    Address m_idle_pc;    // where the last one seen starts
+    Cycle m_idle_cycle;   // when its last iteration started
+    int m_idle_ticks;     // cycles per iteration, 0 if none, -1 unknown
+    Byte m_idle_load;     // opcode of its load
+    Address m_idle_addr;  // what its load reads
+    int m_idle_read_tick; // cycle its load reads at, -1 if none
+    int m_idle_tick;      // into the iteration skipped, -1 if none
+
   private:
     struct InstrImpl;
     typedef void (*InstrCore)(nh::CPU *io_cpu, Byte i_in, Byte &o_out);
-    typedef void (*InstrFrame)(int i_idx, nh::CPU *io_cpu, InstrCore i_core,
-                               bool &io_done);
 
     /* Set and used in execution of instruction, not to be confused with
      * the real-time status of the hardware bus (not considered) */
@@ -188,18 +227,21 @@ struct CPU {
     Address m_i_eff_addr;
 
     struct InstrDesc {
-        InstrCore core;
         AddrMode addr_mode;
-        InstrFrame frm;
+        Byte write_cycles; // bit i set if cycle i after opcode fetch writes
     };
-    static InstrDesc s_instr_table[256];
+    static const InstrDesc s_instr_table[256];
 
     struct InstrContext {
         Byte opcode;
         int cycle_plus1;
-        InstrDesc *instr;
+        const InstrDesc *instr;
     } m_instr_ctx;
 
+    /// @brief Execute cycle "i_idx" of the instruction "i_opcode".
+    void
+    exec_instr(Byte i_opcode, int i_idx, bool &io_done);
+
   private:
     NHLogger *m_logger;
 };
@@ -6,118 +6,155 @@ namespace nh {
 
 struct CPU::InstrImpl {
   public:
+    template <InstrCore i_core>
     static void
-    frm_brk(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_brk(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_rti(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_rti(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_rts(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_rts(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_pha(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_pha(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_php(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_php(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_pla(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_pla(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_plp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_plp(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_jsr(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_jsr(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_imp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_imp(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_acc(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_acc(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_imm(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_imm(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_rel(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_rel(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_ind_jmp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_ind_jmp(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_abs_jmp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abs_jmp(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_abs_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abs_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_abs_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abs_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_abs_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abs_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_abx_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abx_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_abx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abx_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_abx_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_abx_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_aby_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_aby_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_aby_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_aby_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_aby_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_aby_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_zp_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zp_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_zp_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zp_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_zp_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zp_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_zpx_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zpx_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_zpx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zpx_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_zpx_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zpx_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_zpy_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zpy_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_zpy_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_zpy_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_izx_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izx_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_izx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izx_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_izx_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izx_w(int i_idx, CPU *io_cpu, bool &io_done);
 
+    template <InstrCore i_core>
     static void
-    frm_izy_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izy_r(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_izy_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izy_rmw(int i_idx, CPU *io_cpu, bool &io_done);
+    template <InstrCore i_core>
     static void
-    frm_izy_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done);
+    frm_izy_w(int i_idx, CPU *io_cpu, bool &io_done);
 
   private:
+    template <InstrCore i_core>
     static void
-    frm_phr_impl(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-                 Byte i_val);
+    frm_phr_impl(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_plr_impl(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-                 Byte &o_val);
+    frm_plr_impl(int i_idx, CPU *io_cpu, bool &io_done, Byte &o_val);
     static void
     frm_abs_pre(int i_idx, CPU *io_cpu);
     static void
     frm_abi_pre(int i_idx, CPU *io_cpu, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_abi_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-              Byte i_val);
+    frm_abi_r(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_abi_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-              Byte i_val);
+    frm_abi_w(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_abi_rmw(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-                Byte i_val);
+    frm_abi_rmw(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
     static void
     frm_zpi_pre(int i_idx, CPU *io_cpu, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_zpi_r(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-              Byte i_val);
+    frm_zpi_r(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
+    template <InstrCore i_core>
     static void
-    frm_zpi_w(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done,
-              Byte i_val);
+    frm_zpi_w(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val);
     static void
     frm_izx_pre(int i_idx, CPU *io_cpu);
     static void
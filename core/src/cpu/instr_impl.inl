@@ -6,11 +6,10 @@
 
 namespace nh {
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_brk(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_brk(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -95,11 +94,10 @@ CPU::InstrImpl::frm_brk(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_rti(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_rti(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -141,11 +139,10 @@ CPU::InstrImpl::frm_rti(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_rts(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_rts(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -184,12 +181,10 @@ CPU::InstrImpl::frm_rts(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_phr_impl(int i_idx, CPU *io_cpu, InstrCore i_core,
-                             bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_phr_impl(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -209,26 +204,26 @@ CPU::InstrImpl::frm_phr_impl(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_pha(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_pha(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_phr_impl(i_idx, io_cpu, i_core, io_done, io_cpu->A);
+    frm_phr_impl<i_core>(i_idx, io_cpu, io_done, io_cpu->A);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_php(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_php(int i_idx, CPU *io_cpu, bool &io_done)
 {
     // https://wiki.nesdev.org/w/index.php?title=Status_flags#The_B_flag
     // Push the status register with the B flag set
-    frm_phr_impl(i_idx, io_cpu, i_core, io_done, io_cpu->P | StatusFlag::B);
+    frm_phr_impl<i_core>(i_idx, io_cpu, io_done, io_cpu->P | StatusFlag::B);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_plr_impl(int i_idx, CPU *io_cpu, InstrCore i_core,
-                             bool &io_done, Byte &o_val)
+CPU::InstrImpl::frm_plr_impl(int i_idx, CPU *io_cpu, bool &io_done, Byte &o_val)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -254,11 +249,12 @@ CPU::InstrImpl::frm_plr_impl(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_pla(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_pla(int i_idx, CPU *io_cpu, bool &io_done)
 {
     Byte val;
-    frm_plr_impl(i_idx, io_cpu, i_core, io_done, val);
+    frm_plr_impl<i_core>(i_idx, io_cpu, io_done, val);
     if (io_done)
     {
         io_cpu->A = val;
@@ -268,11 +264,12 @@ CPU::InstrImpl::frm_pla(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_plp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_plp(int i_idx, CPU *io_cpu, bool &io_done)
 {
     Byte val;
-    frm_plr_impl(i_idx, io_cpu, i_core, io_done, val);
+    frm_plr_impl<i_core>(i_idx, io_cpu, io_done, val);
     if (io_done)
     {
         // Disregards bits 5 and 4 when reading flags from the stack
@@ -281,11 +278,10 @@ CPU::InstrImpl::frm_plp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_jsr(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_jsr(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -326,18 +322,20 @@ CPU::InstrImpl::frm_jsr(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_imp(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_imp(int i_idx, CPU *io_cpu, bool &io_done)
 {
     // @TODO: Pipelining
 
     // Since the in and out won't be used in core for this kind of
     // instructions, reuse acc implemenation for simplicity.
-    frm_acc(i_idx, io_cpu, i_core, io_done);
+    frm_acc<i_core>(i_idx, io_cpu, io_done);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_acc(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_acc(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -355,8 +353,9 @@ CPU::InstrImpl::frm_acc(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_imm(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_imm(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -374,12 +373,10 @@ CPU::InstrImpl::frm_imm(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abs_jmp(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_abs_jmp(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
@@ -422,9 +419,9 @@ CPU::InstrImpl::frm_abs_pre(int i_idx, CPU *io_cpu)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abs_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_abs_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -449,9 +446,9 @@ CPU::InstrImpl::frm_abs_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abs_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_abs_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -489,9 +486,9 @@ CPU::InstrImpl::frm_abs_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abs_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_abs_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -539,9 +536,9 @@ CPU::InstrImpl::frm_abi_pre(int i_idx, CPU *io_cpu, Byte i_val)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abi_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_abi_r(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
     switch (i_idx)
     {
@@ -586,9 +583,9 @@ CPU::InstrImpl::frm_abi_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abi_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_abi_w(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
     switch (i_idx)
     {
@@ -624,9 +621,9 @@ CPU::InstrImpl::frm_abi_w(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abi_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_abi_rmw(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
     switch (i_idx)
     {
@@ -675,51 +672,51 @@ CPU::InstrImpl::frm_abi_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abx_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_abx_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_r(i_idx, io_cpu, i_core, io_done, io_cpu->X);
+    frm_abi_r<i_core>(i_idx, io_cpu, io_done, io_cpu->X);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_abx_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_rmw(i_idx, io_cpu, i_core, io_done, io_cpu->X);
+    frm_abi_rmw<i_core>(i_idx, io_cpu, io_done, io_cpu->X);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_abx_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_abx_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_w(i_idx, io_cpu, i_core, io_done, io_cpu->X);
+    frm_abi_w<i_core>(i_idx, io_cpu, io_done, io_cpu->X);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_aby_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_aby_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_r(i_idx, io_cpu, i_core, io_done, io_cpu->Y);
+    frm_abi_r<i_core>(i_idx, io_cpu, io_done, io_cpu->Y);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_aby_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_aby_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_rmw(i_idx, io_cpu, i_core, io_done, io_cpu->Y);
+    frm_abi_rmw<i_core>(i_idx, io_cpu, io_done, io_cpu->Y);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_aby_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_aby_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_abi_w(i_idx, io_cpu, i_core, io_done, io_cpu->Y);
+    frm_abi_w<i_core>(i_idx, io_cpu, io_done, io_cpu->Y);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zp_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                         bool &io_done)
+CPU::InstrImpl::frm_zp_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -743,9 +740,9 @@ CPU::InstrImpl::frm_zp_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zp_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                           bool &io_done)
+CPU::InstrImpl::frm_zp_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -782,9 +779,9 @@ CPU::InstrImpl::frm_zp_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zp_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                         bool &io_done)
+CPU::InstrImpl::frm_zp_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -829,9 +826,9 @@ CPU::InstrImpl::frm_zpi_pre(int i_idx, CPU *io_cpu, Byte i_val)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpi_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_zpi_r(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
     switch (i_idx)
     {
@@ -856,9 +853,9 @@ CPU::InstrImpl::frm_zpi_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpi_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done, Byte i_val)
+CPU::InstrImpl::frm_zpi_w(int i_idx, CPU *io_cpu, bool &io_done, Byte i_val)
 {
     switch (i_idx)
     {
@@ -883,16 +880,16 @@ CPU::InstrImpl::frm_zpi_w(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpx_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_zpx_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_zpi_r(i_idx, io_cpu, i_core, io_done, io_cpu->X);
+    frm_zpi_r<i_core>(i_idx, io_cpu, io_done, io_cpu->X);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_zpx_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -930,29 +927,30 @@ CPU::InstrImpl::frm_zpx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpx_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_zpx_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_zpi_w(i_idx, io_cpu, i_core, io_done, io_cpu->X);
+    frm_zpi_w<i_core>(i_idx, io_cpu, io_done, io_cpu->X);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpy_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_zpy_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_zpi_r(i_idx, io_cpu, i_core, io_done, io_cpu->Y);
+    frm_zpi_r<i_core>(i_idx, io_cpu, io_done, io_cpu->Y);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_zpy_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_zpy_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    frm_zpi_w(i_idx, io_cpu, i_core, io_done, io_cpu->Y);
+    frm_zpi_w<i_core>(i_idx, io_cpu, io_done, io_cpu->Y);
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_rel(int i_idx, CPU *io_cpu, InstrCore i_core, bool &io_done)
+CPU::InstrImpl::frm_rel(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1061,9 +1059,9 @@ CPU::InstrImpl::frm_izx_pre(int i_idx, CPU *io_cpu)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izx_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_izx_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1090,9 +1088,9 @@ CPU::InstrImpl::frm_izx_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_izx_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1132,9 +1130,9 @@ CPU::InstrImpl::frm_izx_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izx_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_izx_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1191,9 +1189,9 @@ CPU::InstrImpl::frm_izy_pre(int i_idx, CPU *io_cpu)
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izy_r(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_izy_r(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1239,9 +1237,9 @@ CPU::InstrImpl::frm_izy_r(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izy_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_izy_rmw(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1291,9 +1289,9 @@ CPU::InstrImpl::frm_izy_rmw(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_izy_w(int i_idx, CPU *io_cpu, InstrCore i_core,
-                          bool &io_done)
+CPU::InstrImpl::frm_izy_w(int i_idx, CPU *io_cpu, bool &io_done)
 {
     switch (i_idx)
     {
@@ -1330,12 +1328,10 @@ CPU::InstrImpl::frm_izy_w(int i_idx, CPU *io_cpu, InstrCore i_core,
     }
 }
 
+template <CPU::InstrCore i_core>
 void
-CPU::InstrImpl::frm_ind_jmp(int i_idx, CPU *io_cpu, InstrCore i_core,
-                            bool &io_done)
+CPU::InstrImpl::frm_ind_jmp(int i_idx, CPU *io_cpu, bool &io_done)
 {
-    (void)(i_core);
-
     switch (i_idx)
     {
         default:
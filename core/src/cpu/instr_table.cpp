@@ -1,288 +1,354 @@
 #include "cpu/cpu.hpp"
 
 #include "cpu/instr_impl.hpp"
+// Definitions of frames and cores, so that they are instantiated and inlined
+// here, where instructions are dispatched.
+#include "cpu/instr_impl.inl"
 
-#define CORE(i_name) CPU::InstrImpl::core_##i_name
-#define FRM(i_name) CPU::InstrImpl::frm_##i_name
+// X(opcode, core, addressing mode, frame)
+// http://www.oxyron.de/html/opcodes02.html
+/* clang-format off */
+#define NH_INSTR_TABLE(X)                                                      \
+    /* -- 0x */                                                                \
+    X(0x00, nop, IMP, brk)                                                     \
+    X(0x01, ora, IZX, izx_r)                                                   \
+    X(0x02, kil, IMP, imp)                                                     \
+    X(0x03, slo, IZX, izx_rmw)                                                 \
+    X(0x04, nop, ZP0, zp_r)                                                    \
+    X(0x05, ora, ZP0, zp_r)                                                    \
+    X(0x06, asl, ZP0, zp_rmw)                                                  \
+    X(0x07, slo, ZP0, zp_rmw)                                                  \
+    X(0x08, nop, IMP, php)                                                     \
+    X(0x09, ora, IMM, imm)                                                     \
+    X(0x0A, asl, ACC, acc)                                                     \
+    X(0x0B, anc, IMM, imm)                                                     \
+    X(0x0C, nop, ABS, abs_r)                                                   \
+    X(0x0D, ora, ABS, abs_r)                                                   \
+    X(0x0E, asl, ABS, abs_rmw)                                                 \
+    X(0x0F, slo, ABS, abs_rmw)                                                 \
+    /* -- 1x */                                                                \
+    X(0x10, bpl, REL, rel)                                                     \
+    X(0x11, ora, IZY, izy_r)                                                   \
+    X(0x12, kil, IMP, imp)                                                     \
+    X(0x13, slo, IZY, izy_rmw)                                                 \
+    X(0x14, nop, ZPX, zpx_r)                                                   \
+    X(0x15, ora, ZPX, zpx_r)                                                   \
+    X(0x16, asl, ZPX, zpx_rmw)                                                 \
+    X(0x17, slo, ZPX, zpx_rmw)                                                 \
+    X(0x18, clc, IMP, imp)                                                     \
+    X(0x19, ora, ABY, aby_r)                                                   \
+    X(0x1A, nop, IMP, imp)                                                     \
+    X(0x1B, slo, ABY, aby_rmw)                                                 \
+    X(0x1C, nop, ABX, abx_r)                                                   \
+    X(0x1D, ora, ABX, abx_r)                                                   \
+    X(0x1E, asl, ABX, abx_rmw)                                                 \
+    X(0x1F, slo, ABX, abx_rmw)                                                 \
+    /* -- 2x */                                                                \
+    X(0x20, nop, ABS, jsr)                                                     \
+    X(0x21, and, IZX, izx_r)                                                   \
+    X(0x22, kil, IMP, imp)                                                     \
+    X(0x23, rla, IZX, izx_rmw)                                                 \
+    X(0x24, bit, ZP0, zp_r)                                                    \
+    X(0x25, and, ZP0, zp_r)                                                    \
+    X(0x26, rol, ZP0, zp_rmw)                                                  \
+    X(0x27, rla, ZP0, zp_rmw)                                                  \
+    X(0x28, nop, IMP, plp)                                                     \
+    X(0x29, and, IMM, imm)                                                     \
+    X(0x2A, rol, ACC, acc)                                                     \
+    X(0x2B, anc, IMM, imm)                                                     \
+    X(0x2C, bit, ABS, abs_r)                                                   \
+    X(0x2D, and, ABS, abs_r)                                                   \
+    X(0x2E, rol, ABS, abs_rmw)                                                 \
+    X(0x2F, rla, ABS, abs_rmw)                                                 \
+    /* -- 3x */                                                                \
+    X(0x30, bmi, REL, rel)                                                     \
+    X(0x31, and, IZY, izy_r)                                                   \
+    X(0x32, kil, IMP, imp)                                                     \
+    X(0x33, rla, IZY, izy_rmw)                                                 \
+    X(0x34, nop, ZPX, zpx_r)                                                   \
+    X(0x35, and, ZPX, zpx_r)                                                   \
+    X(0x36, rol, ZPX, zpx_rmw)                                                 \
+    X(0x37, rla, ZPX, zpx_rmw)                                                 \
+    X(0x38, sec, IMP, imp)                                                     \
+    X(0x39, and, ABY, aby_r)                                                   \
+    X(0x3A, nop, IMP, imp)                                                     \
+    X(0x3B, rla, ABY, aby_rmw)                                                 \
+    X(0x3C, nop, ABX, abx_r)                                                   \
+    X(0x3D, and, ABX, abx_r)                                                   \
+    X(0x3E, rol, ABX, abx_rmw)                                                 \
+    X(0x3F, rla, ABX, abx_rmw)                                                 \
+    /* -- 4x */                                                                \
+    X(0x40, nop, IMP, rti)                                                     \
+    X(0x41, eor, IZX, izx_r)                                                   \
+    X(0x42, kil, IMP, imp)                                                     \
+    X(0x43, sre, IZX, izx_rmw)                                                 \
+    X(0x44, nop, ZP0, zp_r)                                                    \
+    X(0x45, eor, ZP0, zp_r)                                                    \
+    X(0x46, lsr, ZP0, zp_rmw)                                                  \
+    X(0x47, sre, ZP0, zp_rmw)                                                  \
+    X(0x48, nop, IMP, pha)                                                     \
+    X(0x49, eor, IMM, imm)                                                     \
+    X(0x4A, lsr, ACC, acc)                                                     \
+    X(0x4B, alr, IMM, imm)                                                     \
+    X(0x4C, nop, ABS, abs_jmp)                                                 \
+    X(0x4D, eor, ABS, abs_r)                                                   \
+    X(0x4E, lsr, ABS, abs_rmw)                                                 \
+    X(0x4F, sre, ABS, abs_rmw)                                                 \
+    /* -- 5x */                                                                \
+    X(0x50, bvc, REL, rel)                                                     \
+    X(0x51, eor, IZY, izy_r)                                                   \
+    X(0x52, kil, IMP, imp)                                                     \
+    X(0x53, sre, IZY, izy_rmw)                                                 \
+    X(0x54, nop, ZPX, zpx_r)                                                   \
+    X(0x55, eor, ZPX, zpx_r)                                                   \
+    X(0x56, lsr, ZPX, zpx_rmw)                                                 \
+    X(0x57, sre, ZPX, zpx_rmw)                                                 \
+    X(0x58, cli, IMP, imp)                                                     \
+    X(0x59, eor, ABY, aby_r)                                                   \
+    X(0x5A, nop, IMP, imp)                                                     \
+    X(0x5B, sre, ABY, aby_rmw)                                                 \
+    X(0x5C, nop, ABX, abx_r)                                                   \
+    X(0x5D, eor, ABX, abx_r)                                                   \
+    X(0x5E, lsr, ABX, abx_rmw)                                                 \
+    X(0x5F, sre, ABX, abx_rmw)                                                 \
+    /* -- 6x */                                                                \
+    X(0x60, nop, IMP, rts)                                                     \
+    X(0x61, adc, IZX, izx_r)                                                   \
+    X(0x62, kil, IMP, imp)                                                     \
+    X(0x63, rra, IZX, izx_rmw)                                                 \
+    X(0x64, nop, ZP0, zp_r)                                                    \
+    X(0x65, adc, ZP0, zp_r)                                                    \
+    X(0x66, ror, ZP0, zp_rmw)                                                  \
+    X(0x67, rra, ZP0, zp_rmw)                                                  \
+    X(0x68, nop, IMP, pla)                                                     \
+    X(0x69, adc, IMM, imm)                                                     \
+    X(0x6A, ror, ACC, acc)                                                     \
+    X(0x6B, arr, IMM, imm)                                                     \
+    X(0x6C, nop, IND, ind_jmp)                                                 \
+    X(0x6D, adc, ABS, abs_r)                                                   \
+    X(0x6E, ror, ABS, abs_rmw)                                                 \
+    X(0x6F, rra, ABS, abs_rmw)                                                 \
+    /* -- 7x */                                                                \
+    X(0x70, bvs, REL, rel)                                                     \
+    X(0x71, adc, IZY, izy_r)                                                   \
+    X(0x72, kil, IMP, imp)                                                     \
+    X(0x73, rra, IZY, izy_rmw)                                                 \
+    X(0x74, nop, ZPX, zpx_r)                                                   \
+    X(0x75, adc, ZPX, zpx_r)                                                   \
+    X(0x76, ror, ZPX, zpx_rmw)                                                 \
+    X(0x77, rra, ZPX, zpx_rmw)                                                 \
+    X(0x78, sei, IMP, imp)                                                     \
+    X(0x79, adc, ABY, aby_r)                                                   \
+    X(0x7A, nop, IMP, imp)                                                     \
+    X(0x7B, rra, ABY, aby_rmw)                                                 \
+    X(0x7C, nop, ABX, abx_r)                                                   \
+    X(0x7D, adc, ABX, abx_r)                                                   \
+    X(0x7E, ror, ABX, abx_rmw)                                                 \
+    X(0x7F, rra, ABX, abx_rmw)                                                 \
+    /* -- 8x */                                                                \
+    X(0x80, nop, IMM, imm)                                                     \
+    X(0x81, sta, IZX, izx_w)                                                   \
+    X(0x82, nop, IMM, imm)                                                     \
+    X(0x83, sax, IZX, izx_w)                                                   \
+    X(0x84, sty, ZP0, zp_w)                                                    \
+    X(0x85, sta, ZP0, zp_w)                                                    \
+    X(0x86, stx, ZP0, zp_w)                                                    \
+    X(0x87, sax, ZP0, zp_w)                                                    \
+    X(0x88, dey, IMP, imp)                                                     \
+    X(0x89, nop, IMM, imm)                                                     \
+    X(0x8A, txa, IMP, imp)                                                     \
+    X(0x8B, xaa, IMM, imm)                                                     \
+    X(0x8C, sty, ABS, abs_w)                                                   \
+    X(0x8D, sta, ABS, abs_w)                                                   \
+    X(0x8E, stx, ABS, abs_w)                                                   \
+    X(0x8F, sax, ABS, abs_w)                                                   \
+    /* -- 9x */                                                                \
+    X(0x90, bcc, REL, rel)                                                     \
+    X(0x91, sta, IZY, izy_w)                                                   \
+    X(0x92, kil, IMP, imp)                                                     \
+    X(0x93, ahx, IZY, izy_w)                                                   \
+    X(0x94, sty, ZPX, zpx_w)                                                   \
+    X(0x95, sta, ZPX, zpx_w)                                                   \
+    X(0x96, stx, ZPY, zpy_w)                                                   \
+    X(0x97, sax, ZPY, zpy_w)                                                   \
+    X(0x98, tya, IMP, imp)                                                     \
+    X(0x99, sta, ABY, aby_w)                                                   \
+    X(0x9A, txs, IMP, imp)                                                     \
+    X(0x9B, tas, ABY, aby_w)                                                   \
+    X(0x9C, shy, ABX, abx_w)                                                   \
+    X(0x9D, sta, ABX, abx_w)                                                   \
+    X(0x9E, shx, ABY, aby_w)                                                   \
+    X(0x9F, ahx, ABY, aby_w)                                                   \
+    /* -- ax */                                                                \
+    X(0xA0, ldy, IMM, imm)                                                     \
+    X(0xA1, lda, IZX, izx_r)                                                   \
+    X(0xA2, ldx, IMM, imm)                                                     \
+    X(0xA3, lax, IZX, izx_r)                                                   \
+    X(0xA4, ldy, ZP0, zp_r)                                                    \
+    X(0xA5, lda, ZP0, zp_r)                                                    \
+    X(0xA6, ldx, ZP0, zp_r)                                                    \
+    X(0xA7, lax, ZP0, zp_r)                                                    \
+    X(0xA8, tay, IMP, imp)                                                     \
+    X(0xA9, lda, IMM, imm)                                                     \
+    X(0xAA, tax, IMP, imp)                                                     \
+    X(0xAB, lax, IMM, imm)                                                     \
+    X(0xAC, ldy, ABS, abs_r)                                                   \
+    X(0xAD, lda, ABS, abs_r)                                                   \
+    X(0xAE, ldx, ABS, abs_r)                                                   \
+    X(0xAF, lax, ABS, abs_r)                                                   \
+    /* -- bx */                                                                \
+    X(0xB0, bcs, REL, rel)                                                     \
+    X(0xB1, lda, IZY, izy_r)                                                   \
+    X(0xB2, kil, IMP, imp)                                                     \
+    X(0xB3, lax, IZY, izy_r)                                                   \
+    X(0xB4, ldy, ZPX, zpx_r)                                                   \
+    X(0xB5, lda, ZPX, zpx_r)                                                   \
+    X(0xB6, ldx, ZPY, zpy_r)                                                   \
+    X(0xB7, lax, ZPY, zpy_r)                                                   \
+    X(0xB8, clv, IMP, imp)                                                     \
+    X(0xB9, lda, ABY, aby_r)                                                   \
+    X(0xBA, tsx, IMP, imp)                                                     \
+    X(0xBB, las, ABY, aby_r)                                                   \
+    X(0xBC, ldy, ABX, abx_r)                                                   \
+    X(0xBD, lda, ABX, abx_r)                                                   \
+    X(0xBE, ldx, ABY, aby_r)                                                   \
+    X(0xBF, lax, ABY, aby_r)                                                   \
+    /* -- cx */                                                                \
+    X(0xC0, cpy, IMM, imm)                                                     \
+    X(0xC1, cmp, IZX, izx_r)                                                   \
+    X(0xC2, nop, IMM, imm)                                                     \
+    X(0xC3, dcp, IZX, izx_rmw)                                                 \
+    X(0xC4, cpy, ZP0, zp_r)                                                    \
+    X(0xC5, cmp, ZP0, zp_r)                                                    \
+    X(0xC6, dec, ZP0, zp_rmw)                                                  \
+    X(0xC7, dcp, ZP0, zp_rmw)                                                  \
+    X(0xC8, iny, IMP, imp)                                                     \
+    X(0xC9, cmp, IMM, imm)                                                     \
+    X(0xCA, dex, IMP, imp)                                                     \
+    X(0xCB, axs, IMM, imm)                                                     \
+    X(0xCC, cpy, ABS, abs_r)                                                   \
+    X(0xCD, cmp, ABS, abs_r)                                                   \
+    X(0xCE, dec, ABS, abs_rmw)                                                 \
+    X(0xCF, dcp, ABS, abs_rmw)                                                 \
+    /* -- dx */                                                                \
+    X(0xD0, bne, REL, rel)                                                     \
+    X(0xD1, cmp, IZY, izy_r)                                                   \
+    X(0xD2, kil, IMP, imp)                                                     \
+    X(0xD3, dcp, IZY, izy_rmw)                                                 \
+    X(0xD4, nop, ZPX, zpx_r)                                                   \
+    X(0xD5, cmp, ZPX, zpx_r)                                                   \
+    X(0xD6, dec, ZPX, zpx_rmw)                                                 \
+    X(0xD7, dcp, ZPX, zpx_rmw)                                                 \
+    X(0xD8, cld, IMP, imp)                                                     \
+    X(0xD9, cmp, ABY, aby_r)                                                   \
+    X(0xDA, nop, IMP, imp)                                                     \
+    X(0xDB, dcp, ABY, aby_rmw)                                                 \
+    X(0xDC, nop, ABX, abx_r)                                                   \
+    X(0xDD, cmp, ABX, abx_r)                                                   \
+    X(0xDE, dec, ABX, abx_rmw)                                                 \
+    X(0xDF, dcp, ABX, abx_rmw)                                                 \
+    /* -- ex */                                                                \
+    X(0xE0, cpx, IMM, imm)                                                     \
+    X(0xE1, sbc, IZX, izx_r)                                                   \
+    X(0xE2, nop, IMM, imm)                                                     \
+    X(0xE3, isc, IZX, izx_rmw)                                                 \
+    X(0xE4, cpx, ZP0, zp_r)                                                    \
+    X(0xE5, sbc, ZP0, zp_r)                                                    \
+    X(0xE6, inc, ZP0, zp_rmw)                                                  \
+    X(0xE7, isc, ZP0, zp_rmw)                                                  \
+    X(0xE8, inx, IMP, imp)                                                     \
+    X(0xE9, sbc, IMM, imm)                                                     \
+    X(0xEA, nop, IMP, imp)                                                     \
+    X(0xEB, sbc, IMM, imm)                                                     \
+    X(0xEC, cpx, ABS, abs_r)                                                   \
+    X(0xED, sbc, ABS, abs_r)                                                   \
+    X(0xEE, inc, ABS, abs_rmw)                                                 \
+    X(0xEF, isc, ABS, abs_rmw)                                                 \
+    /* -- fx */                                                                \
+    X(0xF0, beq, REL, rel)                                                     \
+    X(0xF1, sbc, IZY, izy_r)                                                   \
+    X(0xF2, kil, IMP, imp)                                                     \
+    X(0xF3, isc, IZY, izy_rmw)                                                 \
+    X(0xF4, nop, ZPX, zpx_r)                                                   \
+    X(0xF5, sbc, ZPX, zpx_r)                                                   \
+    X(0xF6, inc, ZPX, zpx_rmw)                                                 \
+    X(0xF7, isc, ZPX, zpx_rmw)                                                 \
+    X(0xF8, sed, IMP, imp)                                                     \
+    X(0xF9, sbc, ABY, aby_r)                                                   \
+    X(0xFA, nop, IMP, imp)                                                     \
+    X(0xFB, isc, ABY, aby_rmw)                                                 \
+    X(0xFC, nop, ABX, abx_r)                                                   \
+    X(0xFD, sbc, ABX, abx_r)                                                   \
+    X(0xFE, inc, ABX, abx_rmw)                                                 \
+    X(0xFF, isc, ABX, abx_rmw)
+/* clang-format on */
+
+// Write cycles of frames, bit i is set if cycle i (the one after the opcode
+// fetch is 0) writes memory. Must be in sync with the frames.
+#define NH_WR_brk 0x0E
+#define NH_WR_rti 0x00
+#define NH_WR_rts 0x00
+#define NH_WR_pha 0x02
+#define NH_WR_php 0x02
+#define NH_WR_pla 0x00
+#define NH_WR_plp 0x00
+#define NH_WR_jsr 0x0C
+#define NH_WR_imp 0x00
+#define NH_WR_acc 0x00
+#define NH_WR_imm 0x00
+#define NH_WR_rel 0x00
+#define NH_WR_ind_jmp 0x00
+#define NH_WR_abs_jmp 0x00
+#define NH_WR_abs_r 0x00
+#define NH_WR_abs_rmw 0x18
+#define NH_WR_abs_w 0x04
+#define NH_WR_abx_r 0x00
+#define NH_WR_abx_rmw 0x30
+#define NH_WR_abx_w 0x08
+#define NH_WR_aby_r 0x00
+#define NH_WR_aby_rmw 0x30
+#define NH_WR_aby_w 0x08
+#define NH_WR_zp_r 0x00
+#define NH_WR_zp_rmw 0x0C
+#define NH_WR_zp_w 0x02
+#define NH_WR_zpx_r 0x00
+#define NH_WR_zpx_rmw 0x18
+#define NH_WR_zpx_w 0x04
+#define NH_WR_zpy_r 0x00
+#define NH_WR_zpy_w 0x04
+#define NH_WR_izx_r 0x00
+#define NH_WR_izx_rmw 0x60
+#define NH_WR_izx_w 0x10
+#define NH_WR_izy_r 0x00
+#define NH_WR_izy_rmw 0x60
+#define NH_WR_izy_w 0x10
+
+#define NH_INSTR_DESC(i_opcode, i_core, i_addr_mode, i_frm)                    \
+    {AddrMode::i_addr_mode, NH_WR_##i_frm},
+#define NH_INSTR_CASE(i_opcode, i_core, i_addr_mode, i_frm)                    \
+    case i_opcode:                                                             \
+        InstrImpl::frm_##i_frm<InstrImpl::core_##i_core>(i_idx, this,          \
+                                                         io_done);             \
+        break;
 
 namespace nh {
 
-CPU::InstrDesc CPU::s_instr_table[256] = {
-    // http://www.oxyron.de/html/opcodes02.html
-    /* clang-format off */
-    // -- 0x
-    {CORE(nop), AddrMode::IMP, FRM(brk)},
-    {CORE(ora), AddrMode::IZX, FRM(izx_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(slo), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(nop), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(ora), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(asl), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(slo), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(nop), AddrMode::IMP, FRM(php)},
-    {CORE(ora), AddrMode::IMM, FRM(imm)},
-    {CORE(asl), AddrMode::ACC, FRM(acc)},
-    {CORE(anc), AddrMode::IMM, FRM(imm)},
-    {CORE(nop), AddrMode::ABS, FRM(abs_r)},
-    {CORE(ora), AddrMode::ABS, FRM(abs_r)},
-    {CORE(asl), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(slo), AddrMode::ABS, FRM(abs_rmw)},
-    // -- 1x
-    {CORE(bpl), AddrMode::REL, FRM(rel)},
-    {CORE(ora), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(slo), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(ora), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(asl), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(slo), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(clc), AddrMode::IMP, FRM(imp)},
-    {CORE(ora), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(slo), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(ora), AddrMode::ABX, FRM(abx_r)},
-    {CORE(asl), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(slo), AddrMode::ABX, FRM(abx_rmw)},
-    // -- 2x
-    {CORE(nop), AddrMode::ABS, FRM(jsr)},
-    {CORE(and), AddrMode::IZX, FRM(izx_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(rla), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(bit), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(and), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(rol), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(rla), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(nop), AddrMode::IMP, FRM(plp)},
-    {CORE(and), AddrMode::IMM, FRM(imm)},
-    {CORE(rol), AddrMode::ACC, FRM(acc)},
-    {CORE(anc), AddrMode::IMM, FRM(imm)},
-    {CORE(bit), AddrMode::ABS, FRM(abs_r)},
-    {CORE(and), AddrMode::ABS, FRM(abs_r)},
-    {CORE(rol), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(rla), AddrMode::ABS, FRM(abs_rmw)},
-    // -- 3x
-    {CORE(bmi), AddrMode::REL, FRM(rel)},
-    {CORE(and), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(rla), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(and), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(rol), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(rla), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(sec), AddrMode::IMP, FRM(imp)},
-    {CORE(and), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(rla), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(and), AddrMode::ABX, FRM(abx_r)},
-    {CORE(rol), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(rla), AddrMode::ABX, FRM(abx_rmw)},
-    // -- 4x
-    {CORE(nop), AddrMode::IMP, FRM(rti)},
-    {CORE(eor), AddrMode::IZX, FRM(izx_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(sre), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(nop), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(eor), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(lsr), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(sre), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(nop), AddrMode::IMP, FRM(pha)},
-    {CORE(eor), AddrMode::IMM, FRM(imm)},
-    {CORE(lsr), AddrMode::ACC, FRM(acc)},
-    {CORE(alr), AddrMode::IMM, FRM(imm)},
-    {CORE(nop), AddrMode::ABS, FRM(abs_jmp)},
-    {CORE(eor), AddrMode::ABS, FRM(abs_r)},
-    {CORE(lsr), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(sre), AddrMode::ABS, FRM(abs_rmw)},
-    // -- 5x
-    {CORE(bvc), AddrMode::REL, FRM(rel)},
-    {CORE(eor), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(sre), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(eor), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(lsr), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(sre), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(cli), AddrMode::IMP, FRM(imp)},
-    {CORE(eor), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(sre), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(eor), AddrMode::ABX, FRM(abx_r)},
-    {CORE(lsr), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(sre), AddrMode::ABX, FRM(abx_rmw)},
-    // -- 6x
-    {CORE(nop), AddrMode::IMP, FRM(rts)},
-    {CORE(adc), AddrMode::IZX, FRM(izx_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(rra), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(nop), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(adc), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(ror), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(rra), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(nop), AddrMode::IMP, FRM(pla)},
-    {CORE(adc), AddrMode::IMM, FRM(imm)},
-    {CORE(ror), AddrMode::ACC, FRM(acc)},
-    {CORE(arr), AddrMode::IMM, FRM(imm)},
-    {CORE(nop), AddrMode::IND, FRM(ind_jmp)},
-    {CORE(adc), AddrMode::ABS, FRM(abs_r)},
-    {CORE(ror), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(rra), AddrMode::ABS, FRM(abs_rmw)},
-    // -- 7x
-    {CORE(bvs), AddrMode::REL, FRM(rel)},
-    {CORE(adc), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(rra), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(adc), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(ror), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(rra), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(sei), AddrMode::IMP, FRM(imp)},
-    {CORE(adc), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(rra), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(adc), AddrMode::ABX, FRM(abx_r)},
-    {CORE(ror), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(rra), AddrMode::ABX, FRM(abx_rmw)},
-    // -- 8x
-    {CORE(nop), AddrMode::IMM, FRM(imm)},
-    {CORE(sta), AddrMode::IZX, FRM(izx_w)},
-    {CORE(nop), AddrMode::IMM, FRM(imm)},
-    {CORE(sax), AddrMode::IZX, FRM(izx_w)},
-    {CORE(sty), AddrMode::ZP0, FRM(zp_w)},
-    {CORE(sta), AddrMode::ZP0, FRM(zp_w)},
-    {CORE(stx), AddrMode::ZP0, FRM(zp_w)},
-    {CORE(sax), AddrMode::ZP0, FRM(zp_w)},
-    {CORE(dey), AddrMode::IMP, FRM(imp)},
-    {CORE(nop), AddrMode::IMM, FRM(imm)},
-    {CORE(txa), AddrMode::IMP, FRM(imp)},
-    {CORE(xaa), AddrMode::IMM, FRM(imm)},
-    {CORE(sty), AddrMode::ABS, FRM(abs_w)},
-    {CORE(sta), AddrMode::ABS, FRM(abs_w)},
-    {CORE(stx), AddrMode::ABS, FRM(abs_w)},
-    {CORE(sax), AddrMode::ABS, FRM(abs_w)},
-    // -- 9x
-    {CORE(bcc), AddrMode::REL, FRM(rel)},
-    {CORE(sta), AddrMode::IZY, FRM(izy_w)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(ahx), AddrMode::IZY, FRM(izy_w)},
-    {CORE(sty), AddrMode::ZPX, FRM(zpx_w)},
-    {CORE(sta), AddrMode::ZPX, FRM(zpx_w)},
-    {CORE(stx), AddrMode::ZPY, FRM(zpy_w)},
-    {CORE(sax), AddrMode::ZPY, FRM(zpy_w)},
-    {CORE(tya), AddrMode::IMP, FRM(imp)},
-    {CORE(sta), AddrMode::ABY, FRM(aby_w)},
-    {CORE(txs), AddrMode::IMP, FRM(imp)},
-    {CORE(tas), AddrMode::ABY, FRM(aby_w)},
-    {CORE(shy), AddrMode::ABX, FRM(abx_w)},
-    {CORE(sta), AddrMode::ABX, FRM(abx_w)},
-    {CORE(shx), AddrMode::ABY, FRM(aby_w)},
-    {CORE(ahx), AddrMode::ABY, FRM(aby_w)},
-    // -- Ax
-    {CORE(ldy), AddrMode::IMM, FRM(imm)},
-    {CORE(lda), AddrMode::IZX, FRM(izx_r)},
-    {CORE(ldx), AddrMode::IMM, FRM(imm)},
-    {CORE(lax), AddrMode::IZX, FRM(izx_r)},
-    {CORE(ldy), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(lda), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(ldx), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(lax), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(tay), AddrMode::IMP, FRM(imp)},
-    {CORE(lda), AddrMode::IMM, FRM(imm)},
-    {CORE(tax), AddrMode::IMP, FRM(imp)},
-    {CORE(lax), AddrMode::IMM, FRM(imm)},
-    {CORE(ldy), AddrMode::ABS, FRM(abs_r)},
-    {CORE(lda), AddrMode::ABS, FRM(abs_r)},
-    {CORE(ldx), AddrMode::ABS, FRM(abs_r)},
-    {CORE(lax), AddrMode::ABS, FRM(abs_r)},
-    // -- Bx
-    {CORE(bcs), AddrMode::REL, FRM(rel)},
-    {CORE(lda), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(lax), AddrMode::IZY, FRM(izy_r)},
-    {CORE(ldy), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(lda), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(ldx), AddrMode::ZPY, FRM(zpy_r)},
-    {CORE(lax), AddrMode::ZPY, FRM(zpy_r)},
-    {CORE(clv), AddrMode::IMP, FRM(imp)},
-    {CORE(lda), AddrMode::ABY, FRM(aby_r)},
-    {CORE(tsx), AddrMode::IMP, FRM(imp)},
-    {CORE(las), AddrMode::ABY, FRM(aby_r)},
-    {CORE(ldy), AddrMode::ABX, FRM(abx_r)},
-    {CORE(lda), AddrMode::ABX, FRM(abx_r)},
-    {CORE(ldx), AddrMode::ABY, FRM(aby_r)},
-    {CORE(lax), AddrMode::ABY, FRM(aby_r)},
-    // -- Cx
-    {CORE(cpy), AddrMode::IMM, FRM(imm)},
-    {CORE(cmp), AddrMode::IZX, FRM(izx_r)},
-    {CORE(nop), AddrMode::IMM, FRM(imm)},
-    {CORE(dcp), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(cpy), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(cmp), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(dec), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(dcp), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(iny), AddrMode::IMP, FRM(imp)},
-    {CORE(cmp), AddrMode::IMM, FRM(imm)},
-    {CORE(dex), AddrMode::IMP, FRM(imp)},
-    {CORE(axs), AddrMode::IMM, FRM(imm)},
-    {CORE(cpy), AddrMode::ABS, FRM(abs_r)},
-    {CORE(cmp), AddrMode::ABS, FRM(abs_r)},
-    {CORE(dec), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(dcp), AddrMode::ABS, FRM(abs_rmw)},
-    // -- Dx
-    {CORE(bne), AddrMode::REL, FRM(rel)},
-    {CORE(cmp), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(dcp), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(cmp), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(dec), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(dcp), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(cld), AddrMode::IMP, FRM(imp)},
-    {CORE(cmp), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(dcp), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(cmp), AddrMode::ABX, FRM(abx_r)},
-    {CORE(dec), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(dcp), AddrMode::ABX, FRM(abx_rmw)},
-    // -- Ex
-    {CORE(cpx), AddrMode::IMM, FRM(imm)},
-    {CORE(sbc), AddrMode::IZX, FRM(izx_r)},
-    {CORE(nop), AddrMode::IMM, FRM(imm)},
-    {CORE(isc), AddrMode::IZX, FRM(izx_rmw)},
-    {CORE(cpx), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(sbc), AddrMode::ZP0, FRM(zp_r)},
-    {CORE(inc), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(isc), AddrMode::ZP0, FRM(zp_rmw)},
-    {CORE(inx), AddrMode::IMP, FRM(imp)},
-    {CORE(sbc), AddrMode::IMM, FRM(imm)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(sbc), AddrMode::IMM, FRM(imm)},
-    {CORE(cpx), AddrMode::ABS, FRM(abs_r)},
-    {CORE(sbc), AddrMode::ABS, FRM(abs_r)},
-    {CORE(inc), AddrMode::ABS, FRM(abs_rmw)},
-    {CORE(isc), AddrMode::ABS, FRM(abs_rmw)},
-    // -- Fx
-    {CORE(beq), AddrMode::REL, FRM(rel)},
-    {CORE(sbc), AddrMode::IZY, FRM(izy_r)},
-    {CORE(kil), AddrMode::IMP, FRM(imp)},
-    {CORE(isc), AddrMode::IZY, FRM(izy_rmw)},
-    {CORE(nop), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(sbc), AddrMode::ZPX, FRM(zpx_r)},
-    {CORE(inc), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(isc), AddrMode::ZPX, FRM(zpx_rmw)},
-    {CORE(sed), AddrMode::IMP, FRM(imp)},
-    {CORE(sbc), AddrMode::ABY, FRM(aby_r)},
-    {CORE(nop), AddrMode::IMP, FRM(imp)},
-    {CORE(isc), AddrMode::ABY, FRM(aby_rmw)},
-    {CORE(nop), AddrMode::ABX, FRM(abx_r)},
-    {CORE(sbc), AddrMode::ABX, FRM(abx_r)},
-    {CORE(inc), AddrMode::ABX, FRM(abx_rmw)},
-    {CORE(isc), AddrMode::ABX, FRM(abx_rmw)},
-    /* clang-format on */
+const CPU::InstrDesc CPU::s_instr_table[256] = {
+    NH_INSTR_TABLE(NH_INSTR_DESC)
 };
 
+void
+CPU::exec_instr(Byte i_opcode, int i_idx, bool &io_done)
+{
+    // One switch over all opcodes, each case runs the frame specialized with
+    // its core, instead of calling through the frame and core pointers.
+    switch (i_opcode)
+    {
+        NH_INSTR_TABLE(NH_INSTR_CASE)
+
+        default:
+            break;
+    }
+}
+
 } // namespace nh
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
 
 #include "nesish/nesish.h"
@@ -23,6 +24,36 @@ struct MappableMemory {
     void
     unset_mapping(EMappingPoint i_point);
 
+    /// @brief Rebuild the page table of [i_begin, i_end] from current decoding
+    /// results. Call this whenever the decoding of a mapping changes without
+    /// set_mapping(), e.g. on bank switching or mirroring changes, with the
+    /// range the change affects.
+    void
+    update_pages(Address i_begin, Address i_end);
+
+    /// @return Bytes of the page containing i_addr, or nullptr if the page is
+    /// not directly readable.
+    const Byte *
+    get_read_page(Address i_addr) const;
+
+    /// @return One bit for each of "i_pages" (at most 64) pages from the one
+    /// containing "i_begin", set if written through set_byte() since
+    /// clear_dirty().
+    std::uint64_t
+    get_dirty(Address i_begin, std::size_t i_pages) const;
+    void
+    clear_dirty();
+    /// @brief Flag all pages, for writes bypassing set_byte(), e.g. loading a
+    /// state.
+    void
+    set_dirty();
+
+  public:
+    static constexpr std::size_t PAGE_BITS = 8;
+    static constexpr std::size_t PAGE_SIZE = std::size_t(1) << PAGE_BITS;
+    static constexpr std::size_t PAGE_MASK = PAGE_SIZE - 1;
+    static constexpr std::size_t PAGE_COUNT = AddressableSize >> PAGE_BITS;
+
   protected:
     NHErr
     decode_addr(Address i_addr, Byte *&o_addr) const;
@@ -45,6 +76,9 @@ struct MappableMemory {
     decode_addr_impl(const EntryKeyValue &i_entry_kv, Address i_addr,
                      Byte *&o_addr) const;
 
+    void
+    update_page_points(Address i_begin, Address i_end);
+
   private:
     EMappingPoint m_mapping_registry[AddressableSize];
     struct EntryElement {
@@ -60,6 +94,19 @@ struct MappableMemory {
         typename std::underlying_type<EMappingPoint>::type MappingPointIndex_t;
     EntryElement m_mapping_entries[MappingPointIndex_t(EMappingPoint::SIZE)];
 
+    // ---- Page table
+    // Fast path for pages decoded by one mapping entry to contiguous bytes,
+    // i.e. RAM and ROM. nullptr if the page needs the mapping entry, e.g. I/O
+    // registers, read-only or unmapped.
+    Byte *m_read_pages[PAGE_COUNT];
+    Byte *m_write_pages[PAGE_COUNT];
+    // The mapping point covering a whole page, INVALID if there isn't one.
+    EMappingPoint m_page_points[PAGE_COUNT];
+
+    // ---- Written pages, one bit each
+    static constexpr std::size_t DIRTY_WORDS = (PAGE_COUNT + 63) / 64;
+    std::uint64_t m_dirty[DIRTY_WORDS];
+
   protected:
     NHLogger *m_logger;
 };
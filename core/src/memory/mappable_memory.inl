@@ -11,14 +11,33 @@
 
 namespace nh {
 
+template <typename EMappingPoint, std::size_t AddressableSize>
+constexpr std::size_t MappableMemory<EMappingPoint, AddressableSize>::PAGE_BITS;
+template <typename EMappingPoint, std::size_t AddressableSize>
+constexpr std::size_t MappableMemory<EMappingPoint, AddressableSize>::PAGE_SIZE;
+template <typename EMappingPoint, std::size_t AddressableSize>
+constexpr std::size_t MappableMemory<EMappingPoint, AddressableSize>::PAGE_MASK;
+template <typename EMappingPoint, std::size_t AddressableSize>
+constexpr std::size_t
+    MappableMemory<EMappingPoint, AddressableSize>::PAGE_COUNT;
+template <typename EMappingPoint, std::size_t AddressableSize>
+constexpr std::size_t
+    MappableMemory<EMappingPoint, AddressableSize>::DIRTY_WORDS;
+
 template <typename EMappingPoint, std::size_t AddressableSize>
 MappableMemory<EMappingPoint, AddressableSize>::MappableMemory(
     NHLogger *i_logger)
     : m_mapping_registry{}
+    , m_read_pages{}
+    , m_write_pages{}
+    , m_page_points{}
+    , m_dirty{}
     , m_logger(i_logger)
 {
     static_assert(std::numeric_limits<Address>::max() + 1 >= AddressableSize,
                   "AddressableSize too large");
+    static_assert(AddressableSize % PAGE_SIZE == 0,
+                  "AddressableSize must be multiple of page size");
 
     static_assert(std::is_enum<EMappingPoint>::value,
                   "\"EMappingPoint\" must be enum type");
@@ -37,6 +56,13 @@ NHErr
 MappableMemory<EMappingPoint, AddressableSize>::get_byte(Address i_addr,
                                                          Byte &o_val) const
 {
+    const Byte *page = m_read_pages[i_addr >> PAGE_BITS];
+    if (page)
+    {
+        o_val = page[i_addr & PAGE_MASK];
+        return NH_ERR_OK;
+    }
+
     auto entry_kv = get_entry_kv(i_addr);
     const auto &entry = entry_kv.v;
     if (!entry)
@@ -73,6 +99,17 @@ NHErr
 MappableMemory<EMappingPoint, AddressableSize>::set_byte(Address i_addr,
                                                          Byte i_val)
 {
+    // Flagged even if the write is ignored, it's only a hint to skip pages.
+    std::size_t page_no = i_addr >> PAGE_BITS;
+    m_dirty[page_no >> 6] |= std::uint64_t(1) << (page_no & 63);
+
+    Byte *page = m_write_pages[page_no];
+    if (page)
+    {
+        page[i_addr & PAGE_MASK] = i_val;
+        return NH_ERR_OK;
+    }
+
     auto entry_kv = get_entry_kv(i_addr);
     const auto &entry = entry_kv.v;
     if (!entry)
@@ -145,6 +182,9 @@ MappableMemory<EMappingPoint, AddressableSize>::set_mapping(
     unsigned long address_count = (i_entry.end - i_entry.begin + 1);
     std::fill_n(std::begin(m_mapping_registry) + i_entry.begin, address_count,
                 i_point);
+
+    update_page_points(i_entry.begin, i_entry.end);
+    update_pages(i_entry.begin, i_entry.end);
 }
 
 template <typename EMappingPoint, std::size_t AddressableSize>
@@ -168,6 +208,115 @@ MappableMemory<EMappingPoint, AddressableSize>::unset_mapping(
                 address_count * sizeof(EMappingPoint));
 
     m_mapping_entries[entry_idx].valid = false;
+
+    update_page_points(entry.begin, entry.end);
+    update_pages(entry.begin, entry.end);
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+const Byte *
+MappableMemory<EMappingPoint, AddressableSize>::get_read_page(
+    Address i_addr) const
+{
+    return m_read_pages[i_addr >> PAGE_BITS];
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+std::uint64_t
+MappableMemory<EMappingPoint, AddressableSize>::get_dirty(
+    Address i_begin, std::size_t i_pages) const
+{
+    std::uint64_t dirty = 0;
+    std::size_t first = i_begin >> PAGE_BITS;
+    for (std::size_t i = 0; i < i_pages && i < 64 && first + i < PAGE_COUNT;
+         ++i)
+    {
+        std::size_t page_no = first + i;
+        if ((m_dirty[page_no >> 6] >> (page_no & 63)) & 1)
+        {
+            dirty |= std::uint64_t(1) << i;
+        }
+    }
+    return dirty;
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+void
+MappableMemory<EMappingPoint, AddressableSize>::clear_dirty()
+{
+    std::fill_n(m_dirty, DIRTY_WORDS, std::uint64_t(0));
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+void
+MappableMemory<EMappingPoint, AddressableSize>::set_dirty()
+{
+    std::fill_n(m_dirty, DIRTY_WORDS, ~std::uint64_t(0));
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+void
+MappableMemory<EMappingPoint, AddressableSize>::update_page_points(
+    Address i_begin, Address i_end)
+{
+    for (std::size_t page = i_begin >> PAGE_BITS; page <= (i_end >> PAGE_BITS);
+         ++page)
+    {
+        const EMappingPoint *first = m_mapping_registry + (page << PAGE_BITS);
+        const EMappingPoint *last = first + PAGE_SIZE;
+        bool whole = std::find_if(first, last, [first](EMappingPoint i_mp) {
+                         return i_mp != *first;
+                     }) == last;
+        m_page_points[page] = whole ? *first : EMappingPoint::INVALID;
+    }
+}
+
+template <typename EMappingPoint, std::size_t AddressableSize>
+void
+MappableMemory<EMappingPoint, AddressableSize>::update_pages(Address i_begin,
+                                                             Address i_end)
+{
+    for (std::size_t page = i_begin >> PAGE_BITS; page <= (i_end >> PAGE_BITS);
+         ++page)
+    {
+        m_read_pages[page] = nullptr;
+        m_write_pages[page] = nullptr;
+
+        EMappingPoint mp = m_page_points[page];
+        if (mp == EMappingPoint::INVALID)
+        {
+            continue;
+        }
+        const EntryElement &element =
+            m_mapping_entries[MappingPointIndex_t(mp)];
+        if (!element.valid || !element.entry.decode)
+        {
+            continue;
+        }
+        const MappingEntry *entry = &element.entry;
+
+        // Only pages decoded to contiguous bytes can be accessed directly,
+        // e.g. palette mirroring within a page is excluded by this.
+        Address first_addr = Address(page << PAGE_BITS);
+        Address last_addr = Address(first_addr + PAGE_MASK);
+        Byte *first = nullptr;
+        Byte *last = nullptr;
+        if (NH_FAILED(entry->decode(entry, first_addr, first)) ||
+            NH_FAILED(entry->decode(entry, last_addr, last)) || !first ||
+            last != first + PAGE_MASK)
+        {
+            continue;
+        }
+
+        if (!entry->get_byte)
+        {
+            m_read_pages[page] = first;
+        }
+        if (!entry->set_byte && !entry->readonly)
+        {
+            m_write_pages[page] = first;
+        }
+    }
 }
 
 template <typename EMappingPoint, std::size_t AddressableSize>
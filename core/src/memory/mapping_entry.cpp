@@ -32,4 +32,12 @@ MappingEntry::MappingEntry(Address i_begin, Address i_end, bool i_readonly,
 {
 }
 
+MappingEntry::MappingEntry(Address i_begin, Address i_end, bool i_readonly,
+                           MappingDecodeFunc i_decode,
+                           MappingSetByteFunc i_set_byte, void *i_opaque)
+    : MappingEntry(i_begin, i_end, i_readonly, i_decode, nullptr, i_set_byte,
+                   i_opaque)
+{
+}
+
 } // namespace nh
@@ -27,6 +27,11 @@ struct MappingEntry {
     MappingEntry(Address i_begin, Address i_end, bool i_readonly,
                  MappingGetByteFunc i_get_byte, MappingSetByteFunc i_set_byte,
                  void *i_opaque);
+    /// @brief Reads are decoded, writes are handled by "i_set_byte", e.g. for
+    /// ROM with registers mapped to the same range.
+    MappingEntry(Address i_begin, Address i_end, bool i_readonly,
+                 MappingDecodeFunc i_decode, MappingSetByteFunc i_set_byte,
+                 void *i_opaque);
 
     NB_KLZ_DEFAULT_COPY(MappingEntry); // trivially copyable
 
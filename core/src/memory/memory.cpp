@@ -1,5 +1,7 @@
 #include "memory.hpp"
 
+#include "state_io.hpp"
+
 #include <cstring>
 
 #define BASE MappableMemory<MemoryMappingPoint, NH_ADDRESSABLE_SIZE>
@@ -52,6 +54,12 @@ Memory::get_byte(Address i_addr, Byte &o_val) const
     return err;
 }
 
+const Byte *
+Memory::get_ram() const
+{
+    return m_ram;
+}
+
 Byte
 Memory::get_latch() const
 {
@@ -83,4 +91,22 @@ Memory::set_bulk(Address i_begin, Address i_end, Byte i_byte)
     return NH_ERR_INVALID_ARGUMENT;
 }
 
+void
+Memory::serialize(StateIO &io_state)
+{
+    static_assert(StateIO::PAGE_SIZE == PAGE_SIZE, "Pages differ");
+    constexpr std::size_t ram_pages = NH_INTERNAL_RAM_SIZE / PAGE_SIZE;
+    constexpr std::size_t mirrors =
+        (NH_RAM_ADDR_TAIL + 1 - NH_RAM_ADDR_HEAD) / NH_INTERNAL_RAM_SIZE;
+    // Writes are flagged at the mirror they go through.
+    std::uint64_t written = get_dirty(NH_RAM_ADDR_HEAD, ram_pages * mirrors);
+    std::uint64_t dirty = 0;
+    for (std::size_t i = 0; i < mirrors; ++i)
+    {
+        dirty |= written >> (i * ram_pages);
+    }
+    io_state.pages(m_ram, sizeof(m_ram), dirty);
+    io_state.field(m_read_latch);
+}
+
 } // namespace nh
@@ -7,6 +7,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 // Enumerators must be unique and are valid array index
 enum class MemoryMappingPoint : unsigned char {
     INVALID = 0,
@@ -39,6 +41,10 @@ struct Memory : public MappableMemory<MemoryMappingPoint, NH_ADDRESSABLE_SIZE> {
     NHErr
     get_byte(Address i_addr, Byte &o_val) const;
 
+    /// @return The internal RAM, without the side effects of get_byte().
+    const Byte *
+    get_ram() const;
+
     Byte
     get_latch() const;
     void
@@ -48,6 +54,10 @@ struct Memory : public MappableMemory<MemoryMappingPoint, NH_ADDRESSABLE_SIZE> {
     NHErr
     set_bulk(Address i_begin, Address i_end, Byte i_byte);
 
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     // ---- Memory Map
     // https://wiki.nesdev.org/w/index.php?title=CPU_memory_map
@@ -1,5 +1,7 @@
 #include "video_memory.hpp"
 
+#include "state_io.hpp"
+
 #define BASE MappableMemory<VideoMemoryMappingPoint, NH_ADDRESSABLE_SIZE>
 
 namespace nh {
@@ -164,4 +166,29 @@ VideoMemory::get_palette_byte(int i_idx)
     return m_palette[i_idx];
 }
 
+std::uint64_t
+VideoMemory::get_dirty(Address i_begin, std::size_t i_pages) const
+{
+    std::uint64_t dirty = 0;
+    for (std::size_t addr = i_begin & NH_PPU_ADDR_MASK;
+         addr < NH_ADDRESSABLE_SIZE; addr += NH_PPU_ADDRESSABLE_SIZE)
+    {
+        dirty |= BASE::get_dirty(Address(addr), i_pages);
+    }
+    return dirty;
+}
+
+void
+VideoMemory::serialize(StateIO &io_state)
+{
+    static_assert(StateIO::PAGE_SIZE == PAGE_SIZE, "Pages differ");
+    // Which nametable a page goes to depends on mirroring, so a write to any
+    // flags both.
+    bool written =
+        get_dirty(NH_NT_ADDR_HEAD,
+                  (NH_NT_MIRROR_ADDR_TAIL + 1 - NH_NT_ADDR_HEAD) / PAGE_SIZE);
+    io_state.pages(m_ram, sizeof(m_ram), written ? ~std::uint64_t(0) : 0);
+    io_state.bytes(m_palette, sizeof(m_palette));
+}
+
 } // namespace nh
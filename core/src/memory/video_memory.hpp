@@ -9,6 +9,8 @@
 
 namespace nh {
 
+struct StateIO;
+
 // Enumerators must be unique and are valid array index
 enum class VideoMemoryMappingPoint : unsigned char {
     INVALID = 0,
@@ -52,6 +54,14 @@ struct VideoMemory
     Byte
     get_palette_byte(int i_idx);
 
+    /// @brief Writes above NH_PPU_ADDR_MASK are folded into what they mirror.
+    std::uint64_t
+    get_dirty(Address i_begin, std::size_t i_pages) const;
+
+  public:
+    void
+    serialize(StateIO &io_state);
+
   private:
     // https://www.nesdev.org/wiki/PPU_memory_map
     Byte m_ram[NH_PPU_INTERNAL_RAM_SIZE];
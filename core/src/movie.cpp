@@ -0,0 +1,269 @@
+#include "movie.hpp"
+
+#include "nhbase/filesystem.hpp"
+#include "nhbase/vc_intrinsics.hpp"
+#include "console.hpp"
+#include "log.hpp"
+
+#include <cstdio>
+
+namespace nh {
+
+/* Format, little-endian:
+ * u32 magic, u32 version, u32 ROM hash, u32 frames,
+ * then runs of the same frame: {u16 length, u8 events, u8 P1, u8 P2} ...
+ */
+
+// "NHMV" in little-endian
+static constexpr std::uint32_t MOVIE_MAGIC = 0x564D484E;
+static constexpr std::uint32_t MOVIE_VERSION = 1;
+static constexpr std::size_t MOVIE_HEADER_SIZE = 16;
+static constexpr std::size_t MOVIE_RUN_SIZE = 5;
+static constexpr std::size_t MOVIE_MAX_RUN = 0xFFFF;
+
+static void
+pv_put(std::vector<Byte> &io_buf, std::uint32_t i_val, int i_bytes);
+static std::uint32_t
+pv_get(const Byte *i_buf, int i_bytes);
+
+Movie::Movie(NHLogger *i_logger)
+    : m_rom_hash(0)
+    , m_logger(i_logger)
+{
+}
+
+NHErr
+Movie::load(const std::string &i_path, NHLogger *i_logger, Movie **o_movie)
+{
+    if (!nb::file_exists(i_path))
+    {
+        NH_LOG_ERROR(i_logger, "Invalid movie path: \"{}\"", i_path);
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    NB_VC_WARNING_PUSH
+    NB_VC_WARNING_DISABLE(4996)
+    std::FILE *fp = std::fopen(i_path.c_str(), "rb");
+    NB_VC_WARNING_POP
+    if (!fp)
+    {
+        NH_LOG_ERROR(i_logger, "File opening failed!");
+        return NH_ERR_UNAVAILABLE;
+    }
+    std::vector<Byte> buf;
+    Byte chunk[4096];
+    std::size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), fp)) > 0)
+    {
+        buf.insert(buf.end(), chunk, chunk + got);
+    }
+    std::fclose(fp);
+
+    if (buf.size() < MOVIE_HEADER_SIZE ||
+        pv_get(&buf[0], 4) != MOVIE_MAGIC ||
+        pv_get(&buf[4], 4) != MOVIE_VERSION)
+    {
+        NH_LOG_ERROR(i_logger, "Not a movie of version {}", MOVIE_VERSION);
+        return NH_ERR_CORRUPTED;
+    }
+
+    // Don't trust the count for more than the runs there can cover.
+    std::size_t frames = pv_get(&buf[12], 4);
+    if (frames > (buf.size() - MOVIE_HEADER_SIZE) / MOVIE_RUN_SIZE *
+                     MOVIE_MAX_RUN)
+    {
+        NH_LOG_ERROR(i_logger, "Movie truncated or corrupted");
+        return NH_ERR_CORRUPTED;
+    }
+
+    Movie *movie = new Movie(i_logger);
+    movie->m_rom_hash = pv_get(&buf[8], 4);
+    movie->m_frames.reserve(frames);
+    std::size_t pos = MOVIE_HEADER_SIZE;
+    while (pos + MOVIE_RUN_SIZE <= buf.size())
+    {
+        std::size_t length = pv_get(&buf[pos], 2);
+        Frame frame{{buf[pos + 3], buf[pos + 4]}, buf[pos + 2]};
+        if (!length || movie->m_frames.size() + length > frames)
+        {
+            break;
+        }
+        movie->m_frames.insert(movie->m_frames.end(), length, frame);
+        pos += MOVIE_RUN_SIZE;
+    }
+    if (pos != buf.size() || movie->m_frames.size() != frames)
+    {
+        NH_LOG_ERROR(i_logger, "Movie truncated or corrupted");
+        delete movie;
+        return NH_ERR_CORRUPTED;
+    }
+
+    *o_movie = movie;
+    return NH_ERR_OK;
+}
+
+NHErr
+Movie::save(const std::string &i_path) const
+{
+    std::vector<Byte> buf;
+    pv_put(buf, MOVIE_MAGIC, 4);
+    pv_put(buf, MOVIE_VERSION, 4);
+    pv_put(buf, m_rom_hash, 4);
+    pv_put(buf, std::uint32_t(m_frames.size()), 4);
+    for (std::size_t i = 0; i < m_frames.size();)
+    {
+        const Frame &frame = m_frames[i];
+        std::size_t length = 1;
+        while (i + length < m_frames.size() && length < MOVIE_MAX_RUN &&
+               m_frames[i + length].events == frame.events &&
+               m_frames[i + length].buttons[0] == frame.buttons[0] &&
+               m_frames[i + length].buttons[1] == frame.buttons[1])
+        {
+            ++length;
+        }
+        pv_put(buf, std::uint32_t(length), 2);
+        pv_put(buf, frame.events, 1);
+        pv_put(buf, frame.buttons[0], 1);
+        pv_put(buf, frame.buttons[1], 1);
+        i += length;
+    }
+
+    NB_VC_WARNING_PUSH
+    NB_VC_WARNING_DISABLE(4996)
+    std::FILE *fp = std::fopen(i_path.c_str(), "wb");
+    NB_VC_WARNING_POP
+    if (!fp)
+    {
+        NH_LOG_ERROR(m_logger, "File opening failed!");
+        return NH_ERR_UNAVAILABLE;
+    }
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+    ok = !std::fclose(fp) && ok;
+    if (!ok)
+    {
+        NH_LOG_ERROR(m_logger, "Movie writing failed: \"{}\"", i_path);
+        return NH_ERR_UNAVAILABLE;
+    }
+    return NH_ERR_OK;
+}
+
+std::size_t
+Movie::frames() const
+{
+    return m_frames.size();
+}
+
+std::uint32_t
+Movie::rom_hash() const
+{
+    return m_rom_hash;
+}
+
+std::uint32_t
+Movie::hash(std::size_t i_frames) const
+{
+    // FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < i_frames && i < m_frames.size(); ++i)
+    {
+        const Byte bytes[] = {m_frames[i].events, m_frames[i].buttons[0],
+                              m_frames[i].buttons[1]};
+        for (Byte b : bytes)
+        {
+            hash = (hash ^ b) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+NHErr
+Movie::record(Console &io_console, Byte i_p1, Byte i_p2,
+              NHMovieEvent i_events)
+{
+    if (m_frames.empty())
+    {
+        if (!io_console.rom_hash())
+        {
+            NH_LOG_ERROR(m_logger, "Record without cartridge inserted");
+            return NH_ERR_UNINITIALIZED;
+        }
+        m_rom_hash = io_console.rom_hash();
+        // So that playback starts from the same state.
+        i_events |= NH_MOVIE_EVENT_POWER;
+    }
+    else if (io_console.rom_hash() != m_rom_hash)
+    {
+        NH_LOG_ERROR(m_logger, "Record with another cartridge");
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    // Only what's played back, for the file to be read by later versions.
+    i_events &= NH_MOVIE_EVENT_POWER | NH_MOVIE_EVENT_RESET;
+
+    Frame frame{{i_p1, i_p2}, Byte(i_events)};
+    NHErr err = play(io_console, frame);
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    m_frames.push_back(frame);
+    return NH_ERR_OK;
+}
+
+NHErr
+Movie::play(Console &io_console, std::size_t i_frame) const
+{
+    if (i_frame >= m_frames.size())
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    if (io_console.rom_hash() != m_rom_hash)
+    {
+        NH_LOG_ERROR(m_logger, "Movie of another cartridge");
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return play(io_console, m_frames[i_frame]);
+}
+
+NHErr
+Movie::play(Console &io_console, const Frame &i_frame) const
+{
+    if (i_frame.events & NH_MOVIE_EVENT_POWER)
+    {
+        NHErr err = io_console.power_up_as_new();
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+    }
+    else if (i_frame.events & NH_MOVIE_EVENT_RESET)
+    {
+        io_console.reset();
+    }
+
+    io_console.set_buttons(NH_CTRL_P1, i_frame.buttons[0]);
+    io_console.set_buttons(NH_CTRL_P2, i_frame.buttons[1]);
+    io_console.run_frame();
+    return NH_ERR_OK;
+}
+
+void
+pv_put(std::vector<Byte> &io_buf, std::uint32_t i_val, int i_bytes)
+{
+    for (int i = 0; i < i_bytes; ++i)
+    {
+        io_buf.push_back(Byte(i_val >> (8 * i)));
+    }
+}
+
+std::uint32_t
+pv_get(const Byte *i_buf, int i_bytes)
+{
+    std::uint32_t val = 0;
+    for (int i = 0; i < i_bytes; ++i)
+    {
+        val |= std::uint32_t(i_buf[i]) << (8 * i);
+    }
+    return val;
+}
+
+} // namespace nh
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "nesish/nesish.h"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nh {
+
+struct Console;
+struct MovieIndex;
+
+/// @brief Input of a session frame by frame, played back through the same
+/// path it's recorded, so that the console ends up exactly the same.
+struct Movie {
+  public:
+    Movie(NHLogger *i_logger);
+    NB_KLZ_DELETE_COPY_MOVE(Movie);
+
+    /// @param o_movie Released by the caller
+    static NHErr
+    load(const std::string &i_path, NHLogger *i_logger, Movie **o_movie);
+    NHErr
+    save(const std::string &i_path) const;
+
+    std::size_t
+    frames() const;
+    /// @return 0 until the first frame is recorded
+    std::uint32_t
+    rom_hash() const;
+    /// @return Hash of the first "i_frames" frames, to tell if what's derived
+    /// from them still holds.
+    std::uint32_t
+    hash(std::size_t i_frames) const;
+
+    /// @brief Append a frame and play it. The first powers up.
+    NHErr
+    record(Console &io_console, Byte i_p1, Byte i_p2, NHMovieEvent i_events);
+    /// @brief Play frame "i_frame", after the ones before it.
+    NHErr
+    play(Console &io_console, std::size_t i_frame) const;
+
+  private:
+    struct Frame {
+        Byte buttons[2]; // P1 and P2
+        Byte events;
+    };
+
+    NHErr
+    play(Console &io_console, const Frame &i_frame) const;
+
+  private:
+    std::uint32_t m_rom_hash;
+    std::vector<Frame> m_frames;
+
+  private:
+    NHLogger *m_logger;
+
+  private:
+    friend struct MovieIndex;
+};
+
+} // namespace nh
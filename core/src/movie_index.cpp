@@ -0,0 +1,226 @@
+#include "movie_index.hpp"
+
+#include "nhbase/filesystem.hpp"
+#include "nhbase/vc_intrinsics.hpp"
+#include "console.hpp"
+#include "movie.hpp"
+#include "log.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace nh {
+
+/* Format, little-endian:
+ * u32 magic, u32 version, u32 ROM hash, u32 hash of the frames covered,
+ * u32 frames covered, u32 interval, u32 state size, u32 count,
+ * then "count" states one after another, at frames interval * (i + 1).
+ */
+
+// "NHMX" in little-endian
+static constexpr std::uint32_t INDEX_MAGIC = 0x584D484E;
+static constexpr std::uint32_t INDEX_VERSION = 1;
+static constexpr std::size_t INDEX_HEADER_SIZE = 32;
+
+static void
+pv_put(Byte *o_buf, std::uint32_t i_val);
+static std::uint32_t
+pv_get(const Byte *i_buf);
+
+MovieIndex::MovieIndex(const Movie &i_movie, NHLogger *i_logger)
+    : m_movie(i_movie)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_interval(0)
+    , m_state_size(0)
+    , m_count(0)
+    , m_logger(i_logger)
+{
+}
+
+MovieIndex::~MovieIndex()
+{
+    nb::file_unmap(m_data, m_size);
+}
+
+NHErr
+MovieIndex::build(const Movie &i_movie, Console &io_console, int i_interval,
+                  const std::string &i_path)
+{
+    NHLogger *logger = i_movie.m_logger;
+    if (i_interval <= 0 || !i_movie.frames())
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    std::size_t interval = std::size_t(i_interval);
+    std::size_t count = i_movie.frames() / interval;
+    std::size_t covered = count * interval;
+    std::size_t state_size = io_console.state_size();
+    if (!state_size)
+    {
+        NH_LOG_ERROR(logger, "Index without cartridge inserted");
+        return NH_ERR_UNINITIALIZED;
+    }
+
+    NB_VC_WARNING_PUSH
+    NB_VC_WARNING_DISABLE(4996)
+    std::FILE *fp = std::fopen(i_path.c_str(), "wb");
+    NB_VC_WARNING_POP
+    if (!fp)
+    {
+        NH_LOG_ERROR(logger, "File opening failed!");
+        return NH_ERR_UNAVAILABLE;
+    }
+
+    Byte header[INDEX_HEADER_SIZE];
+    pv_put(header + 0, INDEX_MAGIC);
+    pv_put(header + 4, INDEX_VERSION);
+    pv_put(header + 8, i_movie.rom_hash());
+    pv_put(header + 12, i_movie.hash(covered));
+    pv_put(header + 16, std::uint32_t(covered));
+    pv_put(header + 20, std::uint32_t(interval));
+    pv_put(header + 24, std::uint32_t(state_size));
+    pv_put(header + 28, std::uint32_t(count));
+    bool ok = std::fwrite(header, 1, sizeof(header), fp) == sizeof(header);
+
+    NHErr err = NH_ERR_OK;
+    std::vector<Byte> state(state_size);
+    for (std::size_t i = 0; i < covered && ok && !NH_FAILED(err); ++i)
+    {
+        err = i_movie.play(io_console, i);
+        if (!NH_FAILED(err) && (i + 1) % interval == 0)
+        {
+            err = io_console.save_state(state.data(), state.size());
+            ok = !NH_FAILED(err) &&
+                 std::fwrite(state.data(), 1, state.size(), fp) ==
+                     state.size();
+        }
+    }
+    ok = !std::fclose(fp) && ok;
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    if (!ok)
+    {
+        NH_LOG_ERROR(logger, "Index writing failed: \"{}\"", i_path);
+        return NH_ERR_UNAVAILABLE;
+    }
+    return NH_ERR_OK;
+}
+
+NHErr
+MovieIndex::open(const std::string &i_path, const Movie &i_movie,
+                 NHLogger *i_logger, MovieIndex **o_index)
+{
+    std::size_t size = 0;
+    const Byte *data = (const Byte *)nb::file_map(i_path, &size);
+    if (!data)
+    {
+        NH_LOG_ERROR(i_logger, "Index mapping failed: \"{}\"", i_path);
+        return NH_ERR_UNAVAILABLE;
+    }
+
+    MovieIndex *index = new MovieIndex(i_movie, i_logger);
+    index->m_data = data;
+    index->m_size = size;
+
+    if (size < INDEX_HEADER_SIZE || pv_get(data) != INDEX_MAGIC ||
+        pv_get(data + 4) != INDEX_VERSION)
+    {
+        NH_LOG_ERROR(i_logger, "Not an index of version {}", INDEX_VERSION);
+        delete index;
+        return NH_ERR_CORRUPTED;
+    }
+    index->m_interval = pv_get(data + 20);
+    index->m_state_size = pv_get(data + 24);
+    index->m_count = pv_get(data + 28);
+    std::size_t covered = pv_get(data + 16);
+    // In 64 bits, which products of the 32-bit fields can't wrap, as size_t
+    // may on 32-bit targets.
+    std::uint64_t count = index->m_count;
+    if (!index->m_interval ||
+        std::uint64_t(covered) != std::uint64_t(index->m_interval) * count ||
+        std::uint64_t(size) !=
+            INDEX_HEADER_SIZE + std::uint64_t(index->m_state_size) * count)
+    {
+        NH_LOG_ERROR(i_logger, "Index truncated or corrupted");
+        delete index;
+        return NH_ERR_CORRUPTED;
+    }
+    // Frames recorded after still go, those before must be as they were.
+    if (pv_get(data + 8) != i_movie.rom_hash() ||
+        covered > i_movie.frames() ||
+        pv_get(data + 12) != i_movie.hash(covered))
+    {
+        NH_LOG_ERROR(i_logger, "Index of another movie");
+        delete index;
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    *o_index = index;
+    return NH_ERR_OK;
+}
+
+NHErr
+MovieIndex::seek(Console &io_console, std::size_t i_frame) const
+{
+    if (i_frame > m_movie.frames())
+    {
+        NH_LOG_ERROR(m_logger, "Seek past the end: {} > {}", i_frame,
+                     m_movie.frames());
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    std::size_t keyframe = i_frame / m_interval;
+    if (keyframe > m_count)
+    {
+        keyframe = m_count;
+    }
+    std::size_t frame = 0;
+    if (keyframe)
+    {
+        // Straight from the mapping.
+        NHErr err = io_console.load_state(
+            m_data + INDEX_HEADER_SIZE + (keyframe - 1) * m_state_size,
+            m_state_size);
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+        frame = keyframe * m_interval;
+    }
+
+    for (; frame < i_frame; ++frame)
+    {
+        NHErr err = m_movie.play(io_console, frame);
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+    }
+    return NH_ERR_OK;
+}
+
+void
+pv_put(Byte *o_buf, std::uint32_t i_val)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        o_buf[i] = Byte(i_val >> (8 * i));
+    }
+}
+
+std::uint32_t
+pv_get(const Byte *i_buf)
+{
+    std::uint32_t val = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        val |= std::uint32_t(i_buf[i]) << (8 * i);
+    }
+    return val;
+}
+
+} // namespace nh
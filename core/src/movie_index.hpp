@@ -0,0 +1,57 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "nesish/nesish.h"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nh {
+
+struct Console;
+struct Movie;
+
+/// @brief States of a movie every few frames, kept in a file mapped into
+/// memory, so that seeking loads the closest one before and plays the rest
+/// rather than the whole movie from the start.
+struct MovieIndex {
+  public:
+    ~MovieIndex();
+    NB_KLZ_DELETE_COPY_MOVE(MovieIndex);
+
+    /// @brief Play "i_movie" on "io_console" from the start, saving a state
+    /// every "i_interval" frames into "i_path".
+    static NHErr
+    build(const Movie &i_movie, Console &io_console, int i_interval,
+          const std::string &i_path);
+    /// @param i_movie Must outlive the index
+    /// @param o_index Released by the caller
+    static NHErr
+    open(const std::string &i_path, const Movie &i_movie, NHLogger *i_logger,
+         MovieIndex **o_index);
+
+    /// @brief Put "io_console" where it is before playing frame "i_frame".
+    NHErr
+    seek(Console &io_console, std::size_t i_frame) const;
+
+  private:
+    MovieIndex(const Movie &i_movie, NHLogger *i_logger);
+
+  private:
+    const Movie &m_movie;
+
+    // Mapped file
+    const Byte *m_data;
+    std::size_t m_size;
+
+    std::size_t m_interval; // frames
+    std::size_t m_state_size;
+    std::size_t m_count; // of states, the first after "m_interval" frames
+
+  private:
+    NHLogger *m_logger;
+};
+
+} // namespace nh
@@ -1,9 +1,26 @@
 #include "nesish/nesish.h"
 
 #include "console.hpp"
+#include "console_pool.hpp"
+#include "movie.hpp"
+#include "movie_index.hpp"
+#include "net_socket.hpp"
+#include "netplay.hpp"
 
 #define NH_DECL_CONSOLE(handle)                                                \
     nh::Console *nh_console = (nh::Console *)(handle);
+#define NH_DECL_ROM(handle)                                                    \
+    nh::Cartridge *nh_rom = (nh::Cartridge *)(handle);
+#define NH_DECL_POOL(handle)                                                   \
+    nh::ConsolePool *nh_pool = (nh::ConsolePool *)(handle);
+#define NH_DECL_MOVIE(handle)                                                  \
+    nh::Movie *nh_movie = (nh::Movie *)(handle);
+#define NH_DECL_MOVIE_INDEX(handle)                                            \
+    nh::MovieIndex *nh_index = (nh::MovieIndex *)(handle);
+#define NH_DECL_SOCKET(handle)                                                 \
+    nh::NetSocket *nh_socket = (nh::NetSocket *)(handle);
+#define NH_DECL_NETPLAY(handle)                                                \
+    nh::Netplay *nh_netplay = (nh::Netplay *)(handle);
 #define NH_DECL_CPU(handle) nh::CPU *nh_cpu = (nh::CPU *)(handle);
 #define NH_DECL_FRM(handle)                                                    \
     const nh::FrameBuffer *nh_frame = (const nh::FrameBuffer *)(handle);
@@ -31,6 +48,13 @@ nh_release_console(NHConsole console)
     delete nh_console;
 }
 
+NHErr
+nh_clone_console(NHConsole console, NHConsole *clone)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->clone((nh::Console **)clone);
+}
+
 void
 nh_plug_ctrl(NHConsole console, NHCtrlPort slot, NHController *ctrl)
 {
@@ -45,6 +69,13 @@ nh_unplug_ctrl(NHConsole console, NHCtrlPort slot)
     nh_console->unplug_controller(slot);
 }
 
+void
+nh_set_buttons(NHConsole console, NHCtrlPort slot, NHByte buttons)
+{
+    NH_DECL_CONSOLE(console);
+    nh_console->set_buttons(slot, buttons);
+}
+
 NHErr
 nh_insert_cartridge(NHConsole console, const char *rom_path)
 {
@@ -60,6 +91,36 @@ nh_remove_cartridge(NHConsole console)
     nh_console->remove_cartridge();
 }
 
+NHErr
+nh_load_rom(const char *rom_path, NHLogger *logger, NHRom *rom)
+{
+    if (!rom_path || !rom)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::Console::load_rom(rom_path, logger, (nh::Cartridge **)rom);
+}
+
+void
+nh_release_rom(NHRom rom)
+{
+    NH_DECL_ROM(rom);
+    delete nh_rom;
+}
+
+NHErr
+nh_insert_rom(NHConsole console, NHRom rom)
+{
+    NH_DECL_CONSOLE(console);
+    NH_DECL_ROM(rom);
+    if (!nh_rom)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    nh_console->insert_rom(*nh_rom);
+    return NH_ERR_OK;
+}
+
 void
 nh_power_up(NHConsole console)
 {
@@ -94,6 +155,288 @@ nh_tick(NHConsole console, int *cpu_instr)
     return b0;
 }
 
+void
+nh_run_cycles(NHConsole console, NHCycle cycles)
+{
+    NH_DECL_CONSOLE(console);
+    nh_console->run_cycles(cycles);
+}
+
+NHCycle
+nh_run_frame(NHConsole console)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->run_frame();
+}
+
+NHEvent
+nh_run_until(NHConsole console, NHEvent events, NHCycle max_cycles,
+             NHCycle *cycles)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->run_until(events, max_cycles, cycles);
+}
+
+size_t
+nh_state_size(NHConsole console)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->state_size();
+}
+
+NHErr
+nh_save_state(NHConsole console, void *buf, size_t size)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->save_state(buf, size);
+}
+
+NHErr
+nh_load_state(NHConsole console, const void *buf, size_t size)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->load_state(buf, size);
+}
+
+uint64_t
+nh_state_hash(NHConsole console)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->state_hash();
+}
+
+NHErr
+nh_set_rewind(NHConsole console, int interval, size_t capacity)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->set_rewind(interval, capacity);
+}
+
+NHErr
+nh_rewind(NHConsole console, int frames, int *rewound)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->rewind(frames, rewound);
+}
+
+NHErr
+nh_set_run_ahead(NHConsole console, int frames)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->set_run_ahead(frames);
+}
+
+void
+nh_set_idle_skip(NHConsole console, int enabled)
+{
+    NH_DECL_CONSOLE(console);
+    nh_console->set_idle_skip(enabled);
+}
+
+NHMovie
+nh_new_movie(NHLogger *logger)
+{
+    return (NHMovie) new nh::Movie(logger);
+}
+
+void
+nh_release_movie(NHMovie movie)
+{
+    NH_DECL_MOVIE(movie);
+    delete nh_movie;
+}
+
+NHErr
+nh_load_movie(const char *path, NHLogger *logger, NHMovie *movie)
+{
+    if (!path || !movie)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::Movie::load(path, logger, (nh::Movie **)movie);
+}
+
+NHErr
+nh_save_movie(NHMovie movie, const char *path)
+{
+    NH_DECL_MOVIE(movie);
+    if (!path)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh_movie->save(path);
+}
+
+size_t
+nh_movie_frames(NHMovie movie)
+{
+    NH_DECL_MOVIE(movie);
+    return nh_movie->frames();
+}
+
+NHErr
+nh_movie_record(NHMovie movie, NHConsole console, NHByte p1, NHByte p2,
+                NHMovieEvent events)
+{
+    NH_DECL_MOVIE(movie);
+    NH_DECL_CONSOLE(console);
+    return nh_movie->record(*nh_console, p1, p2, events);
+}
+
+NHErr
+nh_movie_play(NHMovie movie, NHConsole console, size_t frame)
+{
+    NH_DECL_MOVIE(movie);
+    NH_DECL_CONSOLE(console);
+    return nh_movie->play(*nh_console, frame);
+}
+
+NHErr
+nh_build_movie_index(NHMovie movie, NHConsole console, int interval,
+                     const char *path)
+{
+    NH_DECL_MOVIE(movie);
+    NH_DECL_CONSOLE(console);
+    if (!path)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::MovieIndex::build(*nh_movie, *nh_console, interval, path);
+}
+
+NHErr
+nh_open_movie_index(const char *path, NHMovie movie, NHLogger *logger,
+                    NHMovieIndex *index)
+{
+    NH_DECL_MOVIE(movie);
+    if (!path || !index)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::MovieIndex::open(path, *nh_movie, logger,
+                                (nh::MovieIndex **)index);
+}
+
+void
+nh_close_movie_index(NHMovieIndex index)
+{
+    NH_DECL_MOVIE_INDEX(index);
+    delete nh_index;
+}
+
+NHErr
+nh_movie_seek(NHMovieIndex index, NHConsole console, size_t frame)
+{
+    NH_DECL_MOVIE_INDEX(index);
+    NH_DECL_CONSOLE(console);
+    return nh_index->seek(*nh_console, frame);
+}
+
+NHErr
+nh_open_udp_socket(int port, const char *remote_host, int remote_port,
+                   NHLogger *logger, NHNetSocket *socket)
+{
+    if (!remote_host || !socket)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::NetSocket::open_udp(port, remote_host, remote_port, logger,
+                                   (nh::NetSocket **)socket);
+}
+
+NHErr
+nh_open_local_socket(const char *path, const char *remote_path,
+                     NHLogger *logger, NHNetSocket *socket)
+{
+    if (!path || !remote_path || !socket)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+    return nh::NetSocket::open_local(path, remote_path, logger,
+                                     (nh::NetSocket **)socket);
+}
+
+void
+nh_close_socket(NHNetSocket socket)
+{
+    NH_DECL_SOCKET(socket);
+    delete nh_socket;
+}
+
+void
+nh_socket_set_lag(NHNetSocket socket, int latency, int jitter)
+{
+    NH_DECL_SOCKET(socket);
+    nh_socket->set_lag(latency, jitter);
+}
+
+NHNetTransport *
+nh_socket_transport(NHNetSocket socket)
+{
+    NH_DECL_SOCKET(socket);
+    return nh_socket->transport();
+}
+
+NHErr
+nh_new_netplay(NHConsole console, NHCtrlPort port, NHNetTransport *transport,
+               int max_rollback, NHLogger *logger, NHNetplay *netplay)
+{
+    NH_DECL_CONSOLE(console);
+    if (!nh_console || !netplay)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    nh::Netplay *nh_netplay =
+        new nh::Netplay(*nh_console, port, transport, logger);
+    NHErr err = nh_netplay->init(max_rollback);
+    if (NH_FAILED(err))
+    {
+        delete nh_netplay;
+        return err;
+    }
+    *netplay = (NHNetplay)nh_netplay;
+    return NH_ERR_OK;
+}
+
+void
+nh_release_netplay(NHNetplay netplay)
+{
+    NH_DECL_NETPLAY(netplay);
+    delete nh_netplay;
+}
+
+NHErr
+nh_netplay_run_frame(NHNetplay netplay, NHByte buttons)
+{
+    NH_DECL_NETPLAY(netplay);
+    return nh_netplay->run_frame(buttons);
+}
+
+void
+nh_netplay_get_stats(NHNetplay netplay, NHNetplayStats *stats)
+{
+    NH_DECL_NETPLAY(netplay);
+    if (stats)
+    {
+        *stats = nh_netplay->stats();
+    }
+}
+
+void
+nh_plug_audio_sink(NHConsole console, NHAudioSink *sink)
+{
+    NH_DECL_CONSOLE(console);
+    nh_console->plug_audio_sink(sink);
+}
+
+void
+nh_unplug_audio_sink(NHConsole console)
+{
+    NH_DECL_CONSOLE(console);
+    nh_console->unplug_audio_sink();
+}
+
 int
 nh_frm_width(NHFrame frame)
 {
@@ -112,6 +455,24 @@ nh_frm_data(NHFrame frame)
     NH_DECL_FRM(frame);
     return nh_frame->get_data();
 }
+const NHByte *
+nh_frm_indices(NHFrame frame)
+{
+    NH_DECL_FRM(frame);
+    return nh_frame->get_indices();
+}
+const NHByte *
+nh_frm_palette(NHFrame frame)
+{
+    NH_DECL_FRM(frame);
+    return nh_frame->get_palette();
+}
+void
+nh_frm_convert(NHFrame frame, void *dst, int pitch, NHPixelFormat format)
+{
+    NH_DECL_FRM(frame);
+    nh_frame->convert(dst, pitch, format);
+}
 
 NHFrame
 nh_get_frm(NHConsole console)
@@ -120,6 +481,42 @@ nh_get_frm(NHConsole console)
     return (NHFrame)&nh_console->get_frame();
 }
 
+NHErr
+nh_set_frame_target(NHConsole console, void *pixels, int pitch,
+                    NHPixelFormat format)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->set_frame_target(pixels, pitch, format);
+}
+
+NHErr
+nh_set_observation(NHConsole console, NHByte *pixels, int width, int height,
+                   int pitch)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->set_observation(pixels, width, height, pitch);
+}
+
+const NHByte *
+nh_get_ram(NHConsole console)
+{
+    NH_DECL_CONSOLE(console);
+    return nh_console->get_ram();
+}
+
+const NHByte *
+nh_get_prg_ram(NHConsole console, size_t *size)
+{
+    NH_DECL_CONSOLE(console);
+    size_t prg_ram_size = 0;
+    const NHByte *prg_ram = nh_console->get_prg_ram(&prg_ram_size);
+    if (size)
+    {
+        *size = prg_ram_size;
+    }
+    return prg_ram;
+}
+
 int
 nh_get_sample_rate(NHConsole console)
 {
@@ -133,6 +530,71 @@ nh_get_sample(NHConsole console)
     return nh_console->get_sample();
 }
 
+NHErr
+nh_new_pool(NHRom rom, int consoles, int threads, NHLogger *logger,
+            NHPool *pool)
+{
+    NH_DECL_ROM(rom);
+    if (!nh_rom || !pool)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    nh::ConsolePool *nh_pool = new nh::ConsolePool(threads, logger);
+    NHErr err = nh_pool->init(*nh_rom, consoles);
+    if (NH_FAILED(err))
+    {
+        delete nh_pool;
+        return err;
+    }
+    *pool = (NHPool)nh_pool;
+    return NH_ERR_OK;
+}
+
+void
+nh_release_pool(NHPool pool)
+{
+    NH_DECL_POOL(pool);
+    delete nh_pool;
+}
+
+NHConsole
+nh_pool_get_console(NHPool pool, int index)
+{
+    NH_DECL_POOL(pool);
+    return (NHConsole)nh_pool->get_console(index);
+}
+
+void
+nh_pool_set_episode(NHPool pool, int frames)
+{
+    NH_DECL_POOL(pool);
+    nh_pool->set_episode(frames);
+}
+
+NHErr
+nh_pool_set_frame_targets(NHPool pool, void *pixels, ptrdiff_t stride,
+                          int pitch, NHPixelFormat format)
+{
+    NH_DECL_POOL(pool);
+    return nh_pool->set_frame_targets(pixels, stride, pitch, format);
+}
+
+NHErr
+nh_pool_set_observations(NHPool pool, NHByte *pixels, ptrdiff_t stride,
+                         int width, int height, int pitch)
+{
+    NH_DECL_POOL(pool);
+    return nh_pool->set_observations(pixels, stride, width, height, pitch);
+}
+
+void
+nh_pool_step(NHPool pool, const NHByte *actions, NHByte *dones)
+{
+    NH_DECL_POOL(pool);
+    nh_pool->step(actions, dones);
+}
+
 void
 nhd_turn_debug_on(NHConsole console, NHDFlag flag)
 {
@@ -0,0 +1,167 @@
+#include "net_socket.hpp"
+
+#include "log.hpp"
+
+namespace nh {
+
+NetSocket::NetSocket(nb::socket_t i_socket)
+    : m_socket(i_socket)
+    , m_connected(false)
+    , m_transport{transport_send, transport_recv, this}
+    , m_latency(0)
+    , m_jitter(0)
+{
+}
+
+NetSocket::~NetSocket()
+{
+    nb::socket_close(m_socket);
+}
+
+NHErr
+NetSocket::open_udp(int i_port, const std::string &i_remote_host,
+                    int i_remote_port, NHLogger *i_logger,
+                    NetSocket **o_socket)
+{
+    if (i_port < 0 || i_port > 0xFFFF || i_remote_port <= 0 ||
+        i_remote_port > 0xFFFF)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    nb::socket_t sock = nb::udp_open(std::uint16_t(i_port));
+    if (sock < 0)
+    {
+        NH_LOG_ERROR(i_logger, "UDP socket failed on port {}", i_port);
+        return NH_ERR_UNAVAILABLE;
+    }
+    if (!nb::udp_connect(sock, i_remote_host, std::uint16_t(i_remote_port)))
+    {
+        NH_LOG_ERROR(i_logger, "UDP peer unknown: {}:{}", i_remote_host,
+                     i_remote_port);
+        nb::socket_close(sock);
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    NetSocket *socket = new NetSocket(sock);
+    socket->m_connected = true;
+    *o_socket = socket;
+    return NH_ERR_OK;
+}
+
+NHErr
+NetSocket::open_local(const std::string &i_path,
+                      const std::string &i_remote_path, NHLogger *i_logger,
+                      NetSocket **o_socket)
+{
+    if (i_remote_path.empty())
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    nb::socket_t sock = nb::local_open(i_path);
+    if (sock < 0)
+    {
+        NH_LOG_ERROR(i_logger, "Unix-domain socket failed: \"{}\"", i_path);
+        return NH_ERR_UNAVAILABLE;
+    }
+
+    NetSocket *socket = new NetSocket(sock);
+    socket->m_remote_path = i_remote_path;
+    *o_socket = socket;
+    return NH_ERR_OK;
+}
+
+void
+NetSocket::set_lag(int i_latency, int i_jitter)
+{
+    m_latency = i_latency > 0 ? i_latency : 0;
+    m_jitter = i_jitter > 0 ? i_jitter : 0;
+}
+
+NHNetTransport *
+NetSocket::transport()
+{
+    return &m_transport;
+}
+
+void
+NetSocket::send(const void *i_data, std::size_t i_size)
+{
+    if (!m_latency && !m_jitter)
+    {
+        flush();
+        send_now(i_data, i_size);
+        return;
+    }
+
+    int lag = m_latency;
+    if (m_jitter)
+    {
+        lag += int(m_random() % unsigned(m_jitter + 1));
+    }
+    const Byte *data = (const Byte *)i_data;
+    m_held.push_back(Held{Clock::now() + std::chrono::milliseconds(lag),
+                          std::vector<Byte>(data, data + i_size)});
+    flush();
+}
+
+std::size_t
+NetSocket::recv(void *o_data, std::size_t i_size)
+{
+    flush();
+    return nb::socket_recv(m_socket, o_data, i_size);
+}
+
+void
+NetSocket::flush()
+{
+    // Those due first go first, jitter may reorder them.
+    Clock::time_point now = Clock::now();
+    while (!m_held.empty())
+    {
+        std::size_t next = 0;
+        for (std::size_t i = 1; i < m_held.size(); ++i)
+        {
+            if (m_held[i].due < m_held[next].due)
+            {
+                next = i;
+            }
+        }
+        if (m_held[next].due > now)
+        {
+            break;
+        }
+        send_now(m_held[next].data.data(), m_held[next].data.size());
+        m_held.erase(m_held.begin() + std::ptrdiff_t(next));
+    }
+}
+
+void
+NetSocket::send_now(const void *i_data, std::size_t i_size)
+{
+    if (!m_connected)
+    {
+        m_connected = nb::local_connect(m_socket, m_remote_path);
+    }
+    // Lost like any datagram otherwise.
+    if (m_connected)
+    {
+        nb::socket_send(m_socket, i_data, i_size);
+    }
+}
+
+void
+NetSocket::transport_send(const void *i_data, std::size_t i_size,
+                          void *io_user)
+{
+    ((NetSocket *)io_user)->send(i_data, i_size);
+}
+
+std::size_t
+NetSocket::transport_recv(void *o_data, std::size_t i_size, void *io_user)
+{
+    return ((NetSocket *)io_user)->recv(o_data, i_size);
+}
+
+} // namespace nh
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "nhbase/socket.hpp"
+#include "nesish/nesish.h"
+#include "types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nh {
+
+/// @brief Datagram socket to one peer as an NHNetTransport, optionally
+/// holding what's sent for a while to stand in for a network.
+struct NetSocket {
+  public:
+    ~NetSocket();
+    NB_KLZ_DELETE_COPY_MOVE(NetSocket);
+
+    /// @param o_socket Released by the caller
+    static NHErr
+    open_udp(int i_port, const std::string &i_remote_host, int i_remote_port,
+             NHLogger *i_logger, NetSocket **o_socket);
+    /// @param o_socket Released by the caller
+    static NHErr
+    open_local(const std::string &i_path, const std::string &i_remote_path,
+               NHLogger *i_logger, NetSocket **o_socket);
+
+    /// @param i_latency ms
+    /// @param i_jitter ms, added at random
+    void
+    set_lag(int i_latency, int i_jitter);
+
+    NHNetTransport *
+    transport();
+
+  private:
+    NetSocket(nb::socket_t i_socket);
+
+    void
+    send(const void *i_data, std::size_t i_size);
+    std::size_t
+    recv(void *o_data, std::size_t i_size);
+    /// @brief Send those held long enough.
+    void
+    flush();
+    void
+    send_now(const void *i_data, std::size_t i_size);
+
+    static void
+    transport_send(const void *i_data, std::size_t i_size, void *io_user);
+    static std::size_t
+    transport_recv(void *o_data, std::size_t i_size, void *io_user);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    nb::socket_t m_socket;
+    // Unix-domain sockets connect only once the peer is bound.
+    std::string m_remote_path;
+    bool m_connected;
+
+    NHNetTransport m_transport;
+
+    struct Held {
+        Clock::time_point due;
+        std::vector<Byte> data;
+    };
+    int m_latency; // ms
+    int m_jitter;  // ms
+    std::minstd_rand m_random;
+    std::vector<Held> m_held;
+};
+
+} // namespace nh
@@ -0,0 +1,268 @@
+#include "netplay.hpp"
+
+#include "console.hpp"
+#include "log.hpp"
+
+#include <cstring>
+
+namespace nh {
+
+/* Datagram, little-endian:
+ * u32 magic, u32 ROM hash, u32 remote frames acknowledged,
+ * u32 first frame, u16 count, then "count" local inputs from the first.
+ */
+
+// "NHNP" in little-endian
+static constexpr std::uint32_t PACKET_MAGIC = 0x504E484E;
+static constexpr std::size_t PACKET_HEADER_SIZE = 18;
+
+constexpr std::size_t Netplay::HISTORY;
+constexpr int Netplay::MAX_ROLLBACK;
+
+static void
+pv_put(Byte *o_buf, std::uint32_t i_val, int i_bytes);
+static std::uint32_t
+pv_get(const Byte *i_buf, int i_bytes);
+
+Netplay::Netplay(Console &io_console, NHCtrlPort i_port,
+                 NHNetTransport *i_transport, NHLogger *i_logger)
+    : m_console(io_console)
+    , m_port(i_port)
+    , m_remote_port(i_port == NH_CTRL_P1 ? NH_CTRL_P2 : NH_CTRL_P1)
+    , m_transport(i_transport)
+    , m_max_rollback(0)
+    , m_frame(0)
+    , m_confirmed(0)
+    , m_acked(0)
+    , m_local{}
+    , m_remote{}
+    , m_used{}
+    , m_state_size(0)
+    , m_rollbacks(0)
+    , m_reruns(0)
+    , m_logger(i_logger)
+{
+}
+
+NHErr
+Netplay::init(int i_max_rollback)
+{
+    if (i_max_rollback < 1 || i_max_rollback > MAX_ROLLBACK ||
+        (m_port != NH_CTRL_P1 && m_port != NH_CTRL_P2) || !m_transport ||
+        !m_transport->send || !m_transport->recv)
+    {
+        return NH_ERR_INVALID_ARGUMENT;
+    }
+
+    // The same as the remote one, whatever ran before.
+    NHErr err = m_console.power_up_as_new();
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    m_console.set_buttons(m_port, 0);
+    m_console.set_buttons(m_remote_port, 0);
+
+    m_max_rollback = std::size_t(i_max_rollback);
+    m_state_size = m_console.state_size();
+    m_snapshots.assign(m_max_rollback * m_state_size, 0);
+    NH_LOG_INFO(m_logger, "Netplay on port {}, {} frames of rollback",
+                m_port, m_max_rollback);
+    return NH_ERR_OK;
+}
+
+NHErr
+Netplay::run_frame(Byte i_buttons)
+{
+    std::size_t mispredicted = receive();
+    if (mispredicted < m_frame)
+    {
+        NHErr err = roll_back(mispredicted);
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+    }
+
+    // Wait for the remote to catch up, the snapshots wouldn't go back far
+    // enough otherwise.
+    if (m_frame >= m_confirmed + m_max_rollback)
+    {
+        send();
+        return NH_ERR_UNAVAILABLE;
+    }
+
+    m_local[m_frame % HISTORY] = i_buttons;
+    NHErr err = run(m_frame, false);
+    if (NH_FAILED(err))
+    {
+        return err;
+    }
+    ++m_frame;
+    send();
+    return NH_ERR_OK;
+}
+
+NHNetplayStats
+Netplay::stats() const
+{
+    return NHNetplayStats{m_frame, m_confirmed, m_rollbacks, m_reruns};
+}
+
+std::size_t
+Netplay::receive()
+{
+    std::size_t confirmed = m_confirmed;
+    Byte packet[PACKET_HEADER_SIZE + HISTORY];
+    std::size_t size;
+    while ((size = m_transport->recv(packet, sizeof(packet),
+                                     m_transport->user)) > 0)
+    {
+        if (size < PACKET_HEADER_SIZE || pv_get(packet, 4) != PACKET_MAGIC ||
+            pv_get(packet + 4, 4) != m_console.rom_hash())
+        {
+            continue;
+        }
+        std::size_t acked = pv_get(packet + 8, 4);
+        std::size_t first = pv_get(packet + 12, 4);
+        std::size_t count = pv_get(packet + 16, 2);
+        if (PACKET_HEADER_SIZE + count > size)
+        {
+            continue;
+        }
+
+        // Older ones may come late.
+        if (acked > m_acked && acked <= m_frame)
+        {
+            m_acked = acked;
+        }
+        // The remote stops at "m_max_rollback" frames ahead of what it has
+        // from here.
+        for (std::size_t i = 0;
+             i < count && m_confirmed < m_frame + m_max_rollback; ++i)
+        {
+            if (first + i == m_confirmed)
+            {
+                m_remote[m_confirmed % HISTORY] =
+                    packet[PACKET_HEADER_SIZE + i];
+                ++m_confirmed;
+            }
+        }
+    }
+
+    // Those before were run with what's known.
+    for (std::size_t frame = confirmed; frame < m_frame; ++frame)
+    {
+        if (predict(frame) != m_used[frame % HISTORY])
+        {
+            return frame;
+        }
+    }
+    return m_frame;
+}
+
+void
+Netplay::send()
+{
+    Byte packet[PACKET_HEADER_SIZE + HISTORY];
+    std::size_t count = m_frame - m_acked;
+    pv_put(packet, PACKET_MAGIC, 4);
+    pv_put(packet + 4, m_console.rom_hash(), 4);
+    pv_put(packet + 8, std::uint32_t(m_confirmed), 4);
+    pv_put(packet + 12, std::uint32_t(m_acked), 4);
+    pv_put(packet + 16, std::uint32_t(count), 2);
+    // All not acknowledged, in case some are lost.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        packet[PACKET_HEADER_SIZE + i] = m_local[(m_acked + i) % HISTORY];
+    }
+    m_transport->send(packet, PACKET_HEADER_SIZE + count, m_transport->user);
+}
+
+Byte
+Netplay::predict(std::size_t i_frame) const
+{
+    if (i_frame < m_confirmed)
+    {
+        return m_remote[i_frame % HISTORY];
+    }
+    // As it last was
+    return m_confirmed ? m_remote[(m_confirmed - 1) % HISTORY] : 0;
+}
+
+NHErr
+Netplay::run(std::size_t i_frame, bool i_rerun)
+{
+    // To come back to if the prediction is wrong.
+    if (i_frame >= m_confirmed)
+    {
+        NHErr err = m_console.save_state(
+            m_snapshots.data() + (i_frame % m_max_rollback) * m_state_size,
+            m_state_size);
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+    }
+
+    Byte remote = predict(i_frame);
+    m_used[i_frame % HISTORY] = remote;
+    m_console.set_buttons(m_port, m_local[i_frame % HISTORY]);
+    m_console.set_buttons(m_remote_port, remote);
+    if (i_rerun)
+    {
+        m_console.rerun_frame();
+    }
+    else
+    {
+        m_console.run_frame();
+    }
+    return NH_ERR_OK;
+}
+
+NHErr
+Netplay::roll_back(std::size_t i_frame)
+{
+    NHErr err = m_console.load_state(
+        m_snapshots.data() + (i_frame % m_max_rollback) * m_state_size,
+        m_state_size);
+    if (NH_FAILED(err))
+    {
+        NH_LOG_ERROR(m_logger, "Failed to roll back to frame {}", i_frame);
+        return err;
+    }
+
+    ++m_rollbacks;
+    for (std::size_t frame = i_frame; frame < m_frame; ++frame)
+    {
+        err = run(frame, true);
+        if (NH_FAILED(err))
+        {
+            return err;
+        }
+        ++m_reruns;
+    }
+    return NH_ERR_OK;
+}
+
+void
+pv_put(Byte *o_buf, std::uint32_t i_val, int i_bytes)
+{
+    for (int i = 0; i < i_bytes; ++i)
+    {
+        o_buf[i] = Byte(i_val >> (8 * i));
+    }
+}
+
+std::uint32_t
+pv_get(const Byte *i_buf, int i_bytes)
+{
+    std::uint32_t val = 0;
+    for (int i = 0; i < i_bytes; ++i)
+    {
+        val |= std::uint32_t(i_buf[i]) << (8 * i);
+    }
+    return val;
+}
+
+} // namespace nh
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "nesish/nesish.h"
+#include "types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace nh {
+
+struct Console;
+
+/// @brief One side of a two-player session, the remote input predicted and
+/// the frames run with it rolled back and run again when it turns out wrong.
+struct Netplay {
+  public:
+    /// @param i_transport Must outlive the session
+    Netplay(Console &io_console, NHCtrlPort i_port,
+            NHNetTransport *i_transport, NHLogger *i_logger);
+    NB_KLZ_DELETE_COPY_MOVE(Netplay);
+
+    /// @brief Power up the console as new, to run from frame 0 like the
+    /// remote one.
+    /// @param i_max_rollback Frames run ahead of the remote input at most
+    NHErr
+    init(int i_max_rollback);
+
+    /// @return NH_ERR_UNAVAILABLE if too far ahead of the remote input to
+    /// run the frame
+    NHErr
+    run_frame(Byte i_buttons);
+
+    NHNetplayStats
+    stats() const;
+
+  private:
+    /// @return The first frame run with remote input other than known now,
+    /// m_frame if none.
+    std::size_t
+    receive();
+    /// @brief Local input the remote hasn't acknowledged yet.
+    void
+    send();
+
+    Byte
+    predict(std::size_t i_frame) const;
+    NHErr
+    run(std::size_t i_frame, bool i_rerun);
+    NHErr
+    roll_back(std::size_t i_frame);
+
+  private:
+    // Frames of input kept, enough for twice the most frames rolled back.
+    static constexpr std::size_t HISTORY = 256;
+    static constexpr int MAX_ROLLBACK = 64;
+
+    Console &m_console;
+    NHCtrlPort m_port;
+    NHCtrlPort m_remote_port;
+    NHNetTransport *m_transport;
+    std::size_t m_max_rollback;
+
+    std::size_t m_frame;     // to run next
+    std::size_t m_confirmed; // remote input known for frames before it
+    std::size_t m_acked;     // local input the remote has before it
+
+    // Frame i at i % HISTORY
+    Byte m_local[HISTORY];
+    Byte m_remote[HISTORY];
+    Byte m_used[HISTORY]; // remote input frames were last run with
+
+    // Before frame i at i % m_max_rollback, if it's run before the remote
+    // input is known.
+    std::vector<Byte> m_snapshots;
+    std::size_t m_state_size;
+
+    std::size_t m_rollbacks;
+    std::size_t m_reruns;
+
+  private:
+    NHLogger *m_logger;
+};
+
+} // namespace nh
@@ -1,23 +1,39 @@
 #include "frame_buffer.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 namespace nh {
 
-FrameBuffer::FrameBuffer()
+template <typename Pixel>
+static void
+pv_convert(const Byte *i_src, const Pixel *i_table, Byte *o_dst, int i_pitch);
+
+FrameBuffer::FrameBuffer(const Palette &i_palette)
+    : m_rgb_buf(nullptr)
+    , m_rgb_dirty(true)
 {
-    m_buf = new Color[WIDTH * HEIGHT]();
+    // Black until the first frame
+    m_buf = new Byte[WIDTH * HEIGHT];
+    std::memset(m_buf, NH_PALETTE_COLOR_BLACK, WIDTH * HEIGHT);
+
+    for (int i = 0; i < PaletteColor::size(); ++i)
+    {
+        m_colors[i] = i_palette.to_rgb(Byte(i));
+    }
 }
 
 FrameBuffer::~FrameBuffer()
 {
     delete[] m_buf;
+    delete[] m_rgb_buf;
 }
 
 void
-FrameBuffer::write(int i_row, int i_col, const Color &i_clr)
+FrameBuffer::write(int i_row, int i_col, Byte i_color)
 {
-    m_buf[i_row * WIDTH + i_col] = i_clr;
+    m_buf[i_row * WIDTH + i_col] = i_color;
 }
 
 void
@@ -26,13 +42,129 @@ FrameBuffer::swap(FrameBuffer &i_other)
     auto tmp = this->m_buf;
     this->m_buf = i_other.m_buf;
     i_other.m_buf = tmp;
+
+    // Swap the converted ones as well, so that the data pointer changes with
+    // the frame, as before.
+    auto rgb_tmp = this->m_rgb_buf;
+    this->m_rgb_buf = i_other.m_rgb_buf;
+    i_other.m_rgb_buf = rgb_tmp;
+
+    this->m_rgb_dirty = i_other.m_rgb_dirty = true;
+}
+
+const Byte *
+FrameBuffer::get_indices() const
+{
+    return m_buf;
+}
+
+const Byte *
+FrameBuffer::get_palette() const
+{
+    static_assert(std::is_pod<Color>::value && sizeof(Color) == 3,
+                  "Incorrect pointer position");
+    return (const Byte *)(&m_colors[0]);
 }
 
 const Byte *
 FrameBuffer::get_data() const
 {
+    if (!m_rgb_buf)
+    {
+        m_rgb_buf = new Color[WIDTH * HEIGHT]();
+    }
+    if (m_rgb_dirty)
+    {
+        convert(m_rgb_buf, WIDTH * int(sizeof(Color)), NH_PIXEL_FORMAT_RGB888);
+        m_rgb_dirty = false;
+    }
+
     static_assert(std::is_pod<Color>::value, "Incorrect pointer position");
-    return (Byte *)(&m_buf[0]);
+    return (Byte *)(&m_rgb_buf[0]);
+}
+
+void
+FrameBuffer::convert(void *o_dst, int i_pitch, NHPixelFormat i_format) const
+{
+    // Resolve the palette for the format first, so that each pixel is a
+    // single lookup and store.
+    constexpr int color_count = PaletteColor::size();
+    switch (i_format)
+    {
+        case NH_PIXEL_FORMAT_RGB888:
+        {
+            pv_convert(m_buf, m_colors, (Byte *)o_dst, i_pitch);
+        }
+        break;
+
+        case NH_PIXEL_FORMAT_RGBA8888:
+        case NH_PIXEL_FORMAT_BGRA8888:
+        {
+            bool bgra = i_format == NH_PIXEL_FORMAT_BGRA8888;
+            std::uint32_t table[color_count];
+            for (int i = 0; i < color_count; ++i)
+            {
+                const Color &clr = m_colors[i];
+                Byte bytes[4] = {bgra ? clr.b : clr.r, clr.g,
+                                 bgra ? clr.r : clr.b, 0xFF};
+                std::memcpy(&table[i], bytes, sizeof(bytes));
+            }
+            pv_convert(m_buf, table, (Byte *)o_dst, i_pitch);
+        }
+        break;
+
+        case NH_PIXEL_FORMAT_RGB565:
+        {
+            std::uint16_t table[color_count];
+            for (int i = 0; i < color_count; ++i)
+            {
+                const Color &clr = m_colors[i];
+                table[i] = std::uint16_t(((clr.r >> 3) << 11) |
+                                         ((clr.g >> 2) << 5) | (clr.b >> 3));
+            }
+            pv_convert(m_buf, table, (Byte *)o_dst, i_pitch);
+        }
+        break;
+
+        default:
+            break;
+    }
+}
+
+int
+FrameBuffer::pixel_size(NHPixelFormat i_format)
+{
+    switch (i_format)
+    {
+        case NH_PIXEL_FORMAT_RGB888:
+            return 3;
+        case NH_PIXEL_FORMAT_RGBA8888:
+        case NH_PIXEL_FORMAT_BGRA8888:
+            return 4;
+        case NH_PIXEL_FORMAT_RGB565:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+template <typename Pixel>
+void
+pv_convert(const Byte *i_src, const Pixel *i_table, Byte *o_dst, int i_pitch)
+{
+    for (int row = 0; row < FrameBuffer::HEIGHT; ++row)
+    {
+        const Byte *src = i_src + row * FrameBuffer::WIDTH;
+        Byte *dst = o_dst + row * i_pitch;
+        for (int col = 0; col < FrameBuffer::WIDTH; ++col)
+        {
+            // Colors are 6-bit, the rest are emphasis bits. The destination
+            // might not be aligned for "Pixel".
+            std::memcpy(dst + col * sizeof(Pixel),
+                        &i_table[src[col] & (PaletteColor::size() - 1)],
+                        sizeof(Pixel));
+        }
+    }
 }
 
 } // namespace nh
@@ -1,31 +1,54 @@
 #pragma once
 
 #include "ppu/color.hpp"
+#include "ppu/palette.hpp"
+#include "ppu/palette_color.hpp"
 #include "nhbase/klass.hpp"
+#include "nesish/nesish.h"
 #include "spec.hpp"
 
 namespace nh {
 
+/// @brief Pixels are kept as palette colors, and converted to RGB only when
+/// asked for.
 struct FrameBuffer {
   public:
-    FrameBuffer();
+    FrameBuffer(const Palette &i_palette);
     ~FrameBuffer();
     NB_KLZ_DELETE_COPY_MOVE(FrameBuffer);
 
     constexpr static int WIDTH = NH_NES_WIDTH;
     constexpr static int HEIGHT = NH_NES_HEIGHT;
 
+    /// @param i_color Palette color. Emphasis bits are not emulated yet.
     void
-    write(int i_row, int i_col, const Color &i_clr);
+    write(int i_row, int i_col, Byte i_color);
 
     void
     swap(FrameBuffer &i_other);
 
+    /// @return Palette colors, 1 byte per pixel.
+    const Byte *
+    get_indices() const;
+    /// @return RGB of all palette colors, 3 bytes each.
+    const Byte *
+    get_palette() const;
+    /// @return RGB888 pixels, converted on first call after a change.
     const Byte *
     get_data() const;
 
+    void
+    convert(void *o_dst, int i_pitch, NHPixelFormat i_format) const;
+    /// @return Bytes per pixel of "i_format", 0 if invalid.
+    static int
+    pixel_size(NHPixelFormat i_format);
+
   private:
-    Color *m_buf;
+    Byte *m_buf;
+    Color m_colors[PaletteColor::size()];
+
+    mutable Color *m_rgb_buf;
+    mutable bool m_rgb_dirty;
 };
 
 } // namespace nh
@@ -3,11 +3,15 @@
 // https://www.nesdev.org/wiki/DMA
 
 #include "apu/apu_clock.hpp"
+#include "assert.hpp"
 #include "memory/memory.hpp"
 #include "ppu/ppu.hpp"
+#include "state_io.hpp"
 
 namespace nh {
 
+constexpr int OAMDMA::BURST_TICKS;
+
 OAMDMA::OAMDMA(const APUClock &i_clock, const Memory &i_memory, PPU &o_ppu)
     : m_clock(i_clock)
     , m_memory(i_memory)
@@ -126,4 +130,50 @@ OAMDMA::rdy() const
     return m_rdy;
 }
 
+bool
+OAMDMA::idle() const
+{
+    return !m_rdy && !m_working && !m_swap;
+}
+
+bool
+OAMDMA::burstable(bool i_cpu_dma_halt) const
+{
+    // Reads of other than RAM may have side effects or depend on when they're
+    // made.
+    return i_cpu_dma_halt && m_working && !m_swap && !m_got &&
+           !(m_addr_cur & 0x00FF) && m_addr_cur <= NH_RAM_ADDR_TAIL &&
+           m_clock.get();
+}
+
+void
+OAMDMA::burst()
+{
+    NH_ASSERT(burstable(true));
+
+    m_ppu.write_oam(m_memory.get_ram() +
+                        (m_addr_cur & (NH_INTERNAL_RAM_SIZE - 1)),
+                    NH_OAM_SIZE);
+    // RAM reads have no side effects but on the latch, as the last one leaves
+    // it.
+    m_bus = 0xFF;
+    (void)m_memory.get_byte(m_addr_cur + (NH_OAM_SIZE - 1), m_bus);
+
+    m_addr_cur += NH_OAM_SIZE;
+    m_working = false;
+}
+
+void
+OAMDMA::serialize(StateIO &io_state)
+{
+    io_state.field(m_rdy);
+    io_state.field(m_working);
+    io_state.field(m_addr_cur);
+    io_state.field(m_got);
+    io_state.field(m_bus);
+
+    io_state.field(m_swap);
+    io_state.field(m_addr_tmp);
+}
+
 } // namespace nh
@@ -2,10 +2,12 @@
 
 #include "nhbase/klass.hpp"
 
+#include "spec.hpp"
 #include "types.hpp"
 
 namespace nh {
 
+struct StateIO;
 struct APUClock;
 struct Memory;
 struct PPU;
@@ -33,6 +35,26 @@ struct OAMDMA {
 
     bool
     rdy() const;
+    /// @return If neither working nor about to
+    bool
+    idle() const;
+
+    /// @param i_cpu_dma_halt Whether CPU is halted
+    /// @return If the transfer's first get cycle is next, reading from RAM,
+    /// so it can be done at once by burst().
+    bool
+    burstable(bool i_cpu_dma_halt) const;
+    /// @brief Do the whole transfer, leaving the DMA as after its last put
+    /// cycle. The BURST_TICKS ticks it takes are run by the caller.
+    void
+    burst();
+
+    // A get and a put cycle per byte
+    static constexpr int BURST_TICKS = 2 * NH_OAM_SIZE;
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     const APUClock &m_clock;
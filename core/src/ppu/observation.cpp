@@ -0,0 +1,104 @@
+#include "observation.hpp"
+
+#include "spec.hpp"
+
+#include <algorithm>
+
+namespace nh {
+
+static void
+pv_bins(int i_from, int i_to, std::vector<Byte> &o_map,
+        std::vector<int> &o_span);
+
+Observation::Observation(const Palette &i_palette)
+    : m_target(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_pitch(0)
+{
+    for (int i = 0; i < PaletteColor::size(); ++i)
+    {
+        // Rec. 601 luma
+        Color color = i_palette.to_rgb(Byte(i));
+        m_luma[i] = Byte((299 * color.r + 587 * color.g + 114 * color.b +
+                          500) /
+                         1000);
+    }
+}
+
+bool
+Observation::set_target(Byte *o_target, int i_width, int i_height,
+                        int i_pitch)
+{
+    if (!o_target)
+    {
+        m_target = nullptr;
+        return true;
+    }
+    if (i_width <= 0 || i_width > NH_NES_WIDTH || i_height <= 0 ||
+        i_height > NH_NES_HEIGHT || (i_pitch < i_width && -i_pitch < i_width))
+    {
+        return false;
+    }
+
+    m_target = o_target;
+    m_width = i_width;
+    m_height = i_height;
+    m_pitch = i_pitch;
+    pv_bins(NH_NES_WIDTH, m_width, m_col_map, m_col_span);
+    pv_bins(NH_NES_HEIGHT, m_height, m_row_map, m_row_span);
+    m_sums.assign(std::size_t(m_width), 0);
+    return true;
+}
+
+bool
+Observation::enabled() const
+{
+    return m_target;
+}
+
+void
+Observation::add_line(int i_row, const Byte *i_colors)
+{
+    int row = m_row_map[i_row];
+    // First line of the target row
+    if (!i_row || m_row_map[i_row - 1] != row)
+    {
+        std::fill(m_sums.begin(), m_sums.end(), 0);
+    }
+
+    for (int x = 0; x < NH_NES_WIDTH; ++x)
+    {
+        m_sums[m_col_map[x]] +=
+            m_luma[i_colors[x] & (PaletteColor::size() - 1)];
+    }
+
+    // Last line of it
+    if (i_row + 1 == NH_NES_HEIGHT || m_row_map[i_row + 1] != row)
+    {
+        Byte *dst = m_target + row * m_pitch;
+        for (int x = 0; x < m_width; ++x)
+        {
+            int count = m_col_span[x] * m_row_span[row];
+            dst[x] = Byte((m_sums[x] + count / 2) / count);
+        }
+    }
+}
+
+void
+pv_bins(int i_from, int i_to, std::vector<Byte> &o_map,
+        std::vector<int> &o_span)
+{
+    // Target i covers [i * from / to, (i + 1) * from / to).
+    o_map.assign(std::size_t(i_from), 0);
+    o_span.assign(std::size_t(i_to), 0);
+    for (int i = 0; i < i_to; ++i)
+    {
+        int begin = i * i_from / i_to;
+        int end = (i + 1) * i_from / i_to;
+        std::fill(o_map.begin() + begin, o_map.begin() + end, Byte(i));
+        o_span[std::size_t(i)] = end - begin;
+    }
+}
+
+} // namespace nh
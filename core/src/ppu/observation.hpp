@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ppu/palette.hpp"
+#include "ppu/palette_color.hpp"
+#include "nhbase/klass.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace nh {
+
+/// @brief Grayscale frames at a reduced size, each pixel the average of those
+/// it covers. Lines are added as they're rendered, so there's no pass over the
+/// frame after.
+struct Observation {
+  public:
+    Observation(const Palette &i_palette);
+    NB_KLZ_DELETE_COPY_MOVE(Observation);
+
+    /// @param o_target nullptr to stop
+    /// @return false if the size is larger than a frame, or rows overlap
+    bool
+    set_target(Byte *o_target, int i_width, int i_height, int i_pitch);
+    bool
+    enabled() const;
+
+    /// @param i_row [0, NH_NES_HEIGHT)
+    /// @param i_colors Palette colors of the line
+    void
+    add_line(int i_row, const Byte *i_colors);
+
+  private:
+    Byte *m_target;
+    int m_width;
+    int m_height;
+    int m_pitch;
+
+    Byte m_luma[PaletteColor::size()];
+
+    // Target column and row of each of a frame, and how many of a frame
+    // each target one covers.
+    std::vector<Byte> m_col_map;
+    std::vector<Byte> m_row_map;
+    std::vector<int> m_col_span;
+    std::vector<int> m_row_span;
+
+    // Of the target row being added up
+    std::vector<std::uint32_t> m_sums;
+};
+
+} // namespace nh
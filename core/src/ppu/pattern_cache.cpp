@@ -0,0 +1,122 @@
+#include "pattern_cache.hpp"
+
+#include "ppu/pipeline_accessor.hpp"
+
+#include <limits>
+
+namespace nh {
+
+PatternCache::PatternCache()
+    : m_page_srcs{}
+    , m_page_valid{}
+{
+    static_assert(std::numeric_limits<Byte2>::digits >= PAGE_TILES,
+                  "Too many tiles per page");
+
+    m_tiles = new Tile[TILE_COUNT];
+}
+
+PatternCache::~PatternCache()
+{
+    delete[] m_tiles;
+}
+
+const Byte *
+PatternCache::get_row(bool i_tbl_right, Byte i_tile_idx, Byte i_fine_y,
+                      bool i_flip_x, const VideoMemory *i_vram)
+{
+    Address tile_addr =
+        PipelineAccessor::get_sliver_addr(i_tbl_right, i_tile_idx, false, 0);
+
+    const Tile *tile;
+    const Byte *page_src = i_vram->get_read_page(tile_addr);
+    if (page_src)
+    {
+        int tile_no = (tile_addr - NH_PATTERN_ADDR_HEAD) / TILE_SIZE;
+        int page = tile_no / PAGE_TILES;
+        Byte2 tile_bit = Byte2(1 << (tile_no % PAGE_TILES));
+
+        // Bank switched
+        if (page_src != m_page_srcs[page])
+        {
+            m_page_srcs[page] = page_src;
+            m_page_valid[page] = 0;
+        }
+        if (!(m_page_valid[page] & tile_bit))
+        {
+            decode(page_src + (tile_addr & VideoMemory::PAGE_MASK),
+                   m_tiles[tile_no]);
+            m_page_valid[page] |= tile_bit;
+        }
+        tile = &m_tiles[tile_no];
+    }
+    else
+    {
+        Byte src[TILE_SIZE];
+        for (int i = 0; i < TILE_SIZE; ++i)
+        {
+            if (NH_FAILED(i_vram->get_byte(Address(tile_addr + i), src[i])))
+            {
+                src[i] = 0xFF; // set to apparent value.
+            }
+        }
+        decode(src, m_uncached);
+        tile = &m_uncached;
+    }
+
+    return i_flip_x ? tile->flipped_rows[i_fine_y] : tile->rows[i_fine_y];
+}
+
+void
+PatternCache::invalidate(Address i_addr, const VideoMemory *i_vram)
+{
+    const Byte *page_src = i_vram->get_read_page(i_addr);
+    if (!page_src)
+    {
+        return;
+    }
+
+    // Other pages may be mapped to the same bytes, e.g. both 4KB banks of MMC1
+    // selecting the same one.
+    Byte2 tile_bit = Byte2(
+        1 << ((i_addr & VideoMemory::PAGE_MASK) / TILE_SIZE % PAGE_TILES));
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        if (m_page_srcs[page] == page_src)
+        {
+            m_page_valid[page] &= Byte2(~tile_bit);
+        }
+    }
+}
+
+void
+PatternCache::invalidate_all()
+{
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        m_page_srcs[page] = nullptr;
+        m_page_valid[page] = 0;
+    }
+}
+
+void
+PatternCache::decode(const Byte *i_src, Tile &o_tile)
+{
+    static_assert(NH_PATTERN_TILE_HEIGHT * 2 == TILE_SIZE,
+                  "Invalid NH_PATTERN_TILE_HEIGHT");
+    for (int fine_y = 0; fine_y < NH_PATTERN_TILE_HEIGHT; ++fine_y)
+    {
+        Byte lower = i_src[fine_y];
+        Byte upper = i_src[fine_y + NH_PATTERN_TILE_HEIGHT];
+        for (int fine_x = 0; fine_x < ROW_SIZE; ++fine_x)
+        {
+            int shift = ROW_SIZE - 1 - fine_x;
+            Byte ptn = Byte((((upper >> shift) & 0x01) << 1) |
+                            ((lower >> shift) & 0x01));
+            o_tile.rows[fine_y][fine_x] = ptn;
+            o_tile.flipped_rows[fine_y][ROW_SIZE - 1 - fine_x] = ptn;
+        }
+    }
+}
+
+} // namespace nh
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "memory/video_memory.hpp"
+#include "spec.hpp"
+#include "types.hpp"
+
+namespace nh {
+
+/// Pattern tiles of the pattern tables decoded into rows of 2-bit pattern
+/// values, along with the horizontally flipped ones.
+/// Tiles are cached per page of video memory, keyed by the bytes the page is
+/// mapped to (i.e. the CHR bank), so bank switching needs no invalidation.
+/// Pages that are not directly readable are decoded on every access.
+struct PatternCache {
+  public:
+    PatternCache();
+    ~PatternCache();
+    NB_KLZ_DELETE_COPY_MOVE(PatternCache);
+
+    static constexpr int ROW_SIZE = 8;
+
+    /// @return ROW_SIZE pattern values, leftmost pixel first.
+    const Byte *
+    get_row(bool i_tbl_right, Byte i_tile_idx, Byte i_fine_y, bool i_flip_x,
+            const VideoMemory *i_vram);
+
+    /// Call after writing to the pattern tables, i.e. CHR RAM.
+    void
+    invalidate(Address i_addr, const VideoMemory *i_vram);
+    /// Call when the mapped memory is replaced, e.g. cartridge changed.
+    void
+    invalidate_all();
+
+  private:
+    static constexpr int TILE_SIZE = 16; // bytes, 2 planes
+    static constexpr int TILE_COUNT =
+        (NH_PATTERN_ADDR_TAIL - NH_PATTERN_ADDR_HEAD + 1) / TILE_SIZE;
+    static constexpr int PAGE_TILES = VideoMemory::PAGE_SIZE / TILE_SIZE;
+    static constexpr int PAGE_COUNT = TILE_COUNT / PAGE_TILES;
+
+    struct Tile {
+        Byte rows[NH_PATTERN_TILE_HEIGHT][ROW_SIZE];
+        Byte flipped_rows[NH_PATTERN_TILE_HEIGHT][ROW_SIZE];
+    };
+
+    static void
+    decode(const Byte *i_src, Tile &o_tile);
+
+  private:
+    Tile *m_tiles;
+    // Bytes each page was decoded from, nullptr if none.
+    const Byte *m_page_srcs[PAGE_COUNT];
+    // Bit i for tile i of the page
+    Byte2 m_page_valid[PAGE_COUNT];
+
+    Tile m_uncached;
+};
+
+} // namespace nh
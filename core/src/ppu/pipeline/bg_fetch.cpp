@@ -12,7 +12,16 @@ namespace nh {
 static void
 pv_nt_byte_fetch(PipelineAccessor *io_accessor);
 static void
-pv_tile_fetch(Cycle i_step, PipelineAccessor *io_accessor);
+pv_attr_fetch(PipelineAccessor *io_accessor);
+static Byte
+pv_sliver_fetch(PipelineAccessor *io_accessor, bool i_upper);
+
+static void
+pv_inc_hori_v(Byte2 &io_v);
+static void
+pv_inc_vert_v(Byte2 &io_v);
+static void
+pv_copy_hori_t(PipelineAccessor *io_accessor);
 
 static void
 pv_shift_regs_shift(PipelineAccessor *io_accessor);
@@ -25,179 +34,130 @@ BgFetch::BgFetch(PipelineAccessor *io_accessor)
 }
 
 void
-BgFetch::tick(Cycle i_col)
+BgFetch::tick(DotActions i_actions)
 {
-    // i_col: [1, 257] | [321, 340]
-
     // @NOTE: shift registers shift should happen before shift registers reload
-    if ((2 <= i_col && i_col <= 257) || (322 <= i_col && i_col <= 337))
+    if (i_actions & BG_SHIFT)
     {
-        /* shift */
         pv_shift_regs_shift(m_accessor);
     }
 
-    switch (i_col)
+    if (i_actions & (BG_INC_VERT | BG_INC_HORI | BG_COPY_HORI) &&
+        m_accessor->rendering_enabled())
     {
-        case 256:
+        if (i_actions & BG_INC_VERT)
         {
-            if (m_accessor->rendering_enabled())
-            {
-                /* increment Y component of v */
-                Byte2 &v = m_accessor->get_v();
-                if ((v & 0x7000) != 0x7000) // if fine Y < 7
-                {
-                    v += 0x1000; // increment fine Y
-                }
-                else
-                {
-                    v &= ~0x7000;                     // fine Y = 0
-                    Byte y = Byte((v & 0x03E0) >> 5); // let y = coarse Y
-                    if (y == 29)
-                    {
-                        y = 0;       // coarse Y = 0
-                        v ^= 0x0800; // switch vertical nametable
-                    }
-                    else if (y == 31)
-                    {
-                        y = 0; // coarse Y = 0, nametable not switched
-                    }
-                    else
-                    {
-                        y += 1; // increment coarse Y
-                    }
-                    v = (v & ~0x03E0) |
-                        ((Byte2)(y) << 5); // put coarse Y back into v
-                }
-            }
+            pv_inc_vert_v(m_accessor->get_v());
         }
-        // fall through
-        case 8:
-        case 16:
-        case 24:
-        case 32:
-        case 40:
-        case 48:
-        case 56:
-        case 64:
-        case 72:
-        case 80:
-        case 88:
-        case 96:
-        case 104:
-        case 112:
-        case 120:
-        case 128:
-        case 136:
-        case 144:
-        case 152:
-        case 160:
-        case 168:
-        case 176:
-        case 184:
-        case 192:
-        case 200:
-        case 208:
-        case 216:
-        case 224:
-        case 232:
-        case 240:
-        case 248:
-        /* first two tiles on next scanline */
-        case 328:
-        case 336:
+        if (i_actions & BG_INC_HORI)
         {
-            if (m_accessor->rendering_enabled())
-            {
-                /* increment X component of v */
-                Byte2 &v = m_accessor->get_v();
-                if ((v & 0x001F) == 31) // if coarse X == 31
-                {
-                    v &= ~0x001F; // coarse X = 0
-                    v ^= 0x0400;  // switch horizontal nametable
-                }
-                else
-                {
-                    v += 1; // increment coarse X
-                }
-            }
+            pv_inc_hori_v(m_accessor->get_v());
         }
-        break;
-
-        case 257:
+        if (i_actions & BG_COPY_HORI)
         {
-            if (m_accessor->rendering_enabled())
-            {
-                /* copies all bits related to horizontal position from t to v */
-                Byte2 &v = m_accessor->get_v();
-                const Byte2 &t = m_accessor->get_t();
-                v = (v & ~0x041F) | (t & 0x041F);
-            }
-
-            pv_shift_regs_reload(m_accessor);
+            pv_copy_hori_t(m_accessor);
         }
-        break;
+    }
+    if (i_actions & BG_RELOAD)
+    {
+        pv_shift_regs_reload(m_accessor);
+    }
 
-        /* mysterious 2 nametable byte fetches */
-        case 338:
-        case 340:
-        {
-            pv_nt_byte_fetch(m_accessor);
-        }
-        break;
-
-        case 9:
-        case 17:
-        case 25:
-        case 33:
-        case 41:
-        case 49:
-        case 57:
-        case 65:
-        case 73:
-        case 81:
-        case 89:
-        case 97:
-        case 105:
-        case 113:
-        case 121:
-        case 129:
-        case 137:
-        case 145:
-        case 153:
-        case 161:
-        case 169:
-        case 177:
-        case 185:
-        case 193:
-        case 201:
-        case 209:
-        case 217:
-        case 225:
-        case 233:
-        case 241:
-        case 249:
-        /* first two tiles on next scanline */
-        case 329:
-        case 337:
+    // @NOTE: shift registers reload should happen before tile fetch
+    if (i_actions & BG_FETCH_NT)
+    {
+        pv_nt_byte_fetch(m_accessor);
+    }
+    else if (i_actions & BG_FETCH_AT)
+    {
+        pv_attr_fetch(m_accessor);
+    }
+    else if (i_actions & BG_FETCH_LOWER)
+    {
+        m_accessor->get_context().bg_lower_sliver =
+            pv_sliver_fetch(m_accessor, false);
+    }
+    else if (i_actions & BG_FETCH_UPPER)
+    {
+        m_accessor->get_context().bg_upper_sliver =
+            pv_sliver_fetch(m_accessor, true);
+    }
+}
+
+void
+BgFetch::tick_batch(Line &o_line)
+{
+    // Same as ticking [1, 257], with the rendering flags unchanged.
+
+    auto &ctx = m_accessor->get_context();
+
+    /* the first two tiles were fetched on previous scanline */
+    o_line.pattern_lower[0] = Byte(ctx.sf_bg_pattern_lower >> 8);
+    o_line.pattern_lower[1] = Byte(ctx.sf_bg_pattern_lower);
+    o_line.pattern_upper[0] = Byte(ctx.sf_bg_pattern_upper >> 8);
+    o_line.pattern_upper[1] = Byte(ctx.sf_bg_pattern_upper);
+    o_line.palette_idx_lower[0] = Byte(ctx.sf_bg_palette_idx_lower >> 8);
+    o_line.palette_idx_lower[1] = Byte(ctx.sf_bg_palette_idx_lower);
+    o_line.palette_idx_upper[0] = Byte(ctx.sf_bg_palette_idx_upper >> 8);
+    o_line.palette_idx_upper[1] = Byte(ctx.sf_bg_palette_idx_upper);
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int fine_x = 0; fine_x < PatternCache::ROW_SIZE; ++fine_x)
         {
-            pv_shift_regs_reload(m_accessor);
+            int shift = PatternCache::ROW_SIZE - 1 - fine_x;
+            o_line.prefetched_rows[i][fine_x] =
+                Byte((((o_line.pattern_upper[i] >> shift) & 0x01) << 1) |
+                     ((o_line.pattern_lower[i] >> shift) & 0x01));
         }
-        break;
-
-        default:
-            break;
+        o_line.pattern_rows[i] = o_line.prefetched_rows[i];
     }
 
-    // @NOTE: shift registers reload should happen before tile fetch
-    if (1 <= i_col && i_col <= 256)
+    bool rendering = m_accessor->rendering_enabled();
+    for (int i = 2; i < Line::TILE_COUNT; ++i)
     {
-        pv_tile_fetch((i_col - 1) % 8, m_accessor);
+        pv_nt_byte_fetch(m_accessor);
+        pv_attr_fetch(m_accessor);
+        ctx.bg_lower_sliver = pv_sliver_fetch(m_accessor, false);
+        o_line.pattern_rows[i] = m_accessor->get_ptn_cache().get_row(
+            m_accessor->get_register(PPU::PPUCTRL) & 0x10, ctx.bg_nt_byte,
+            Byte((m_accessor->get_v() >> 12) & 0x07), false,
+            m_accessor->get_memory());
+        // v is incremented before the upper sliver fetch of the same tick.
+        if (rendering)
+        {
+            if (i + 1 == Line::TILE_COUNT)
+            {
+                pv_inc_vert_v(m_accessor->get_v());
+            }
+            pv_inc_hori_v(m_accessor->get_v());
+        }
+        ctx.bg_upper_sliver = pv_sliver_fetch(m_accessor, true);
+
+        o_line.pattern_lower[i] = ctx.bg_lower_sliver;
+        o_line.pattern_upper[i] = ctx.bg_upper_sliver;
+        o_line.palette_idx_lower[i] =
+            ctx.bg_attr_palette_idx & 0x01 ? 0xFF : 0x00;
+        o_line.palette_idx_upper[i] =
+            ctx.bg_attr_palette_idx & 0x02 ? 0xFF : 0x00;
     }
-    /* first two tiles on next scanline */
-    else if (321 <= i_col && i_col <= 336)
+
+    if (rendering)
     {
-        pv_tile_fetch((i_col - 321) % 8, m_accessor);
+        pv_copy_hori_t(m_accessor);
     }
+
+    /* 256 shifts, with the last two reloads at 249 and 257 */
+    constexpr int last = Line::TILE_COUNT - 1;
+    ctx.sf_bg_pattern_lower = Byte2(o_line.pattern_lower[last - 1] << 8) |
+                              o_line.pattern_lower[last];
+    ctx.sf_bg_pattern_upper = Byte2(o_line.pattern_upper[last - 1] << 8) |
+                              o_line.pattern_upper[last];
+    ctx.sf_bg_palette_idx_lower =
+        Byte2(o_line.palette_idx_lower[last - 1] << 8) |
+        o_line.palette_idx_lower[last];
+    ctx.sf_bg_palette_idx_upper =
+        Byte2(o_line.palette_idx_upper[last - 1] << 8) |
+        o_line.palette_idx_upper[last];
 }
 
 void
@@ -220,95 +180,115 @@ pv_nt_byte_fetch(PipelineAccessor *io_accessor)
 }
 
 void
-pv_tile_fetch(Cycle i_step, PipelineAccessor *io_accessor)
+pv_attr_fetch(PipelineAccessor *io_accessor)
 {
-    // i_step: [0, 8)
+    const Byte2 &v = io_accessor->get_v();
 
-    /* fetch pattern table tile byte */
-    auto get_pattern_sliver = [](PipelineAccessor *io_accessor,
-                                 bool i_upper) -> Byte {
-        bool tbl_right = io_accessor->get_register(PPU::PPUCTRL) & 0x10;
-        Byte tile_idx = io_accessor->get_context().bg_nt_byte;
-        Byte fine_y = Byte((io_accessor->get_v() >> 12) & 0x07);
-
-        Address sliver_addr =
-            io_accessor->get_sliver_addr(tbl_right, tile_idx, i_upper, fine_y);
-        Byte byte;
-        auto error = io_accessor->get_memory()->get_byte(sliver_addr, byte);
-        if (NH_FAILED(error))
-        {
-            NH_ASSERT_FATAL(io_accessor->get_logger(),
-                            "Failed to fetch pattern byte for bg: ${:04X}, {}",
-                            sliver_addr, i_upper);
-            byte = 0xFF; // set to apparent value.
-        }
+    int coarse_x = v & 0x001F;
+    int coarse_y = (v >> 5) & 0x001F;
 
-        return byte;
-    };
+    /* fetch attribute table byte */
+    Address attr_addr = 0x23C0 | (v & 0x0C00) |
+                        Address((coarse_y << 1) & 0x38) |
+                        Address(coarse_x >> 2);
+    Byte attr_byte;
+    auto error = io_accessor->get_memory()->get_byte(attr_addr, attr_byte);
+    if (NH_FAILED(error))
+    {
+        NH_ASSERT_FATAL(io_accessor->get_logger(),
+                        "Failed to fetch attribute byte for bg: {}, {}", v,
+                        attr_addr);
+        attr_byte = 0xFF; // set to apparent value.
+    }
+
+    // index of 2x2-tile block in 4x4-tile block.
+    int col = coarse_x % 4 / 2;
+    int row = coarse_y % 4 / 2;
+    int shifts = (row * 2 + col) * 2;
+    Byte attr_palette_idx = (attr_byte >> shifts) & 0x03;
+
+    /* fetch attribute table index */
+    io_accessor->get_context().bg_attr_palette_idx = attr_palette_idx;
+}
+
+Byte
+pv_sliver_fetch(PipelineAccessor *io_accessor, bool i_upper)
+{
+    /* fetch pattern table tile byte */
+    bool tbl_right = io_accessor->get_register(PPU::PPUCTRL) & 0x10;
+    Byte tile_idx = io_accessor->get_context().bg_nt_byte;
+    Byte fine_y = Byte((io_accessor->get_v() >> 12) & 0x07);
 
-    switch (i_step)
+    Address sliver_addr =
+        io_accessor->get_sliver_addr(tbl_right, tile_idx, i_upper, fine_y);
+    Byte byte;
+    auto error = io_accessor->get_memory()->get_byte(sliver_addr, byte);
+    if (NH_FAILED(error))
     {
-        case 1:
-        {
-            /* fetch nametable byte */
-            pv_nt_byte_fetch(io_accessor);
-        }
-        break;
+        NH_ASSERT_FATAL(io_accessor->get_logger(),
+                        "Failed to fetch pattern byte for bg: ${:04X}, {}",
+                        sliver_addr, i_upper);
+        byte = 0xFF; // set to apparent value.
+    }
 
-        case 3:
-        {
-            const Byte2 &v = io_accessor->get_v();
-
-            int coarse_x = v & 0x001F;
-            int coarse_y = (v >> 5) & 0x001F;
-
-            /* fetch attribute table byte */
-            Address attr_addr = 0x23C0 | (v & 0x0C00) |
-                                Address((coarse_y << 1) & 0x38) |
-                                Address(coarse_x >> 2);
-            Byte attr_byte;
-            auto error =
-                io_accessor->get_memory()->get_byte(attr_addr, attr_byte);
-            if (NH_FAILED(error))
-            {
-                NH_ASSERT_FATAL(io_accessor->get_logger(),
-                                "Failed to fetch attribute byte for bg: {}, {}",
-                                v, attr_addr);
-                attr_byte = 0xFF; // set to apparent value.
-            }
+    return byte;
+}
 
-            // index of 2x2-tile block in 4x4-tile block.
-            int col = coarse_x % 4 / 2;
-            int row = coarse_y % 4 / 2;
-            int shifts = (row * 2 + col) * 2;
-            Byte attr_palette_idx = (attr_byte >> shifts) & 0x03;
+void
+pv_inc_hori_v(Byte2 &io_v)
+{
+    /* increment X component of v */
+    Byte2 &v = io_v;
+    if ((v & 0x001F) == 31) // if coarse X == 31
+    {
+        v &= ~0x001F; // coarse X = 0
+        v ^= 0x0400;  // switch horizontal nametable
+    }
+    else
+    {
+        v += 1; // increment coarse X
+    }
+}
 
-            /* fetch attribute table index */
-            io_accessor->get_context().bg_attr_palette_idx = attr_palette_idx;
+void
+pv_inc_vert_v(Byte2 &io_v)
+{
+    /* increment Y component of v */
+    Byte2 &v = io_v;
+    if ((v & 0x7000) != 0x7000) // if fine Y < 7
+    {
+        v += 0x1000; // increment fine Y
+    }
+    else
+    {
+        v &= ~0x7000;                     // fine Y = 0
+        Byte y = Byte((v & 0x03E0) >> 5); // let y = coarse Y
+        if (y == 29)
+        {
+            y = 0;       // coarse Y = 0
+            v ^= 0x0800; // switch vertical nametable
         }
-        break;
-
-        case 5:
+        else if (y == 31)
         {
-            /* fetch pattern table tile low */
-            io_accessor->get_context().bg_lower_sliver =
-                get_pattern_sliver(io_accessor, false);
+            y = 0; // coarse Y = 0, nametable not switched
         }
-        break;
-
-        case 7:
+        else
         {
-            /* fetch pattern table tile high */
-            io_accessor->get_context().bg_upper_sliver =
-                get_pattern_sliver(io_accessor, true);
+            y += 1; // increment coarse Y
         }
-        break;
-
-        default:
-            break;
+        v = (v & ~0x03E0) | ((Byte2)(y) << 5); // put coarse Y back into v
     }
 }
 
+void
+pv_copy_hori_t(PipelineAccessor *io_accessor)
+{
+    /* copies all bits related to horizontal position from t to v */
+    Byte2 &v = io_accessor->get_v();
+    const Byte2 &t = io_accessor->get_t();
+    v = (v & ~0x041F) | (t & 0x041F);
+}
+
 void
 pv_shift_regs_shift(PipelineAccessor *io_accessor)
 {
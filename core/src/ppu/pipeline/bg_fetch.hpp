@@ -1,6 +1,8 @@
 #pragma once
 
 #include "nhbase/klass.hpp"
+#include "ppu/pattern_cache.hpp"
+#include "ppu/pipeline/dot_table.hpp"
 #include "types.hpp"
 
 namespace nh {
@@ -12,8 +14,29 @@ struct BgFetch {
     BgFetch(PipelineAccessor *io_accessor);
     NB_KLZ_DELETE_COPY_MOVE(BgFetch);
 
+    /// @param i_actions Those of BG_ACTIONS are done
     void
-    tick(Cycle i_col);
+    tick(DotActions i_actions);
+
+    /// Tiles shown on one scanline, as bytes of the shift registers, i.e. the
+    /// two fetched on previous scanline followed by the ones fetched on this.
+    struct Line {
+        static constexpr int TILE_COUNT = 2 + 32;
+
+        Byte pattern_lower[TILE_COUNT];
+        Byte pattern_upper[TILE_COUNT];
+        Byte palette_idx_lower[TILE_COUNT];
+        Byte palette_idx_upper[TILE_COUNT];
+
+        // Decoded pattern rows of the tiles, see PatternCache. The last tile
+        // is never shown.
+        const Byte *pattern_rows[TILE_COUNT];
+        // Rows of the first two tiles, decoded from the shift registers.
+        Byte prefetched_rows[2][PatternCache::ROW_SIZE];
+    };
+    /// Tick [1, 257] of a visible scanline at once.
+    void
+    tick_batch(Line &o_line);
 
   private:
     PipelineAccessor *m_accessor;
@@ -0,0 +1,173 @@
+#include "dot_table.hpp"
+
+#include "assert.hpp"
+
+namespace nh {
+
+static void
+pv_bg(DotActions *o_line);
+static void
+pv_sp_eval(DotActions *o_line);
+static void
+pv_sp_fetch(DotActions *o_line);
+static void
+pv_render(DotActions *o_line);
+
+DotTable::DotTable()
+    : m_actions{}
+{
+    DotActions *visible = m_actions[VISIBLE];
+    pv_render(visible);
+    pv_bg(visible);
+    pv_sp_eval(visible);
+    pv_sp_fetch(visible);
+    for (int col = 0; col < NH_SCANLINE_CYCLES; ++col)
+    {
+        if (visible[col])
+        {
+            visible[col] |= VISIBLE_LINE;
+        }
+    }
+
+    DotActions *first_visible = m_actions[FIRST_VISIBLE];
+    for (int col = 0; col < NH_SCANLINE_CYCLES; ++col)
+    {
+        first_visible[col] = visible[col];
+    }
+    // Skipped on odd frames
+    first_visible[0] |= SKIP_DOT;
+
+    m_actions[VBL_BEGIN][1] = SET_VBL;
+
+    DotActions *pre_render = m_actions[PRE_RENDER];
+    pre_render[1] |= CLEAR_FLAGS;
+    for (int col = 280; col <= 304; ++col)
+    {
+        pre_render[col] |= COPY_VERT;
+    }
+    pre_render[338] |= CHECK_SKIP;
+    pv_bg(pre_render);
+    pv_sp_fetch(pre_render);
+    for (int col = 0; col < NH_SCANLINE_CYCLES; ++col)
+    {
+        if (pre_render[col])
+        {
+            pre_render[col] |= PRE_RENDER_LINE;
+        }
+    }
+}
+
+const DotActions *
+DotTable::line(int i_idx) const
+{
+    // i_idx: [0, 261]
+
+    if (i_idx == 0)
+    {
+        return m_actions[FIRST_VISIBLE];
+    }
+    if (i_idx <= 239)
+    {
+        return m_actions[VISIBLE];
+    }
+    if (i_idx == 241)
+    {
+        return m_actions[VBL_BEGIN];
+    }
+    if (i_idx == 261)
+    {
+        return m_actions[PRE_RENDER];
+    }
+    NH_ASSERT(0 < i_idx && i_idx < 261);
+    return m_actions[IDLE];
+}
+
+void
+pv_bg(DotActions *o_line)
+{
+    // @NOTE: the order of the bits is the order they are done in, see
+    // BgFetch::tick().
+    for (int col = 1; col <= 340; ++col)
+    {
+        if (258 <= col && col <= 320)
+        {
+            continue;
+        }
+
+        if ((2 <= col && col <= 257) || (322 <= col && col <= 337))
+        {
+            o_line[col] |= BG_SHIFT;
+        }
+        if (col == 256)
+        {
+            o_line[col] |= BG_INC_VERT;
+        }
+        /* the last increment at 256, then the first two tiles on next
+         * scanline */
+        if ((col <= 256 && col % 8 == 0) || col == 328 || col == 336)
+        {
+            o_line[col] |= BG_INC_HORI;
+        }
+        if (col == 257)
+        {
+            o_line[col] |= BG_COPY_HORI;
+        }
+        if ((9 <= col && col <= 257 && col % 8 == 1) || col == 329 ||
+            col == 337)
+        {
+            o_line[col] |= BG_RELOAD;
+        }
+
+        /* mysterious 2 nametable byte fetches */
+        if (col == 338 || col == 340)
+        {
+            o_line[col] |= BG_FETCH_NT;
+        }
+        if (col <= 256 || (321 <= col && col <= 336))
+        {
+            static constexpr DotActions fetches[8] = {
+                0, BG_FETCH_NT, 0, BG_FETCH_AT, 0, BG_FETCH_LOWER, 0,
+                BG_FETCH_UPPER,
+            };
+            o_line[col] |= fetches[(col - 1) % 8];
+        }
+    }
+}
+
+void
+pv_sp_eval(DotActions *o_line)
+{
+    // Secondary OAM is written on every other tick of the clear.
+    for (int col = 2; col <= 64; col += 2)
+    {
+        o_line[col] |= SP_CLEAR;
+    }
+    o_line[65] |= SP_EVAL_BEGIN;
+    for (int col = 65; col <= 256; ++col)
+    {
+        o_line[col] |= SP_EVAL;
+    }
+}
+
+void
+pv_sp_fetch(DotActions *o_line)
+{
+    o_line[257] |= SP_FETCH_BEGIN;
+    for (int col = 257; col <= 320; ++col)
+    {
+        o_line[col] |= SP_FETCH;
+    }
+}
+
+void
+pv_render(DotActions *o_line)
+{
+    o_line[2] |= RENDER_BEGIN;
+    for (int col = 2; col <= 257; ++col)
+    {
+        o_line[col] |= RENDER;
+    }
+    o_line[257] |= RENDER_END;
+}
+
+} // namespace nh
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "spec.hpp"
+
+#include <cstdint>
+
+namespace nh {
+
+typedef std::uint32_t DotActions;
+
+// What a tick does at a dot, looked up once per tick so that the stages test
+// bits rather than each branch on the column again.
+enum DotAction : DotActions {
+    /* background */
+    BG_SHIFT = 1 << 0,       // shift the shift registers
+    BG_INC_VERT = 1 << 1,    // increment Y of v, if rendering
+    BG_INC_HORI = 1 << 2,    // increment X of v, if rendering
+    BG_COPY_HORI = 1 << 3,   // copy X from t to v, if rendering
+    BG_RELOAD = 1 << 4,      // reload the shift registers
+    BG_FETCH_NT = 1 << 5,    // nametable byte
+    BG_FETCH_AT = 1 << 6,    // attribute byte
+    BG_FETCH_LOWER = 1 << 7, // pattern sliver
+    BG_FETCH_UPPER = 1 << 8, // pattern sliver
+
+    /* sprites */
+    SP_CLEAR = 1 << 9, // write to secondary OAM while clearing it
+    SP_EVAL_BEGIN = 1 << 10,
+    SP_EVAL = 1 << 11,
+    SP_FETCH_BEGIN = 1 << 12,
+    SP_FETCH = 1 << 13, // fetch and reload, if rendering
+
+    /* pixels */
+    RENDER_BEGIN = 1 << 14,
+    RENDER = 1 << 15,
+    RENDER_END = 1 << 16, // the line is complete after this dot
+
+    /* once a frame */
+    SKIP_DOT = 1 << 17, // skipped if "skip_cycle" is set
+    SET_VBL = 1 << 18,
+    CLEAR_FLAGS = 1 << 19, // VBL, sprite 0 hit and overflow, OAM corruption
+    COPY_VERT = 1 << 20,   // copy Y from t to v, if rendering
+    CHECK_SKIP = 1 << 21,  // whether to skip a dot next frame
+
+    /* which scanline ticks the stages */
+    VISIBLE_LINE = 1 << 22,
+    PRE_RENDER_LINE = 1 << 23,
+
+    BG_ACTIONS = BG_SHIFT | BG_INC_VERT | BG_INC_HORI | BG_COPY_HORI |
+                 BG_RELOAD | BG_FETCH_NT | BG_FETCH_AT | BG_FETCH_LOWER |
+                 BG_FETCH_UPPER,
+    SP_ACTIONS = SP_CLEAR | SP_EVAL_BEGIN | SP_EVAL | SP_FETCH_BEGIN | SP_FETCH,
+};
+
+/// @brief Actions of each dot of a frame. Scanlines of a kind share theirs,
+/// which keeps it small enough to stay in cache.
+struct DotTable {
+  public:
+    DotTable();
+    NB_KLZ_DELETE_COPY_MOVE(DotTable);
+
+    /// @return Actions of scanline "i_idx" by column, NH_SCANLINE_CYCLES of
+    /// them
+    const DotActions *
+    line(int i_idx) const;
+
+  private:
+    enum LineKind {
+        FIRST_VISIBLE,
+        VISIBLE,
+        IDLE, // post-render and vblank
+        VBL_BEGIN,
+        PRE_RENDER,
+
+        LINE_KIND_COUNT,
+    };
+
+    DotActions m_actions[LINE_KIND_COUNT][NH_SCANLINE_CYCLES];
+};
+
+} // namespace nh
@@ -2,6 +2,7 @@
 
 #include "ppu/pipeline_accessor.hpp"
 #include "spec.hpp"
+#include "state_io.hpp"
 
 #define POSTRENDER_SL_IDX 261
 #define POSTRENDER_SL -1
@@ -10,10 +11,14 @@ namespace nh {
 
 static constexpr int SCANLINE_COUNT = 262;
 
+static const DotTable &
+pv_dot_table();
+
 Pipeline::Pipeline(PipelineAccessor *io_accessor)
     : m_accessor(io_accessor)
     , m_pre_render_scanline(io_accessor)
     , m_visible_scanline(io_accessor)
+    , m_dot_row(nullptr)
 {
     reset();
 }
@@ -26,6 +31,7 @@ Pipeline::reset()
     // even if each individual test passes. Don't know why.
     m_curr_scanline_idx = POSTRENDER_SL_IDX;
     m_curr_scanline_col = 0;
+    m_dot_row = pv_dot_table().line(m_curr_scanline_idx);
 
     auto &ctx = m_accessor->get_context();
     ctx.odd_frame = false;
@@ -37,37 +43,110 @@ Pipeline::reset()
 void
 Pipeline::tick()
 {
-    if (0 <= m_curr_scanline_idx && m_curr_scanline_idx <= 239)
+    DotActions actions = m_dot_row[m_curr_scanline_col];
+
+    /* Skip 1 cycle on first scanline, if current frame is odd and rendering
+     * is enabled */
+    if ((actions & SKIP_DOT) && m_accessor->get_context().skip_cycle)
     {
-        /* Skip 1 cycle on first scanline, if current frame is odd and rendering
-         * is enabled */
-        if (0 == m_curr_scanline_idx && 0 == m_curr_scanline_col)
-        {
-            if (m_accessor->get_context().skip_cycle)
-            {
-                advance_counter();
-            }
-        }
+        advance_counter();
+        actions = m_dot_row[m_curr_scanline_col];
+    }
 
-        m_visible_scanline.tick(m_curr_scanline_col);
+    if (actions & VISIBLE_LINE)
+    {
+        m_visible_scanline.tick(m_curr_scanline_col, actions);
+    }
+    else if (actions & PRE_RENDER_LINE)
+    {
+        m_pre_render_scanline.tick(m_curr_scanline_col, actions);
     }
-    else if (241 == m_curr_scanline_idx)
+    else if (actions & SET_VBL)
     {
-        if (1 == m_curr_scanline_col)
+        if (!m_accessor->no_nmi())
         {
-            if (!m_accessor->no_nmi())
-            {
-                /* Set NMI_occurred in PPU to true */
-                m_accessor->get_register(PPU::PPUSTATUS) |= 0x80;
-            }
+            /* Set NMI_occurred in PPU to true */
+            m_accessor->get_register(PPU::PPUSTATUS) |= 0x80;
         }
     }
-    else if (261 == m_curr_scanline_idx)
+
+    advance_counter();
+}
+
+int
+Pipeline::tick_batch(int i_max_ticks)
+{
+    static constexpr int BATCH_TICKS = int(VisibleScanline::BATCH_END_COL -
+                                           VisibleScanline::BATCH_BEGIN_COL) +
+                                       1;
+
+    bool visible = 0 <= m_curr_scanline_idx && m_curr_scanline_idx <= 239;
+    if (visible &&
+        Cycle(m_curr_scanline_col) == VisibleScanline::BATCH_BEGIN_COL &&
+        i_max_ticks >= BATCH_TICKS)
+    {
+        m_visible_scanline.tick_batch();
+        // Stays within the scanline
+        m_curr_scanline_col += BATCH_TICKS;
+        return BATCH_TICKS;
+    }
+
+    /* dots with nothing to do, up to the end of the scanline */
+    // Stop short of the batch, which starts on a dot with nothing to do.
+    int end_col = visible && Cycle(m_curr_scanline_col) <
+                                 VisibleScanline::BATCH_BEGIN_COL
+                      ? int(VisibleScanline::BATCH_BEGIN_COL)
+                      : NH_SCANLINE_CYCLES;
+    int ticks = 0;
+    while (ticks < i_max_ticks && m_curr_scanline_col + ticks < end_col &&
+           !m_dot_row[m_curr_scanline_col + ticks])
     {
-        m_pre_render_scanline.tick(m_curr_scanline_col);
+        ++ticks;
+    }
+    if (ticks)
+    {
+        m_curr_scanline_col += ticks - 1;
+        advance_counter();
+        return ticks;
     }
 
-    advance_counter();
+    tick();
+    return 1;
+}
+
+int
+Pipeline::ticks_to_event() const
+{
+    static constexpr int SCANLINE_CYCLES = NH_SCANLINE_CYCLES;
+    static constexpr int FRAME_CYCLES = SCANLINE_COUNT * SCANLINE_CYCLES;
+    // Positions whose tick finishes the frame, sets VBL and clears VBL, i.e.
+    // changes the NMI line. Plus the start of frame, where one tick may be
+    // skipped, to keep distances past it exact.
+    static constexpr int events[] = {
+        0,
+        239 * SCANLINE_CYCLES + 257,
+        241 * SCANLINE_CYCLES + 1,
+        261 * SCANLINE_CYCLES + 1,
+    };
+
+    int pos = m_curr_scanline_idx * SCANLINE_CYCLES + m_curr_scanline_col;
+    int ticks = FRAME_CYCLES;
+    for (int event : events)
+    {
+        int dist = (event - pos + FRAME_CYCLES) % FRAME_CYCLES;
+        if (dist < ticks)
+        {
+            ticks = dist;
+        }
+    }
+    return ticks + 1;
+}
+
+bool
+Pipeline::in_vblank() const
+{
+    return 240 <= m_curr_scanline_idx &&
+           m_curr_scanline_idx < POSTRENDER_SL_IDX;
 }
 
 void
@@ -88,6 +167,8 @@ Pipeline::advance_counter()
             ++m_curr_scanline_idx;
         }
 
+        m_dot_row = pv_dot_table().line(m_curr_scanline_idx);
+
         auto &ctx = m_accessor->get_context();
         // Set scanline number based on index
         ctx.scanline_no = m_curr_scanline_idx + 1 >= SCANLINE_COUNT
@@ -106,4 +187,22 @@ Pipeline::advance_counter()
     }
 }
 
+void
+Pipeline::serialize(StateIO &io_state)
+{
+    m_pre_render_scanline.serialize(io_state);
+    m_visible_scanline.serialize(io_state);
+
+    io_state.field(m_curr_scanline_idx);
+    io_state.field(m_curr_scanline_col);
+    m_dot_row = pv_dot_table().line(m_curr_scanline_idx);
+}
+
+const DotTable &
+pv_dot_table()
+{
+    static const DotTable table;
+    return table;
+}
+
 } // namespace nh
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "nhbase/klass.hpp"
+#include "ppu/pipeline/dot_table.hpp"
 #include "ppu/pipeline/pre_render_scanline.hpp"
 #include "ppu/pipeline/visible_scanline.hpp"
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 
 struct Pipeline {
@@ -18,6 +20,26 @@ struct Pipeline {
 
     void
     tick();
+    /// Tick up to i_max_ticks, rendering a visible scanline at once when it
+    /// fits, and running dots with nothing to do at once. Only valid if
+    /// nothing changes the registers, VRAM or OAM in between, i.e. for ticks
+    /// the PPU has deferred.
+    /// @return Ticks run, at least 1.
+    int
+    tick_batch(int i_max_ticks);
+
+    /// @return Ticks until the state observable without register access
+    /// changes, counting the tick that changes it.
+    int
+    ticks_to_event() const;
+    /// @return If the next tick is on the post-render line or in vblank, where
+    /// rendering is idle.
+    bool
+    in_vblank() const;
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     void
@@ -31,6 +53,7 @@ struct Pipeline {
 
     int m_curr_scanline_idx;
     int m_curr_scanline_col;
+    const DotActions *m_dot_row; // of the current scanline, not state
 };
 
 } // namespace nh
@@ -7,6 +7,7 @@
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 
 struct PreRenderScanline {
@@ -14,8 +15,13 @@ struct PreRenderScanline {
     PreRenderScanline(PipelineAccessor *io_accessor);
     NB_KLZ_DELETE_COPY_MOVE(PreRenderScanline);
 
+    /// @param i_actions Those of the column, see DotTable
     void
-    tick(Cycle i_col);
+    tick(Cycle i_col, DotActions i_actions);
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     PipelineAccessor *m_accessor;
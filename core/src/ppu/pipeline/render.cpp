@@ -4,6 +4,7 @@
 #include "ppu/pipeline_accessor.hpp"
 #include "assert.hpp"
 #include "types.hpp"
+#include "state_io.hpp"
 
 #include <limits>
 #include <cstring>
@@ -13,11 +14,11 @@ namespace nh {
 
 struct OutputColor {
   public:
-    constexpr OutputColor(const Color &i_clr, Byte i_pattern)
+    constexpr OutputColor(Byte i_clr, Byte i_pattern)
         : OutputColor(i_clr, i_pattern, false, false)
     {
     }
-    constexpr OutputColor(const Color &i_clr, Byte i_pattern, bool i_priority,
+    constexpr OutputColor(Byte i_clr, Byte i_pattern, bool i_priority,
                           bool i_sp_0)
         : color(i_clr)
         , pattern(i_pattern)
@@ -26,13 +27,13 @@ struct OutputColor {
     {
     }
 
-    Color color;
+    Byte color;    // palette color
     Byte pattern;  // 2-bit;
     bool priority; // sprite only. true: behind background
     bool sp_0;     // sprite only. if this is sprite 0
 };
 
-static constexpr OutputColor ColorEmpty = {{0x00, 0x00, 0x00}, 0x00};
+static constexpr OutputColor ColorEmpty = {0x00, 0x00};
 
 static OutputColor
 pv_bg_render(PipelineAccessor *io_accessor);
@@ -41,6 +42,9 @@ pv_sp_render(PipelineAccessor *io_accessor, Render::Context *io_ctx);
 static void
 pv_muxer(PipelineAccessor *io_accessor, const OutputColor &i_bg_clr,
          const OutputColor &i_sp_clr);
+template <typename T>
+static void
+pv_serialize_sps(StateIO &io_state, std::vector<T> &io_sps);
 
 Render::Render(PipelineAccessor *io_accessor)
     : m_accessor(io_accessor)
@@ -51,12 +55,12 @@ Render::Render(PipelineAccessor *io_accessor)
 }
 
 void
-Render::tick(Cycle i_col)
+Render::tick(Cycle i_col, DotActions i_actions)
 {
     // i_col: [2, 257]
 
     /* reset some states */
-    if (2 == i_col)
+    if (i_actions & RENDER_BEGIN)
     {
         // reset pixel coordinate
         if (0 == m_accessor->get_context().scanline_no)
@@ -120,11 +124,8 @@ Render::tick(Cycle i_col)
         // @TODO: Background palette hack
         // https://www.nesdev.org/wiki/PPU_palettes#The_background_palette_hack
 
-        auto get_backdrop_clr = [](PipelineAccessor *io_accessor) -> Color {
-            Byte backdrop_byte =
-                io_accessor->get_color_byte(NH_PALETTE_BACKDROP_IDX);
-            Color backdrop = io_accessor->get_palette().to_rgb(backdrop_byte);
-            return backdrop;
+        auto get_backdrop_clr = [](PipelineAccessor *io_accessor) -> Byte {
+            return io_accessor->get_color_byte(NH_PALETTE_BACKDROP_IDX);
         };
 
         OutputColor bg_clr = pv_bg_render(m_accessor);
@@ -151,10 +152,14 @@ Render::tick(Cycle i_col)
 
         pv_muxer(m_accessor, bg_clr, sp_clr);
 
-        // Mark dirty after rendering to the last dot
-        if (i_col == 257 && 239 == m_accessor->get_context().scanline_no)
+        if (i_actions & RENDER_END)
         {
-            m_accessor->finish_frame();
+            m_accessor->finish_line(m_accessor->get_context().pixel_row);
+            // Mark dirty after rendering to the last dot
+            if (239 == m_accessor->get_context().scanline_no)
+            {
+                m_accessor->finish_frame();
+            }
         }
     }
 
@@ -184,6 +189,133 @@ Render::tick(Cycle i_col)
     }
 }
 
+void
+Render::tick_batch(const BgFetch::Line &i_bg)
+{
+    auto &ctx = m_accessor->get_context();
+
+    /* reset some states */
+    if (0 == ctx.scanline_no)
+    {
+        ctx.pixel_row = 0;
+    }
+    ctx.pixel_col = 0;
+
+    Byte mask = m_accessor->get_register(PPU::PPUMASK);
+    bool bg_enabled = m_accessor->bg_enabled();
+    bool sp_enabled = m_accessor->sp_enabled();
+
+    // @TODO: Background palette hack
+    Byte colors[NH_PALETTE_SIZE];
+    for (int i = 0; i < NH_PALETTE_SIZE; ++i)
+    {
+        colors[i] = m_accessor->get_color_byte(i);
+    }
+
+    /* sprites */
+    // Per pixel: 2-bit pattern, 2-bit palette index, priority (0x20) and
+    // sprite 0 (0x40), or 0 if transparent.
+    Byte sp_pixels[NH_NES_WIDTH] = {};
+    // Don't draw sprites on the first visible scanline, see tick().
+    if (sp_enabled && 0 != ctx.scanline_no)
+    {
+        int left = (mask & 0x04) ? 0 : 8;
+        // Sprite with lower index wins, which ensures correct priority among
+        // sprites.
+        for (int i = 0; i < ctx.sp_count; ++i)
+        {
+            // If this line includes sprite 0, it must be at index 0.
+            Byte flags = (ctx.sp_attr[i] & 0x20) |
+                         ((i == 0 && ctx.with_sp0) ? 0x40 : 0x00) |
+                         Byte((ctx.sp_attr[i] & 0x03) << 2);
+            for (int fine_x = 0; fine_x < 8; ++fine_x)
+            {
+                int x = ctx.sp_pos_x[i] + fine_x;
+                if (x >= NH_NES_WIDTH)
+                {
+                    break;
+                }
+                if (x < left || (sp_pixels[x] & 0x03))
+                {
+                    continue;
+                }
+
+                // Flipping of both X and Y was done in the fetch stage already.
+                Byte bit_shift = Byte(7 - fine_x);
+                Byte pattern_data =
+                    Byte((((ctx.sf_sp_pattern_upper[i] >> bit_shift) & 0x01)
+                          << 1) |
+                         ((ctx.sf_sp_pattern_lower[i] >> bit_shift) & 0x01));
+                if (pattern_data)
+                {
+                    sp_pixels[x] = flags | pattern_data;
+                }
+            }
+        }
+    }
+
+    /* background and muxer */
+    int bg_left = (mask & 0x02) ? 0 : 8;
+    bool sp0_hit_on = bg_enabled && sp_enabled;
+    int sp0_hit_left = (mask & 0x06) == 0x06 ? 0 : 8;
+    FrameBuffer &frame_buf = m_accessor->get_frame_buf();
+    for (int x = 0; x < NH_NES_WIDTH; ++x)
+    {
+        Byte bg_pattern = 0;
+        Byte bg_palette_idx = 0;
+        if (bg_enabled && x >= bg_left)
+        {
+            int pos = x + m_accessor->get_x();
+            int tile = pos >> 3;
+            Byte bit_shift = Byte(7 - (pos & 0x07));
+            bg_pattern = i_bg.pattern_rows[tile][pos & 0x07];
+            bg_palette_idx = Byte(
+                (((i_bg.palette_idx_upper[tile] >> bit_shift) & 0x01) << 1) |
+                ((i_bg.palette_idx_lower[tile] >> bit_shift) & 0x01));
+        }
+        Byte bg_clr =
+            colors[bg_pattern ? (bg_palette_idx << 2) | bg_pattern
+                              : NH_PALETTE_BACKDROP_IDX];
+
+        Byte sp_pixel = sp_pixels[x];
+        Byte sp_pattern = sp_pixel & 0x03;
+        Byte output_clr =
+            (!sp_pattern || (bg_pattern && (sp_pixel & 0x20)))
+                ? bg_clr
+                : colors[0x10 | (sp_pixel & 0x0F)];
+
+        /* Sprite 0 hit */
+        // Same conditions as in pv_muxer
+        if (sp0_hit_on && x >= sp0_hit_left && x != 255 && bg_pattern &&
+            (sp_pixel & 0x40))
+        {
+            m_accessor->get_register(PPU::PPUSTATUS) |= 0x40;
+        }
+
+        frame_buf.write(ctx.pixel_row, x, output_clr);
+    }
+    m_accessor->finish_line(ctx.pixel_row);
+
+    // Mark dirty after rendering to the last dot
+    if (239 == ctx.scanline_no)
+    {
+        m_accessor->finish_frame();
+    }
+
+    /* pixel coordinate advance */
+    ctx.pixel_col = 0;
+    ctx.pixel_row =
+        ctx.pixel_row + 1 >= NH_NES_HEIGHT ? 0 : ctx.pixel_row + 1;
+}
+
+void
+Render::serialize(StateIO &io_state)
+{
+    pv_serialize_sps(io_state, m_ctx.to_draw_sps_f);
+    pv_serialize_sps(io_state, m_ctx.to_draw_sps_b);
+    pv_serialize_sps(io_state, m_ctx.active_sps);
+}
+
 OutputColor
 pv_bg_render(PipelineAccessor *io_accessor)
 {
@@ -220,10 +352,7 @@ pv_bg_render(PipelineAccessor *io_accessor)
                         : NH_PALETTE_BACKDROP_IDX;
     Byte idx_color_byte = io_accessor->get_color_byte(color_idx);
 
-    /* 5. conversion from index color to RGB color */
-    Color pixel = io_accessor->get_palette().to_rgb(idx_color_byte);
-
-    return {pixel, pattern_data};
+    return {idx_color_byte, pattern_data};
 }
 
 OutputColor
@@ -275,17 +404,14 @@ pv_sp_render(PipelineAccessor *io_accessor, Render::Context *io_ctx)
                          : NH_PALETTE_BACKDROP_IDX;
         Byte idx_color_byte = io_accessor->get_color_byte(color_idx);
 
-        /* 5. conversion from index color to RGB color */
-        Color pixel = io_accessor->get_palette().to_rgb(idx_color_byte);
-
-        /* 6. stuff in priority, and return */
+        /* 5. stuff in priority, and return */
         static_assert(NH_MAX_VISIBLE_SP_NUM >= 1 &&
                           std::numeric_limits<Byte>::max() >=
                               NH_MAX_VISIBLE_SP_NUM - 1,
                       "Invalid range for sprite index");
 
         // If this line includes sprite 0, it must be at index 0.
-        color = {pixel, pattern_data, (ctx.sp_attr[i] & 0x20) != 0,
+        color = {idx_color_byte, pattern_data, (ctx.sp_attr[i] & 0x20) != 0,
                  i == 0 && io_accessor->get_context().with_sp0};
         // Got non-transparent pixel
         break;
@@ -301,7 +427,7 @@ pv_muxer(PipelineAccessor *io_accessor, const OutputColor &i_bg_clr,
     /* Priority decision */
     // Check the decision table for details
     // https://www.nesdev.org/wiki/PPU_rendering#Preface
-    Color output_clr =
+    Byte output_clr =
         !i_sp_clr.pattern
             ? i_bg_clr.color
             : ((i_bg_clr.pattern && i_sp_clr.priority) ? i_bg_clr.color
@@ -345,4 +471,45 @@ pv_muxer(PipelineAccessor *io_accessor, const OutputColor &i_bg_clr,
                                        output_clr);
 }
 
+static void
+pv_serialize_sp(StateIO &io_state, Byte &io_sp)
+{
+    io_state.field(io_sp);
+}
+
+static void
+pv_serialize_sp(StateIO &io_state, std::pair<Byte, Byte> &io_sp)
+{
+    io_state.field(io_sp.first);
+    io_state.field(io_sp.second);
+}
+
+template <typename T>
+void
+pv_serialize_sps(StateIO &io_state, std::vector<T> &io_sps)
+{
+    // Always all slots, to keep the size fixed. The lists are within the
+    // reserved capacity, so loading doesn't allocate.
+    Byte count = Byte(io_sps.size());
+    io_state.field(count);
+    if (io_state.loading())
+    {
+        io_sps.resize(count < NH_MAX_VISIBLE_SP_NUM ? count
+                                                     : NH_MAX_VISIBLE_SP_NUM);
+    }
+    for (decltype(io_sps.size()) i = 0; i < NH_MAX_VISIBLE_SP_NUM; ++i)
+    {
+        T sp{};
+        if (i < io_sps.size())
+        {
+            sp = io_sps[i];
+        }
+        pv_serialize_sp(io_state, sp);
+        if (io_state.loading() && i < io_sps.size())
+        {
+            io_sps[i] = sp;
+        }
+    }
+}
+
 } // namespace nh
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "nhbase/klass.hpp"
+#include "ppu/pipeline/bg_fetch.hpp"
+#include "ppu/pipeline/dot_table.hpp"
 #include "types.hpp"
 
 #include <vector>
@@ -8,6 +10,7 @@
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 
 struct Render {
@@ -16,7 +19,14 @@ struct Render {
     NB_KLZ_DELETE_COPY_MOVE(Render);
 
     void
-    tick(Cycle i_col);
+    tick(Cycle i_col, DotActions i_actions);
+    /// Tick [2, 257] of a visible scanline at once, i.e. render the whole
+    /// line, with the registers and palette unchanged.
+    void
+    tick_batch(const BgFetch::Line &i_bg);
+
+    void
+    serialize(StateIO &io_state);
 
   public:
     struct Context {
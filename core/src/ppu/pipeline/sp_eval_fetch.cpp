@@ -4,6 +4,7 @@
 #include "ppu/pipeline_accessor.hpp"
 #include "assert.hpp"
 #include "byte_utils.hpp"
+#include "state_io.hpp"
 
 #include <cstring>
 
@@ -11,42 +12,33 @@ namespace nh {
 
 SpEvalFetch::SpEvalFetch(PipelineAccessor *io_accessor)
     : m_accessor(io_accessor)
+    , m_ctx{}
 {
 }
 
 void
-SpEvalFetch::tick(Cycle i_col)
+SpEvalFetch::tick(Cycle i_col, DotActions i_actions)
 {
     // i_col
     // [1, 320] for visible line
     // [257, 320] for pre-render line
 
-    if (1 <= i_col && i_col <= 64)
+    if (i_actions & SP_CLEAR)
     {
         pv_sec_oam_clear(i_col - 1, m_accessor);
     }
-    else if (65 <= i_col && i_col <= 256)
+    else if (i_actions & SP_EVAL)
     {
-        if (65 == i_col)
+        if (i_actions & SP_EVAL_BEGIN)
         {
-            Byte oam_addr = m_accessor->get_register(PPU::OAMADDR);
-            m_ctx.sec_oam_write_idx = 0;
-            m_ctx.cp_counter = 0;
-            // Perhaps we shouldn't cache this either
-            m_ctx.init_oam_addr = oam_addr;
-            m_ctx.n = m_ctx.m = 0;
-            m_ctx.n_overflow = false;
-            m_ctx.sp_got = 0;
-            m_ctx.sp_overflow = false;
-            m_ctx.sec_oam_written = false;
-            m_ctx.sp0_in_range = false;
+            pv_sp_eval_begin(m_accessor, &m_ctx);
         }
 
         pv_sp_eval(i_col - 65, m_accessor, &m_ctx);
     }
-    else if (257 <= i_col && i_col <= 320)
+    else if (i_actions & SP_FETCH)
     {
-        if (257 == i_col)
+        if (i_actions & SP_FETCH_BEGIN)
         {
             // Sprite evaluation is done already at tick 257
 
@@ -89,6 +81,29 @@ SpEvalFetch::tick(Cycle i_col)
 #endif
 }
 
+void
+SpEvalFetch::tick_batch()
+{
+    // Same as ticking [1, 257] of a visible line, with the rendering flags
+    // unchanged.
+
+    for (Cycle step = 0; step < 64; ++step)
+    {
+        pv_sec_oam_clear(step, m_accessor);
+    }
+
+    pv_sp_eval_begin(m_accessor, &m_ctx);
+    if (m_accessor->rendering_enabled())
+    {
+        for (Cycle step = 0; step < 192; ++step)
+        {
+            pv_sp_eval(step, m_accessor, &m_ctx);
+        }
+    }
+
+    tick(257, SP_FETCH_BEGIN | SP_FETCH);
+}
+
 void
 SpEvalFetch::pv_sec_oam_clear(Cycle i_step, PipelineAccessor *io_accessor)
 {
@@ -104,6 +119,22 @@ SpEvalFetch::pv_sec_oam_clear(Cycle i_step, PipelineAccessor *io_accessor)
     }
 }
 
+void
+SpEvalFetch::pv_sp_eval_begin(PipelineAccessor *io_accessor, Context *io_ctx)
+{
+    Byte oam_addr = io_accessor->get_register(PPU::OAMADDR);
+    io_ctx->sec_oam_write_idx = 0;
+    io_ctx->cp_counter = 0;
+    // Perhaps we shouldn't cache this either
+    io_ctx->init_oam_addr = oam_addr;
+    io_ctx->n = io_ctx->m = 0;
+    io_ctx->n_overflow = false;
+    io_ctx->sp_got = 0;
+    io_ctx->sp_overflow = false;
+    io_ctx->sec_oam_written = false;
+    io_ctx->sp0_in_range = false;
+}
+
 void
 SpEvalFetch::pv_sp_eval(Cycle i_step, PipelineAccessor *io_accessor,
                         Context *io_ctx)
@@ -424,4 +455,26 @@ SpEvalFetch::pv_sp_fetch_reload(Cycle i_step, PipelineAccessor *io_accessor,
     io_accessor->get_register(PPU::OAMADDR) = 0;
 }
 
+void
+SpEvalFetch::serialize(StateIO &io_state)
+{
+    io_state.field(m_ctx.sp_eval_bus);
+    io_state.field(m_ctx.sec_oam_write_idx);
+    io_state.field(m_ctx.cp_counter);
+    io_state.field(m_ctx.init_oam_addr);
+    io_state.field(m_ctx.n);
+    io_state.field(m_ctx.m);
+    io_state.field(m_ctx.n_overflow);
+    io_state.field(m_ctx.sp_got);
+    io_state.field(m_ctx.sp_overflow);
+    io_state.field(m_ctx.sec_oam_written);
+    io_state.field(m_ctx.sp0_in_range);
+
+    io_state.field(m_ctx.sec_oam_read_idx);
+    io_state.field(m_ctx.sp_tile_byte);
+    io_state.field(m_ctx.sp_attr_byte);
+    io_state.field(m_ctx.sp_pos_y);
+    io_state.field(m_ctx.sp_idx_reload);
+}
+
 } // namespace nh
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "nhbase/klass.hpp"
+#include "ppu/pipeline/dot_table.hpp"
 #include "types.hpp"
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 
 struct SpEvalFetch {
@@ -12,8 +14,16 @@ struct SpEvalFetch {
     SpEvalFetch(PipelineAccessor *io_accessor);
     NB_KLZ_DELETE_COPY_MOVE(SpEvalFetch);
 
+    /// @param i_actions Those of SP_ACTIONS are done
     void
-    tick(Cycle i_col);
+    tick(Cycle i_col, DotActions i_actions);
+    /// Tick [1, 257] of a visible scanline at once.
+    void
+    tick_batch();
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     PipelineAccessor *m_accessor;
@@ -44,6 +54,8 @@ struct SpEvalFetch {
     static void
     pv_sec_oam_clear(Cycle i_step, PipelineAccessor *io_accessor);
     static void
+    pv_sp_eval_begin(PipelineAccessor *io_accessor, Context *io_ctx);
+    static void
     pv_sp_eval(Cycle i_step, PipelineAccessor *io_accessor, Context *io_ctx);
     static void
     pv_sp_fetch_reload(Cycle i_step, PipelineAccessor *io_accessor,
@@ -2,6 +2,7 @@
 
 #include "spec.hpp"
 #include "ppu/pipeline_accessor.hpp"
+#include "state_io.hpp"
 
 namespace nh {
 
@@ -13,21 +14,39 @@ VisibleScanline::VisibleScanline(PipelineAccessor *io_accessor)
 }
 
 void
-VisibleScanline::tick(Cycle i_col)
+VisibleScanline::tick(Cycle i_col, DotActions i_actions)
 {
     // Rendering happens before other data priming workload
-    if (2 <= i_col && i_col <= 257)
+    if (i_actions & RENDER)
     {
-        m_render.tick(i_col);
+        m_render.tick(i_col, i_actions);
     }
-    if ((1 <= i_col && i_col <= 257) || (321 <= i_col && i_col <= 340))
+    if (i_actions & BG_ACTIONS)
     {
-        m_bg.tick(i_col);
+        m_bg.tick(i_actions);
     }
-    if (1 <= i_col && i_col <= 320)
+    if (i_actions & SP_ACTIONS)
     {
-        m_sp.tick(i_col);
+        m_sp.tick(i_col, i_actions);
     }
 }
 
+void
+VisibleScanline::tick_batch()
+{
+    // Rendering uses the shift registers as they were before fetching, which
+    // the background line keeps.
+    BgFetch::Line bg_line;
+    m_bg.tick_batch(bg_line);
+    m_render.tick_batch(bg_line);
+    m_sp.tick_batch();
+}
+
+void
+VisibleScanline::serialize(StateIO &io_state)
+{
+    m_render.serialize(io_state);
+    m_sp.serialize(io_state);
+}
+
 } // namespace nh
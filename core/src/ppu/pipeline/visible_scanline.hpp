@@ -8,6 +8,7 @@
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 
 struct VisibleScanline {
@@ -15,8 +16,21 @@ struct VisibleScanline {
     VisibleScanline(PipelineAccessor *io_accessor);
     NB_KLZ_DELETE_COPY_MOVE(VisibleScanline);
 
+    /// @param i_actions Those of the column, see DotTable
     void
-    tick(Cycle i_col);
+    tick(Cycle i_col, DotActions i_actions);
+
+    static constexpr Cycle BATCH_BEGIN_COL = 1;
+    static constexpr Cycle BATCH_END_COL = 257;
+    /// Tick [BATCH_BEGIN_COL, BATCH_END_COL] at once, i.e. fetch, evaluate and
+    /// render the whole line. Only valid if nothing changes the registers,
+    /// VRAM or OAM during it.
+    void
+    tick_batch();
+
+  public:
+    void
+    serialize(StateIO &io_state);
 
   private:
     Render m_render;
@@ -2,7 +2,6 @@
 
 #include "debug/sprite.hpp"
 #include "spec.hpp"
-#include "byte_utils.hpp"
 
 #include <limits>
 
@@ -74,6 +73,12 @@ PipelineAccessor::get_memory()
     return m_ppu->m_memory;
 }
 
+PatternCache &
+PipelineAccessor::get_ptn_cache()
+{
+    return m_ppu->m_ptn_cache;
+}
+
 Byte
 PipelineAccessor::get_color_byte(int i_idx)
 {
@@ -128,24 +133,50 @@ PipelineAccessor::no_nmi() const
     return m_ppu->m_no_nmi;
 }
 
+void
+PipelineAccessor::finish_line(int i_row)
+{
+    // Along with frames, e.g. none for frames to be taken back.
+    if (m_ppu->m_output_frames && m_ppu->m_observation.enabled())
+    {
+        m_ppu->m_observation.add_line(
+            i_row, m_ppu->m_back_buf.get_indices() + i_row * FrameBuffer::WIDTH);
+    }
+}
+
 void
 PipelineAccessor::finish_frame()
 {
+    ++m_ppu->m_frame_count;
+
     // Do these the same time as we swap the buffer to synchronize with it.
-    if (capture_palette_on())
+    if (m_ppu->m_output_captures)
     {
-        capture_palette();
+        if (capture_palette_on())
+        {
+            capture_palette();
+        }
+        if (capture_oam_on())
+        {
+            capture_oam();
+        }
+        if (capture_ptn_tbls_on())
+        {
+            capture_ptn_tbls();
+        }
     }
-    if (capture_oam_on())
+
+    if (!m_ppu->m_output_frames)
     {
-        capture_oam();
+        return;
     }
-    if (capture_ptn_tbls_on())
+    m_ppu->m_front_buf.swap(m_ppu->m_back_buf);
+    if (m_ppu->m_frame_target)
     {
-        capture_ptn_tbls();
+        m_ppu->m_front_buf.convert(m_ppu->m_frame_target,
+                                   m_ppu->m_frame_target_pitch,
+                                   m_ppu->m_frame_target_format);
     }
-
-    m_ppu->m_front_buf.swap(m_ppu->m_back_buf);
 }
 
 Address
@@ -158,17 +189,6 @@ PipelineAccessor::get_sliver_addr(bool i_tbl_right, Byte i_tile_idx,
     return sliver_addr;
 }
 
-NHErr
-PipelineAccessor::get_ptn_sliver(bool i_tbl_right, Byte i_tile_idx,
-                                 bool i_upper, Byte i_fine_y,
-                                 const VideoMemory *i_vram, Byte &o_val)
-{
-    Address sliver_addr =
-        get_sliver_addr(i_tbl_right, i_tile_idx, i_upper, i_fine_y);
-    auto error = i_vram->get_byte(sliver_addr, o_val);
-    return error;
-}
-
 void
 PipelineAccessor::resolve_sp_ptn_tbl(Byte i_tile_byte, bool i_8x16,
                                      bool i_ptn_tbl_bit, bool &o_high_ptn_tbl)
@@ -267,32 +287,9 @@ PipelineAccessor::update_oam_sprite(nhd::Sprite &o_sprite, int i_idx)
             fine_y = (NH_PATTERN_TILE_HEIGHT - 1) - fine_y;
         }
 
-        Byte ptn_bit0_byte;
-        {
-            auto error =
-                this->get_ptn_sliver(tbl_right, tile_idx, false, fine_y,
-                                     m_ppu->m_memory, ptn_bit0_byte);
-            if (NH_FAILED(error))
-            {
-                ptn_bit0_byte = 0xFF; // set to apparent value.
-            }
-        }
-        Byte ptn_bit1_byte;
-        {
-            auto error = this->get_ptn_sliver(tbl_right, tile_idx, true, fine_y,
-                                              m_ppu->m_memory, ptn_bit1_byte);
-            if (NH_FAILED(error))
-            {
-                ptn_bit1_byte = 0xFF; // set to apparent value.
-            }
-        }
-
-        // Reverse the bits to implement horizontal flipping.
-        if (flip_x)
-        {
-            reverse_byte(ptn_bit0_byte);
-            reverse_byte(ptn_bit1_byte);
-        }
+        // Horizontal flipping is done by the cache.
+        const Byte *ptn_row = m_ppu->m_ptn_cache.get_row(
+            tbl_right, tile_idx, fine_y, flip_x, m_ppu->m_memory);
 
         /* Now that we have a row of data available */
         for (int fine_x = 0; fine_x < 8; ++fine_x)
@@ -304,8 +301,7 @@ PipelineAccessor::update_oam_sprite(nhd::Sprite &o_sprite, int i_idx)
             };
 
             int addr_palette_set_offset = i_attr & 0x03; // 4-color palette
-            int ptn = (bool(ptn_bit1_byte & (0x80 >> fine_x)) << 1) |
-                      (bool(ptn_bit0_byte & (0x80 >> fine_x)) << 0);
+            int ptn = ptn_row[fine_x];
             static_assert(NH_PALETTE_SIZE == 32,
                           "Incorrect color byte position");
             Color pixel =
@@ -337,27 +333,9 @@ PipelineAccessor::capture_ptn_tbls()
             {
                 static_assert(std::numeric_limits<Byte>::max() >= 16 * 16 - 1,
                               "Type of tile index incompatible for use of "
-                              "\"get_ptn_sliver\"");
-                Byte ptn_bit0_byte;
-                {
-                    auto error = this->get_ptn_sliver(
-                        i_right, Byte(tile_idx), false, fine_y, m_ppu->m_memory,
-                        ptn_bit0_byte);
-                    if (NH_FAILED(error))
-                    {
-                        ptn_bit0_byte = 0xFF; // set to apparent value.
-                    }
-                }
-                Byte ptn_bit1_byte;
-                {
-                    auto error = this->get_ptn_sliver(
-                        i_right, Byte(tile_idx), true, fine_y, m_ppu->m_memory,
-                        ptn_bit1_byte);
-                    if (NH_FAILED(error))
-                    {
-                        ptn_bit1_byte = 0xFF; // set to apparent value.
-                    }
-                }
+                              "\"get_row\"");
+                const Byte *ptn_row = this->m_ppu->m_ptn_cache.get_row(
+                    i_right, Byte(tile_idx), fine_y, false, m_ppu->m_memory);
 
                 /* Now that we have a row of data available */
                 static_assert(nhd::PatternTable::get_tile_width() == 8,
@@ -370,8 +348,7 @@ PipelineAccessor::capture_ptn_tbls()
                         return clr;
                     };
 
-                    int ptn = (bool(ptn_bit1_byte & (0x80 >> fine_x)) << 1) |
-                              (bool(ptn_bit0_byte & (0x80 >> fine_x)) << 0);
+                    int ptn = ptn_row[fine_x];
                     static_assert(NH_PALETTE_SIZE == 32,
                                   "Incorrect color byte position");
                     Color pixel = get_palette_color(
@@ -40,6 +40,8 @@ struct PipelineAccessor final {
 
     VideoMemory *
     get_memory();
+    PatternCache &
+    get_ptn_cache();
 
     Byte
     get_color_byte(int i_idx);
@@ -61,6 +63,9 @@ struct PipelineAccessor final {
     bool
     no_nmi() const;
 
+    /// @brief Once the frame buffer has row "i_row" rendered.
+    void
+    finish_line(int i_row);
     void
     finish_frame();
 
@@ -68,9 +73,6 @@ struct PipelineAccessor final {
     static Address
     get_sliver_addr(bool i_tbl_right, Byte i_tile_idx, bool i_upper,
                     Byte i_fine_y);
-    static NHErr
-    get_ptn_sliver(bool i_tbl_right, Byte i_tile_idx, bool i_upper,
-                   Byte i_fine_y, const VideoMemory *i_vram, Byte &o_val);
 
     static void
     resolve_sp_ptn_tbl(Byte i_tile_byte, bool i_8x16, bool i_ptn_tbl_bit,
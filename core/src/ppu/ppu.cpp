@@ -4,6 +4,7 @@
 #include "ppu/pipeline_accessor.hpp"
 #include "spec.hpp"
 #include "assert.hpp"
+#include "state_io.hpp"
 
 namespace nh {
 
@@ -12,7 +13,20 @@ PPU::PPU(VideoMemory *i_memory, const NHDFlag &i_debug_flags,
     : m_regs{}
     , m_oam{}
     , m_memory(i_memory)
+    , m_pipeline_ctx{}
+    , m_back_buf(m_palette)
+    , m_front_buf(m_palette)
+    , m_frame_count(0)
+    , m_frame_target(nullptr)
+    , m_frame_target_pitch(0)
+    , m_frame_target_format(NH_PIXEL_FORMAT_RGB888)
+    , m_output_frames(true)
+    , m_output_captures(true)
+    , m_observation(m_palette)
     , m_io_db(0)
+    , m_no_nmi(false)
+    , m_pending_ticks(0)
+    , m_event_ticks(0)
     , m_debug_flags(i_debug_flags)
     , m_ptn_tbl_palette_idx(0)
     , m_logger(i_logger)
@@ -72,6 +86,8 @@ PPU::power_up()
 void
 PPU::reset()
 {
+    sync();
+
     get_register(PPUCTRL) = 0x00;
     get_register(PPUMASK) = 0x00;
     w = 0; // Latch is cleared as well
@@ -97,6 +113,11 @@ PPU::reset_trivial()
     v = t = x = 0;
 
     m_pipeline->reset();
+    m_pending_ticks = 0;
+    m_event_ticks = m_pipeline->ticks_to_event();
+
+    // The cartridge may have been replaced since.
+    m_ptn_cache.invalidate_all();
 
     m_io_db = 0;
 }
@@ -106,11 +127,44 @@ PPU::tick(bool i_no_nmi)
 {
     // @TODO: Warm up stage?
 
-    m_no_nmi = i_no_nmi;
+    if (i_no_nmi)
+    {
+        sync();
+
+        m_no_nmi = i_no_nmi;
+        m_pipeline->tick();
+        m_no_nmi = false;
+
+        m_event_ticks = m_pipeline->ticks_to_event();
+        return;
+    }
 
-    m_pipeline->tick();
+    // Nothing outside can observe the ticks until the next event, as long as
+    // others sync before affecting the PPU.
+    ++m_pending_ticks;
+    if (m_pending_ticks >= m_event_ticks)
+    {
+        sync();
+    }
+}
 
-    m_no_nmi = false;
+void
+PPU::defer_ticks(int i_ticks)
+{
+    NH_ASSERT(i_ticks < ticks_to_event());
+    m_pending_ticks += i_ticks;
+}
+
+void
+PPU::sync()
+{
+    // Nothing accessed the PPU during these, so whole scanlines can be rendered
+    // at once.
+    while (m_pending_ticks > 0)
+    {
+        m_pending_ticks -= m_pipeline->tick_batch(m_pending_ticks);
+    }
+    m_event_ticks = m_pipeline->ticks_to_event();
 }
 
 bool
@@ -119,9 +173,86 @@ PPU::nmi() const
     return (get_register(PPUCTRL) & 0x80) && (get_register(PPUSTATUS) & 0x80);
 }
 
+bool
+PPU::vbl() const
+{
+    // Up to date, since deferred ticks stop short of where it changes.
+    return get_register(PPUSTATUS) & 0x80;
+}
+
+int
+PPU::ticks_to_event() const
+{
+    return m_event_ticks - m_pending_ticks;
+}
+
+void
+PPU::serialize(StateIO &io_state)
+{
+    if (io_state.loading())
+    {
+        // Replaced by the loaded state
+        m_pending_ticks = 0;
+    }
+    else
+    {
+        sync();
+    }
+
+    io_state.bytes(m_regs, sizeof(m_regs));
+    io_state.field(m_ppudata_buf);
+    io_state.bytes(m_oam, sizeof(m_oam));
+
+    io_state.field(v);
+    io_state.field(t);
+    io_state.field(x);
+    io_state.field(w);
+
+    {
+        auto &ctx = m_pipeline_ctx;
+        io_state.field(ctx.odd_frame);
+        io_state.field(ctx.skip_cycle);
+        io_state.field(ctx.scanline_no);
+        io_state.field(ctx.pixel_row);
+        io_state.field(ctx.pixel_col);
+
+        io_state.field(ctx.bg_nt_byte);
+        io_state.field(ctx.bg_attr_palette_idx);
+        io_state.field(ctx.bg_lower_sliver);
+        io_state.field(ctx.bg_upper_sliver);
+        io_state.field(ctx.sf_bg_pattern_lower);
+        io_state.field(ctx.sf_bg_pattern_upper);
+        io_state.field(ctx.sf_bg_palette_idx_lower);
+        io_state.field(ctx.sf_bg_palette_idx_upper);
+
+        io_state.bytes(ctx.sec_oam, sizeof(ctx.sec_oam));
+        io_state.bytes(ctx.sf_sp_pattern_lower,
+                       sizeof(ctx.sf_sp_pattern_lower));
+        io_state.bytes(ctx.sf_sp_pattern_upper,
+                       sizeof(ctx.sf_sp_pattern_upper));
+        io_state.bytes(ctx.sp_attr, sizeof(ctx.sp_attr));
+        io_state.bytes(ctx.sp_pos_x, sizeof(ctx.sp_pos_x));
+        io_state.field(ctx.sp_count);
+        io_state.field(ctx.with_sp0);
+    }
+    m_pipeline->serialize(io_state);
+
+    io_state.field(m_frame_count);
+    io_state.field(m_io_db);
+
+    if (io_state.loading())
+    {
+        m_event_ticks = m_pipeline->ticks_to_event();
+        // CHR RAM may have changed.
+        m_ptn_cache.invalidate_all();
+    }
+}
+
 Byte
 PPU::read_register(Register i_reg)
 {
+    sync();
+
     if (reg_wrtie_only(i_reg))
     {
         // Open bus
@@ -196,6 +327,8 @@ PPU::read_register(Register i_reg)
 void
 PPU::write_register(Register i_reg, Byte i_val)
 {
+    sync();
+
     // fill the latch
     m_io_db = i_val;
 
@@ -216,19 +349,7 @@ PPU::write_register(Register i_reg, Byte i_val)
 
         case OAMDATA:
         {
-            // @QUIRK: "The three unimplemented bits of each sprite's byte 2 do
-            // not exist in the PPU and always read back as 0 on PPU revisions
-            // that allow reading PPU OAM through OAMDATA ($2004). This can be
-            // emulated by ANDing byte 2 with $E3 either when writing to or when
-            // reading from OAM"
-            // https://www.nesdev.org/wiki/PPU_OAM#Byte_2
-            Byte oam_addr = m_regs[OAMADDR];
-            if ((oam_addr & 0x03) == 0x02)
-            {
-                i_val &= 0xE3;
-            }
-            m_oam[oam_addr] = i_val;
-            ++m_regs[OAMADDR];
+            put_oam(i_val);
 
             // @TODO: Writes during rendering
             // https://www.nesdev.org/wiki/PPU_registers#OAM_data_($2004)_%3C%3E_read/write
@@ -293,6 +414,10 @@ PPU::write_register(Register i_reg, Byte i_val)
                                 "Failed to write PPUDATA: ${:04X}, {:02X}",
                                 vram_addr, i_val);
             }
+            if (vram_addr <= NH_PATTERN_ADDR_TAIL)
+            {
+                m_ptn_cache.invalidate(vram_addr, m_memory);
+            }
 
             inc_vram_addr();
         }
@@ -303,6 +428,37 @@ PPU::write_register(Register i_reg, Byte i_val)
     }
 }
 
+void
+PPU::write_oam(const Byte *i_data, int i_count)
+{
+    if (i_count <= 0)
+    {
+        return;
+    }
+
+    sync();
+    for (int i = 0; i < i_count; ++i)
+    {
+        put_oam(i_data[i]);
+    }
+    // As left by the last write
+    m_regs[OAMDATA] = m_io_db = i_data[i_count - 1];
+}
+
+bool
+PPU::oam_idle(int i_ticks)
+{
+    if (ticks_to_event() <= i_ticks)
+    {
+        return false;
+    }
+
+    // Rendering uses OAM from the start of the pre-render line, where an
+    // event is, to the end of the visible lines.
+    sync();
+    return !(get_register(PPUMASK) & 0x18) || m_pipeline->in_vblank();
+}
+
 bool
 PPU::reg_read_only(Register i_reg)
 {
@@ -337,12 +493,67 @@ PPU::reg_wrtie_only(Register i_reg)
     return false;
 }
 
+void
+PPU::put_oam(Byte i_val)
+{
+    // @QUIRK: "The three unimplemented bits of each sprite's byte 2 do not
+    // exist in the PPU and always read back as 0 on PPU revisions that allow
+    // reading PPU OAM through OAMDATA ($2004). This can be emulated by ANDing
+    // byte 2 with $E3 either when writing to or when reading from OAM"
+    // https://www.nesdev.org/wiki/PPU_OAM#Byte_2
+    Byte oam_addr = m_regs[OAMADDR];
+    if ((oam_addr & 0x03) == 0x02)
+    {
+        i_val &= 0xE3;
+    }
+    m_oam[oam_addr] = i_val;
+    ++m_regs[OAMADDR];
+}
+
 const FrameBuffer &
 PPU::get_frame() const
 {
     return m_front_buf;
 }
 
+void
+PPU::set_frame_target(void *o_target, int i_pitch, NHPixelFormat i_format)
+{
+    m_frame_target = o_target;
+    m_frame_target_pitch = i_pitch;
+    m_frame_target_format = i_format;
+
+    // Have the current frame there as well
+    if (m_frame_target)
+    {
+        m_front_buf.convert(m_frame_target, m_frame_target_pitch,
+                            m_frame_target_format);
+    }
+}
+
+bool
+PPU::set_observation(Byte *o_target, int i_width, int i_height, int i_pitch)
+{
+    // Deferred ticks render into what was before.
+    sync();
+    return m_observation.set_target(o_target, i_width, i_height, i_pitch);
+}
+
+Cycle
+PPU::frame_count() const
+{
+    return m_frame_count;
+}
+
+void
+PPU::set_output(bool i_frames, bool i_captures)
+{
+    // Deferred ticks belong to what was before.
+    sync();
+    m_output_frames = i_frames;
+    m_output_captures = i_captures;
+}
+
 const nhd::Palette &
 PPU::dbg_get_palette() const
 {
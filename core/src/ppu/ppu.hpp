@@ -3,7 +3,9 @@
 #include "types.hpp"
 #include "nhbase/klass.hpp"
 #include "ppu/frame_buffer.hpp"
+#include "ppu/observation.hpp"
 #include "ppu/palette_default.hpp"
+#include "ppu/pattern_cache.hpp"
 #include "memory/video_memory.hpp"
 #include "spec.hpp"
 
@@ -16,6 +18,7 @@ struct NHLogger;
 
 namespace nh {
 
+struct StateIO;
 struct PipelineAccessor;
 struct Pipeline;
 
@@ -32,11 +35,32 @@ struct PPU {
     void
     reset();
 
+    /// @brief Ticks are deferred and caught up lazily, on register access,
+    /// sync(), "i_no_nmi" or when the NMI line or frame count would change.
     void
     tick(bool i_no_nmi = false);
+    /// @brief As many tick()s at once, short of the next event, see
+    /// ticks_to_event().
+    void
+    defer_ticks(int i_ticks);
+    /// @brief Catch up deferred ticks, e.g. before the cartridge changes what
+    /// the PPU fetches.
+    void
+    sync();
 
     bool
     nmi() const;
+    /// @return The VBL flag, without the side effects of reading PPUSTATUS
+    bool
+    vbl() const;
+    /// @return Ticks until nmi(), the frame count or the VBL flag may change,
+    /// counting the tick that changes it, unless registers are accessed.
+    int
+    ticks_to_event() const;
+
+    /// @brief Frames are output rather than state, so they are left out.
+    void
+    serialize(StateIO &io_state);
 
   public:
     // https://wiki.nesdev.org/w/index.php?title=PPU_registers
@@ -60,6 +84,14 @@ struct PPU {
     read_register(Register i_reg);
     void
     write_register(Register i_reg, Byte i_val);
+    /// @brief Writes to OAMDATA one after another, as an OAM DMA does.
+    void
+    write_oam(const Byte *i_data, int i_count);
+    /// @return If no event falls within the next "i_ticks" and rendering
+    /// leaves OAM and OAMADDR alone meanwhile, so that writes to OAM among
+    /// them may be made at any one of them.
+    bool
+    oam_idle(int i_ticks);
 
   private:
     bool
@@ -67,10 +99,35 @@ struct PPU {
     bool
     reg_wrtie_only(Register i_reg);
 
+    void
+    put_oam(Byte i_val);
+
   private:
     friend struct Console;
     const FrameBuffer &
     get_frame() const;
+    friend struct Console;
+    /// @brief Convert frames into "o_target" as they complete, nullptr to
+    /// stop.
+    void
+    set_frame_target(void *o_target, int i_pitch, NHPixelFormat i_format);
+    friend struct Console;
+    /// @brief Have frames in grayscale at a reduced size in "o_target" as
+    /// their lines are rendered, nullptr to stop.
+    /// @return false if the size is larger than a frame, or rows overlap
+    bool
+    set_observation(Byte *o_target, int i_width, int i_height, int i_pitch);
+    friend struct Console;
+    /// @return Frames completed since construction, may wrap around
+    Cycle
+    frame_count() const;
+    friend struct Console;
+    /// @brief What to put out as frames complete, e.g. nothing for frames to
+    /// be taken back. Frames held back are left in the back buffer.
+    /// @param i_frames Swap buffers and convert into the frame target
+    /// @param i_captures Debug captures
+    void
+    set_output(bool i_frames, bool i_captures);
 
   private:
     /* debug */
@@ -164,10 +221,21 @@ struct PPU {
     } m_pipeline_ctx;
     Pipeline *m_pipeline;
 
+    // Before the frame buffers, which convert with it.
+    PaletteDefault m_palette;
+
     FrameBuffer m_back_buf;
     FrameBuffer m_front_buf;
+    Cycle m_frame_count;
+    // Host memory completed frames are converted into, optional
+    void *m_frame_target;
+    int m_frame_target_pitch;
+    NHPixelFormat m_frame_target_format;
+    bool m_output_frames;
+    bool m_output_captures;
+    Observation m_observation;
 
-    PaletteDefault m_palette;
+    PatternCache m_ptn_cache;
 
     // The data bus used to communicate with CPU, to implement open bus
     // behavior
@@ -178,6 +246,10 @@ struct PPU {
     // ---- temporaries for one tick
     bool m_no_nmi;
 
+    // ---- catch-up
+    int m_pending_ticks;
+    int m_event_ticks; // pending ticks to sync at
+
   private:
     /* debug */
 
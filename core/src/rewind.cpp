@@ -0,0 +1,210 @@
+#include "rewind.hpp"
+
+#include "state_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace nh {
+
+Rewind::Rewind()
+    : m_interval(0)
+    , m_frame(0)
+    , m_snapshot_frame(0)
+    , m_has_snapshot(false)
+    , m_oldest(0)
+    , m_newest(0)
+    , m_wrap_end(0)
+    , m_count(0)
+{
+}
+
+void
+Rewind::configure(int i_interval, std::size_t i_capacity)
+{
+    if (i_interval <= 0)
+    {
+        m_interval = 0;
+        // Give the memory back.
+        std::vector<Byte>().swap(m_snapshot);
+        std::vector<Byte>().swap(m_delta_buf);
+        std::vector<Byte>().swap(m_ring);
+        clear();
+        return;
+    }
+
+    m_interval = i_interval;
+    // Records refer to each other in 32-bit.
+    std::size_t capacity =
+        std::min<std::size_t>(i_capacity,
+                              std::numeric_limits<std::uint32_t>::max());
+    if (m_ring.size() != capacity)
+    {
+        m_ring.assign(capacity, 0);
+        m_count = 0;
+    }
+}
+
+bool
+Rewind::enabled() const
+{
+    return m_interval > 0;
+}
+
+void
+Rewind::clear()
+{
+    m_has_snapshot = false;
+    m_count = 0;
+}
+
+bool
+Rewind::count_frame()
+{
+    ++m_frame;
+    return !m_has_snapshot ||
+           m_frame - m_snapshot_frame >= std::uint64_t(m_interval);
+}
+
+Byte *
+Rewind::snapshot(std::size_t i_state_size)
+{
+    if (m_snapshot.size() != i_state_size)
+    {
+        m_snapshot.assign(i_state_size, 0);
+        m_delta_buf.assign(StateDelta::bound(i_state_size), 0);
+        clear();
+    }
+    return m_snapshot.data();
+}
+
+bool
+Rewind::has_snapshot() const
+{
+    return m_has_snapshot;
+}
+
+Byte *
+Rewind::delta_buf()
+{
+    return m_delta_buf.data();
+}
+
+void
+Rewind::commit(std::size_t i_delta_size)
+{
+    if (m_has_snapshot)
+    {
+        push(m_delta_buf.data(), i_delta_size, m_snapshot_frame);
+    }
+    m_has_snapshot = true;
+    m_snapshot_frame = m_frame;
+}
+
+std::uint64_t
+Rewind::step_back(std::uint64_t i_frames)
+{
+    if (!m_has_snapshot)
+    {
+        return 0;
+    }
+
+    std::uint64_t target = i_frames < m_frame ? m_frame - i_frames : 0;
+    while (m_snapshot_frame > target && m_count)
+    {
+        Record newest = get_record(m_newest);
+        if (!StateDelta::apply(m_ring.data() + m_newest + sizeof(Record),
+                               newest.size, m_snapshot.data(),
+                               m_snapshot.size()))
+        {
+            // Half applied, nothing to trust.
+            clear();
+            return 0;
+        }
+        m_snapshot_frame = newest.frame;
+        m_newest = newest.prev;
+        --m_count;
+    }
+
+    std::uint64_t frames = m_frame - m_snapshot_frame;
+    m_frame = m_snapshot_frame;
+    return frames;
+}
+
+void
+Rewind::push(const Byte *i_delta, std::size_t i_size, std::uint64_t i_frame)
+{
+    std::size_t need = sizeof(Record) + i_size;
+    if (need > m_ring.size())
+    {
+        // Older snapshots are out of reach without it.
+        m_count = 0;
+        return;
+    }
+
+    std::size_t offset = 0;
+    while (m_count)
+    {
+        std::size_t end = record_end(m_newest);
+        if (m_newest >= m_oldest)
+        {
+            if (m_ring.size() - end >= need)
+            {
+                offset = end;
+                break;
+            }
+            if (m_oldest >= need)
+            {
+                m_wrap_end = end;
+                offset = 0;
+                break;
+            }
+        }
+        else if (m_oldest - end >= need)
+        {
+            offset = end;
+            break;
+        }
+        pop_oldest();
+    }
+
+    Record record{std::uint32_t(i_size), std::uint32_t(m_newest), i_frame};
+    std::memcpy(m_ring.data() + offset, &record, sizeof(record));
+    std::memcpy(m_ring.data() + offset + sizeof(record), i_delta, i_size);
+    if (!m_count)
+    {
+        m_oldest = offset;
+    }
+    m_newest = offset;
+    ++m_count;
+}
+
+void
+Rewind::pop_oldest()
+{
+    std::size_t next = record_end(m_oldest);
+    // The older ones wrapped around, see push().
+    if (m_newest < m_oldest && next == m_wrap_end)
+    {
+        next = 0;
+    }
+    m_oldest = next;
+    --m_count;
+}
+
+auto
+Rewind::get_record(std::size_t i_offset) const -> Record
+{
+    Record record;
+    std::memcpy(&record, m_ring.data() + i_offset, sizeof(record));
+    return record;
+}
+
+std::size_t
+Rewind::record_end(std::size_t i_offset) const
+{
+    return i_offset + sizeof(Record) + get_record(i_offset).size;
+}
+
+} // namespace nh
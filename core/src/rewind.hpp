@@ -0,0 +1,91 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nh {
+
+/// @brief Snapshots every few frames for stepping back. Only the latest is
+/// kept whole, older ones are deltas to the one after, within a fixed budget
+/// and the oldest dropped first.
+struct Rewind {
+  public:
+    Rewind();
+    NB_KLZ_DELETE_COPY_MOVE(Rewind);
+
+    /// @param i_interval Frames between snapshots, 0 to turn off
+    /// @param i_capacity Bytes for the deltas
+    void
+    configure(int i_interval, std::size_t i_capacity);
+    bool
+    enabled() const;
+    /// @brief Forget all snapshots, e.g. when the state layout changes.
+    void
+    clear();
+
+    /// @brief Count a completed frame.
+    /// @return If a snapshot is due.
+    bool
+    count_frame();
+
+    /// @return The latest snapshot of "i_state_size" bytes, to save the
+    /// current state over. It's empty if it's the first, see has_snapshot().
+    Byte *
+    snapshot(std::size_t i_state_size);
+    bool
+    has_snapshot() const;
+    /// @brief Buffer for the StateDelta of saving over snapshot(), of
+    /// StateDelta::bound() bytes.
+    Byte *
+    delta_buf();
+    /// @brief Keep what was saved over snapshot().
+    /// @param i_delta_size Ignored for the first snapshot
+    void
+    commit(std::size_t i_delta_size);
+
+    /// @brief Take snapshot() back to the latest one at least "i_frames"
+    /// frames ago, or the oldest kept.
+    /// @return Frames stepped back
+    std::uint64_t
+    step_back(std::uint64_t i_frames);
+
+  private:
+    void
+    push(const Byte *i_delta, std::size_t i_size, std::uint64_t i_frame);
+    void
+    pop_oldest();
+
+    struct Record {
+        std::uint32_t size;  // of the delta following
+        std::uint32_t prev;  // offset of the one before, i.e. older
+        std::uint64_t frame; // of the snapshot it leads to
+    };
+    Record
+    get_record(std::size_t i_offset) const;
+    std::size_t
+    record_end(std::size_t i_offset) const;
+
+  private:
+    int m_interval;
+
+    std::uint64_t m_frame; // frames counted
+    std::uint64_t m_snapshot_frame;
+    std::vector<Byte> m_snapshot;
+    bool m_has_snapshot;
+
+    std::vector<Byte> m_delta_buf;
+
+    // Deltas back from the latest snapshot, each a Record and the delta in
+    // contiguous bytes, wrapping around to the start as a whole.
+    std::vector<Byte> m_ring;
+    std::size_t m_oldest;   // offset
+    std::size_t m_newest;   // offset
+    std::size_t m_wrap_end; // where the older ones end if they wrapped
+    std::size_t m_count;
+};
+
+} // namespace nh
@@ -50,6 +50,7 @@
 
 #define NH_PALETTE_SIZE 32
 #define NH_PALETTE_BACKDROP_IDX 0
+#define NH_PALETTE_COLOR_BLACK 0x0F
 #define NH_PALETTE_ADDR_HEAD 0x3F00
 #define NH_PALETTE_ADDR_TAIL 0x3FFF
 #define NH_PALETTE_ADDR_MASK 0x001F        // rightmost 5 bits
@@ -71,3 +72,5 @@
 
 #define NH_CTRL1_REG_ADDR 0x4016
 #define NH_CTRL2_REG_ADDR 0x4017
+
+#define NH_CARTRIDGE_ADDR_HEAD 0x4020
@@ -0,0 +1,520 @@
+#include "state_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nh {
+
+constexpr std::size_t StateDelta::SHORT_GAP;
+constexpr std::size_t StateDelta::MAX_RUN;
+constexpr std::size_t StateHash::STRIPE;
+constexpr std::size_t StateIO::PAGE_SIZE;
+
+static constexpr std::uint64_t HASH_PRIME1 = 11400714785074694791ull;
+static constexpr std::uint64_t HASH_PRIME2 = 14029467366897019727ull;
+static constexpr std::uint64_t HASH_PRIME3 = 1609587929392839161ull;
+static constexpr std::uint64_t HASH_PRIME4 = 9650029242287828579ull;
+static constexpr std::uint64_t HASH_PRIME5 = 2870177450012600261ull;
+
+static std::uint64_t
+pv_rotl(std::uint64_t i_val, int i_bits);
+static std::uint64_t
+pv_read64(const Byte *i_data);
+static std::uint64_t
+pv_read32(const Byte *i_data);
+static std::uint64_t
+pv_round(std::uint64_t i_acc, std::uint64_t i_input);
+
+StateDelta::StateDelta(Byte *o_buf, std::size_t i_size)
+    : m_buf(o_buf)
+    , m_size(i_size)
+    , m_pos(0)
+    , m_ok(true)
+    , m_zeros(0)
+    , m_in_run(false)
+    , m_run_pos(0)
+    , m_run_len(0)
+{
+}
+
+void
+StateDelta::diff(Byte *io_old, const Byte *i_new, std::size_t i_size)
+{
+    for (std::size_t i = 0; i < i_size; ++i)
+    {
+        Byte x = io_old[i] ^ i_new[i];
+        if (x)
+        {
+            io_old[i] = i_new[i];
+            put(x);
+        }
+        else
+        {
+            ++m_zeros;
+        }
+    }
+}
+
+void
+StateDelta::skip(std::size_t i_size)
+{
+    m_zeros += i_size;
+}
+
+std::size_t
+StateDelta::finish()
+{
+    close_run();
+    return m_pos;
+}
+
+bool
+StateDelta::ok() const
+{
+    return m_ok;
+}
+
+std::size_t
+StateDelta::bound(std::size_t i_state_size)
+{
+    // A run after a gap longer than SHORT_GAP costs no more than the gap and
+    // itself cover. Otherwise it's the first one or split at MAX_RUN, 3 more
+    // bytes each at most.
+    return i_state_size + 3 * (i_state_size / MAX_RUN + 2) + 16;
+}
+
+bool
+StateDelta::apply(const Byte *i_delta, std::size_t i_size, Byte *io_state,
+                  std::size_t i_state_size)
+{
+    std::size_t i = 0;
+    std::size_t pos = 0;
+    while (i < i_size)
+    {
+        std::uint64_t gap = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            if (i >= i_size || shift > 56)
+            {
+                return false;
+            }
+            Byte b = i_delta[i++];
+            gap |= std::uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80))
+            {
+                break;
+            }
+        }
+        if (i_size - i < 2)
+        {
+            return false;
+        }
+        std::size_t len = i_delta[i] | (std::size_t(i_delta[i + 1]) << 8);
+        i += 2;
+
+        if (gap > i_state_size - pos || len > i_state_size - pos - gap ||
+            len > i_size - i)
+        {
+            return false;
+        }
+        pos += std::size_t(gap);
+        for (std::size_t k = 0; k < len; ++k)
+        {
+            io_state[pos + k] ^= i_delta[i + k];
+        }
+        pos += len;
+        i += len;
+    }
+    return true;
+}
+
+void
+StateDelta::put(Byte i_xor)
+{
+    // A short gap costs less inline than a new run.
+    if (m_in_run && m_zeros <= SHORT_GAP && m_run_len + m_zeros < MAX_RUN)
+    {
+        for (; m_zeros; --m_zeros)
+        {
+            emit(0);
+            ++m_run_len;
+        }
+    }
+    if (!m_in_run || m_zeros || m_run_len >= MAX_RUN)
+    {
+        close_run();
+
+        std::size_t gap = m_zeros;
+        do
+        {
+            Byte b = Byte(gap & 0x7F);
+            gap >>= 7;
+            emit(gap ? Byte(b | 0x80) : b);
+        } while (gap);
+        m_run_pos = m_pos;
+        emit(0);
+        emit(0);
+        m_in_run = true;
+        m_run_len = 0;
+        m_zeros = 0;
+    }
+
+    emit(i_xor);
+    ++m_run_len;
+}
+
+void
+StateDelta::emit(Byte i_byte)
+{
+    if (m_pos >= m_size)
+    {
+        m_ok = false;
+        return;
+    }
+    m_buf[m_pos++] = i_byte;
+}
+
+void
+StateDelta::close_run()
+{
+    if (m_in_run && m_ok)
+    {
+        m_buf[m_run_pos] = Byte(m_run_len);
+        m_buf[m_run_pos + 1] = Byte(m_run_len >> 8);
+    }
+    m_in_run = false;
+}
+
+StateHash::StateHash(std::uint64_t i_seed)
+    : m_seed(i_seed)
+    , m_lanes{i_seed + HASH_PRIME1 + HASH_PRIME2, i_seed + HASH_PRIME2, i_seed,
+              i_seed - HASH_PRIME1}
+    , m_buf{}
+    , m_buf_size(0)
+    , m_total(0)
+{
+}
+
+void
+StateHash::update(const Byte *i_data, std::size_t i_size)
+{
+    m_total += i_size;
+    if (m_buf_size + i_size < STRIPE)
+    {
+        std::memcpy(m_buf + m_buf_size, i_data, i_size);
+        m_buf_size += i_size;
+        return;
+    }
+
+    if (m_buf_size)
+    {
+        std::size_t fill = STRIPE - m_buf_size;
+        std::memcpy(m_buf + m_buf_size, i_data, fill);
+        stripes(m_buf, 1);
+        i_data += fill;
+        i_size -= fill;
+        m_buf_size = 0;
+    }
+    std::size_t count = i_size / STRIPE;
+    stripes(i_data, count);
+    i_data += count * STRIPE;
+    i_size -= count * STRIPE;
+    std::memcpy(m_buf, i_data, i_size);
+    m_buf_size = i_size;
+}
+
+std::uint64_t
+StateHash::digest() const
+{
+    std::uint64_t hash;
+    if (m_total >= STRIPE)
+    {
+        hash = pv_rotl(m_lanes[0], 1) + pv_rotl(m_lanes[1], 7) +
+               pv_rotl(m_lanes[2], 12) + pv_rotl(m_lanes[3], 18);
+        for (std::uint64_t lane : m_lanes)
+        {
+            hash = (hash ^ pv_round(0, lane)) * HASH_PRIME1 + HASH_PRIME4;
+        }
+    }
+    else
+    {
+        hash = m_seed + HASH_PRIME5;
+    }
+    hash += m_total;
+
+    std::size_t i = 0;
+    for (; i + 8 <= m_buf_size; i += 8)
+    {
+        hash ^= pv_round(0, pv_read64(m_buf + i));
+        hash = pv_rotl(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+    }
+    if (i + 4 <= m_buf_size)
+    {
+        hash ^= pv_read32(m_buf + i) * HASH_PRIME1;
+        hash = pv_rotl(hash, 23) * HASH_PRIME2 + HASH_PRIME3;
+        i += 4;
+    }
+    for (; i < m_buf_size; ++i)
+    {
+        hash ^= m_buf[i] * HASH_PRIME5;
+        hash = pv_rotl(hash, 11) * HASH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void
+StateHash::stripes(const Byte *i_data, std::size_t i_count)
+{
+    // In locals, or they'd be reloaded after every read of bytes that may
+    // alias them.
+    std::uint64_t lane0 = m_lanes[0];
+    std::uint64_t lane1 = m_lanes[1];
+    std::uint64_t lane2 = m_lanes[2];
+    std::uint64_t lane3 = m_lanes[3];
+    for (std::size_t i = 0; i < i_count; ++i, i_data += STRIPE)
+    {
+        lane0 = pv_round(lane0, pv_read64(i_data));
+        lane1 = pv_round(lane1, pv_read64(i_data + 8));
+        lane2 = pv_round(lane2, pv_read64(i_data + 16));
+        lane3 = pv_round(lane3, pv_read64(i_data + 24));
+    }
+    m_lanes[0] = lane0;
+    m_lanes[1] = lane1;
+    m_lanes[2] = lane2;
+    m_lanes[3] = lane3;
+}
+
+StateIO::StateIO()
+    : m_mode(MEASURE)
+    , m_buf(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_ok(true)
+    , m_delta(nullptr)
+    , m_hash(nullptr)
+{
+}
+
+StateIO::StateIO(void *o_buf, std::size_t i_size)
+    : m_mode(SAVE)
+    , m_buf((Byte *)o_buf)
+    , m_size(i_size)
+    , m_pos(0)
+    , m_ok(true)
+    , m_delta(nullptr)
+    , m_hash(nullptr)
+{
+}
+
+StateIO::StateIO(const void *i_buf, std::size_t i_size)
+    : m_mode(LOAD)
+    // Never written through in this mode.
+    , m_buf((Byte *)i_buf)
+    , m_size(i_size)
+    , m_pos(0)
+    , m_ok(true)
+    , m_delta(nullptr)
+    , m_hash(nullptr)
+{
+}
+
+StateIO::StateIO(void *io_buf, std::size_t i_size, StateDelta &o_delta)
+    : m_mode(DELTA)
+    , m_buf((Byte *)io_buf)
+    , m_size(i_size)
+    , m_pos(0)
+    , m_ok(true)
+    , m_delta(&o_delta)
+    , m_hash(nullptr)
+{
+}
+
+StateIO::StateIO(StateHash &o_hash)
+    : m_mode(HASH)
+    , m_buf(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_ok(true)
+    , m_delta(nullptr)
+    , m_hash(&o_hash)
+{
+}
+
+bool
+StateIO::loading() const
+{
+    return LOAD == m_mode;
+}
+
+std::size_t
+StateIO::size() const
+{
+    return m_pos;
+}
+
+bool
+StateIO::ok() const
+{
+    return m_ok;
+}
+
+void
+StateIO::bytes(Byte *io_bytes, std::size_t i_size)
+{
+    if (HASH == m_mode)
+    {
+        m_pos += i_size;
+        m_hash->update(io_bytes, i_size);
+        return;
+    }
+
+    Byte *data = take(i_size);
+    if (!data)
+    {
+        return;
+    }
+
+    if (loading())
+    {
+        std::memcpy(io_bytes, data, i_size);
+    }
+    else if (DELTA == m_mode)
+    {
+        m_delta->diff(data, io_bytes, i_size);
+    }
+    else
+    {
+        std::memcpy(data, io_bytes, i_size);
+    }
+}
+
+void
+StateIO::pages(Byte *io_bytes, std::size_t i_size, std::uint64_t i_dirty)
+{
+    if (DELTA != m_mode)
+    {
+        bytes(io_bytes, i_size);
+        return;
+    }
+
+    for (std::size_t i = 0; i < i_size; i += PAGE_SIZE)
+    {
+        std::size_t size = std::min(PAGE_SIZE, i_size - i);
+        std::size_t page_no = i / PAGE_SIZE;
+        if (page_no >= 64 || ((i_dirty >> page_no) & 1))
+        {
+            bytes(io_bytes + i, size);
+        }
+        else if (take(size))
+        {
+            m_delta->skip(size);
+        }
+    }
+}
+
+void
+StateIO::uint(std::uint64_t &io_val, std::size_t i_width)
+{
+    if (HASH == m_mode)
+    {
+        Byte val[sizeof(io_val)];
+        for (std::size_t i = 0; i < i_width; ++i)
+        {
+            val[i] = Byte(io_val >> (i * 8));
+        }
+        m_pos += i_width;
+        m_hash->update(val, i_width);
+        return;
+    }
+
+    Byte *data = take(i_width);
+    if (!data)
+    {
+        return;
+    }
+
+    if (loading())
+    {
+        std::uint64_t val = 0;
+        for (std::size_t i = 0; i < i_width; ++i)
+        {
+            val |= std::uint64_t(data[i]) << (i * 8);
+        }
+        io_val = val;
+    }
+    else
+    {
+        Byte val[sizeof(io_val)];
+        for (std::size_t i = 0; i < i_width; ++i)
+        {
+            val[i] = Byte(io_val >> (i * 8));
+        }
+        if (DELTA == m_mode)
+        {
+            m_delta->diff(data, val, i_width);
+        }
+        else
+        {
+            std::memcpy(data, val, i_width);
+        }
+    }
+}
+
+Byte *
+StateIO::take(std::size_t i_size)
+{
+    if (MEASURE == m_mode)
+    {
+        m_pos += i_size;
+        return nullptr;
+    }
+    // Leave the rest untouched once something doesn't fit.
+    if (!m_ok || i_size > m_size - m_pos)
+    {
+        m_ok = false;
+        return nullptr;
+    }
+
+    Byte *data = m_buf + m_pos;
+    m_pos += i_size;
+    return data;
+}
+
+std::uint64_t
+pv_rotl(std::uint64_t i_val, int i_bits)
+{
+    return (i_val << i_bits) | (i_val >> (64 - i_bits));
+}
+
+std::uint64_t
+pv_read64(const Byte *i_data)
+{
+    // Little-endian whatever the host, for hashes to match across them.
+    // Spelled out, compilers make a single load of it, not of a loop.
+    return std::uint64_t(i_data[0]) | std::uint64_t(i_data[1]) << 8 |
+           std::uint64_t(i_data[2]) << 16 | std::uint64_t(i_data[3]) << 24 |
+           std::uint64_t(i_data[4]) << 32 | std::uint64_t(i_data[5]) << 40 |
+           std::uint64_t(i_data[6]) << 48 | std::uint64_t(i_data[7]) << 56;
+}
+
+std::uint64_t
+pv_read32(const Byte *i_data)
+{
+    return std::uint64_t(i_data[0]) | std::uint64_t(i_data[1]) << 8 |
+           std::uint64_t(i_data[2]) << 16 | std::uint64_t(i_data[3]) << 24;
+}
+
+std::uint64_t
+pv_round(std::uint64_t i_acc, std::uint64_t i_input)
+{
+    i_acc += i_input * HASH_PRIME2;
+    return pv_rotl(i_acc, 31) * HASH_PRIME1;
+}
+
+} // namespace nh
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace nh {
+
+/// @brief XOR delta between two states of the same layout, with runs of
+/// unchanged bytes squeezed out. Applying it to either state gives the other.
+struct StateDelta {
+  public:
+    StateDelta(Byte *o_buf, std::size_t i_size);
+    NB_KLZ_DELETE_COPY_MOVE(StateDelta);
+
+    /// @brief Record the change from "io_old" to "i_new", then update "io_old".
+    void
+    diff(Byte *io_old, const Byte *i_new, std::size_t i_size);
+    /// @brief Record "i_size" bytes unchanged.
+    void
+    skip(std::size_t i_size);
+    /// @return Size of the delta
+    std::size_t
+    finish();
+    /// @return If the delta fit in the buffer.
+    bool
+    ok() const;
+
+    /// @return Buffer size enough for any delta of states of "i_state_size".
+    static std::size_t
+    bound(std::size_t i_state_size);
+    /// @return false if "i_delta" isn't of a state of "i_state_size".
+    static bool
+    apply(const Byte *i_delta, std::size_t i_size, Byte *io_state,
+          std::size_t i_state_size);
+
+  private:
+    void
+    put(Byte i_xor);
+    void
+    emit(Byte i_byte);
+    void
+    close_run();
+
+  private:
+    // Format: {varint skip, u16 length, length XOR bytes} ...
+    static constexpr std::size_t SHORT_GAP = 3;
+    static constexpr std::size_t MAX_RUN = 0xFFFF;
+
+    Byte *m_buf;
+    std::size_t m_size;
+    std::size_t m_pos;
+    bool m_ok;
+
+    std::size_t m_zeros;   // unchanged bytes since the last run
+    bool m_in_run;         // a run is open
+    std::size_t m_run_pos; // of the run length
+    std::size_t m_run_len;
+};
+
+/// @brief 64-bit hash of a state streamed in pieces of any size, the same as
+/// of it in one piece. xxHash64: four independent lanes over 32-byte stripes,
+/// which keep the CPU busy rather than each waiting on the last.
+struct StateHash {
+  public:
+    StateHash(std::uint64_t i_seed);
+    NB_KLZ_DELETE_COPY_MOVE(StateHash);
+
+    void
+    update(const Byte *i_data, std::size_t i_size);
+    std::uint64_t
+    digest() const;
+
+  private:
+    void
+    stripes(const Byte *i_data, std::size_t i_count);
+
+  private:
+    static constexpr std::size_t STRIPE = 32;
+
+    std::uint64_t m_seed;
+    std::uint64_t m_lanes[4];
+    Byte m_buf[STRIPE]; // short of a stripe
+    std::size_t m_buf_size;
+    std::uint64_t m_total;
+};
+
+/// @brief Saves or loads states of components, so that one function per
+/// component describes both directions and the layout can't drift apart.
+/// Fields are of fixed width, little-endian. Without a buffer, it only
+/// measures the size.
+struct StateIO {
+  public:
+    /// @brief Measure only
+    StateIO();
+    /// @brief Save to "o_buf"
+    StateIO(void *o_buf, std::size_t i_size);
+    /// @brief Load from "i_buf"
+    StateIO(const void *i_buf, std::size_t i_size);
+    /// @brief Save over the previous state in "io_buf", recording what changed
+    /// into "o_delta".
+    StateIO(void *io_buf, std::size_t i_size, StateDelta &o_delta);
+    /// @brief Hash what would be saved into "o_hash", without a buffer.
+    StateIO(StateHash &o_hash);
+    NB_KLZ_DELETE_COPY_MOVE(StateIO);
+
+    bool
+    loading() const;
+    /// @return Bytes saved, loaded or measured so far.
+    std::size_t
+    size() const;
+    /// @return If all fields so far fit in the buffer.
+    bool
+    ok() const;
+
+    /// @brief Integers, enums and bool.
+    template <typename T>
+    void
+    field(T &io_val);
+    void
+    bytes(Byte *io_bytes, std::size_t i_size);
+    /// @brief Like bytes(), but saving over a previous state only pages
+    /// flagged in "i_dirty", one bit per PAGE_SIZE bytes. The others must be
+    /// unchanged since.
+    void
+    pages(Byte *io_bytes, std::size_t i_size, std::uint64_t i_dirty);
+
+    static constexpr std::size_t PAGE_SIZE = 256;
+
+  private:
+    void
+    uint(std::uint64_t &io_val, std::size_t i_width);
+    Byte *
+    take(std::size_t i_size);
+
+  private:
+    enum Mode {
+        MEASURE,
+        SAVE,
+        LOAD,
+        DELTA,
+        HASH,
+    };
+    Mode m_mode;
+    Byte *m_buf;
+    std::size_t m_size;
+    std::size_t m_pos;
+    bool m_ok;
+    StateDelta *m_delta;
+    StateHash *m_hash;
+};
+
+template <typename T>
+void
+StateIO::field(T &io_val)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "Not a plain field");
+    // Cycle counters are 64-bit regardless of the platform, so that states
+    // move between them.
+    constexpr std::size_t width =
+        std::is_same<T, bool>::value
+            ? 1
+            : (std::is_same<T, Cycle>::value ? 8 : sizeof(T));
+    static_assert(width <= sizeof(std::uint64_t), "Field too wide");
+
+    std::uint64_t val = 0;
+    if (!loading())
+    {
+        val = std::uint64_t(io_val);
+    }
+    uint(val, width);
+    if (loading())
+    {
+        io_val = std::is_same<T, bool>::value ? T(val != 0) : T(val);
+    }
+}
+
+} // namespace nh
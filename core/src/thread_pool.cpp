@@ -0,0 +1,195 @@
+#include "thread_pool.hpp"
+
+namespace nh {
+
+static std::uint64_t
+pv_range(std::uint64_t i_begin, std::uint64_t i_end);
+
+ThreadPool::ThreadPool(int i_threads)
+    : m_generation(0)
+    , m_busy(0)
+    , m_stop(false)
+    , m_task(nullptr)
+    , m_user(nullptr)
+{
+#ifdef NH_TGT_WEB
+    // No threads to spare.
+    i_threads = 1;
+#else
+    if (i_threads <= 0)
+    {
+        i_threads = int(std::thread::hardware_concurrency());
+    }
+#endif
+    if (i_threads <= 0)
+    {
+        i_threads = 1;
+    }
+
+    m_shares = std::vector<Share>(std::size_t(i_threads));
+    for (auto &share : m_shares)
+    {
+        share.range = 0;
+    }
+    for (int i = 1; i < i_threads; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::worker_main, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start_cv.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+int
+ThreadPool::threads() const
+{
+    return int(m_shares.size());
+}
+
+void
+ThreadPool::run(std::size_t i_count, Task i_task, void *io_user)
+{
+    if (!i_count)
+    {
+        return;
+    }
+
+    std::size_t threads = m_shares.size();
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        m_shares[i].range = pv_range(i_count * i / threads,
+                                     i_count * (i + 1) / threads);
+    }
+    m_task = i_task;
+    m_user = io_user;
+
+    if (!m_workers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_generation;
+            m_busy = int(m_workers.size());
+        }
+        m_start_cv.notify_all();
+    }
+
+    work(0);
+
+    if (!m_workers.empty())
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [this]() { return !m_busy; });
+    }
+}
+
+void
+ThreadPool::worker_main(int i_worker)
+{
+    std::uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cv.wait(lock, [this, generation]() {
+                return m_stop || m_generation != generation;
+            });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        work(i_worker);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            last = !--m_busy;
+        }
+        if (last)
+        {
+            m_done_cv.notify_one();
+        }
+    }
+}
+
+void
+ThreadPool::work(int i_worker)
+{
+    std::size_t index = 0;
+    while (pop(i_worker, index))
+    {
+        m_task(index, m_user);
+    }
+
+    int threads = int(m_shares.size());
+    for (int i = 1; i < threads; ++i)
+    {
+        int victim = (i_worker + i) % threads;
+        while (steal(victim, index))
+        {
+            m_task(index, m_user);
+        }
+    }
+}
+
+bool
+ThreadPool::pop(int i_worker, std::size_t &o_index)
+{
+    auto &range = m_shares[std::size_t(i_worker)].range;
+    std::uint64_t val = range.load();
+    for (;;)
+    {
+        std::uint64_t begin = val >> 32;
+        std::uint64_t end = val & 0xFFFFFFFF;
+        if (begin >= end)
+        {
+            return false;
+        }
+        if (range.compare_exchange_weak(val, pv_range(begin + 1, end)))
+        {
+            o_index = std::size_t(begin);
+            return true;
+        }
+    }
+}
+
+bool
+ThreadPool::steal(int i_worker, std::size_t &o_index)
+{
+    auto &range = m_shares[std::size_t(i_worker)].range;
+    std::uint64_t val = range.load();
+    for (;;)
+    {
+        std::uint64_t begin = val >> 32;
+        std::uint64_t end = val & 0xFFFFFFFF;
+        if (begin >= end)
+        {
+            return false;
+        }
+        if (range.compare_exchange_weak(val, pv_range(begin, end - 1)))
+        {
+            o_index = std::size_t(end - 1);
+            return true;
+        }
+    }
+}
+
+std::uint64_t
+pv_range(std::uint64_t i_begin, std::uint64_t i_end)
+{
+    return (i_begin << 32) | i_end;
+}
+
+} // namespace nh
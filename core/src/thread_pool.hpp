@@ -0,0 +1,72 @@
+#pragma once
+
+#include "nhbase/klass.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nh {
+
+/// @brief Runs a task over a range of indices on all threads at once. The
+/// range is split evenly, and threads done with their share steal from the
+/// back of others', so that a few slow indices don't hold the rest up.
+struct ThreadPool {
+  public:
+    typedef void (*Task)(std::size_t i_index, void *io_user);
+
+  public:
+    /// @param i_threads Including the calling one, 0 for one per hardware
+    /// thread
+    ThreadPool(int i_threads);
+    ~ThreadPool();
+    NB_KLZ_DELETE_COPY_MOVE(ThreadPool);
+
+    int
+    threads() const;
+
+    /// @brief Run "i_task" for each index in [0, i_count) and wait for all,
+    /// the calling thread taking a share.
+    /// @param i_count Less than 2^32
+    void
+    run(std::size_t i_count, Task i_task, void *io_user);
+
+  private:
+    void
+    worker_main(int i_worker);
+    void
+    work(int i_worker);
+
+    bool
+    pop(int i_worker, std::size_t &o_index);
+    bool
+    steal(int i_worker, std::size_t &o_index);
+
+  private:
+    // [begin, end) of indices left, begin in the high half, taken from the
+    // front by the owner and from the back by thieves.
+    struct Share {
+        std::atomic<std::uint64_t> range;
+        // Apart from the others' in cache, as they change all the time.
+        char pad[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+    std::vector<Share> m_shares;
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start_cv;
+    std::condition_variable m_done_cv;
+    std::uint64_t m_generation; // of run() calls
+    int m_busy;                 // workers not done with this run yet
+    bool m_stop;
+
+    Task m_task;
+    void *m_user;
+};
+
+} // namespace nh
@@ -0,0 +1,22 @@
+#include "rom_test.hpp"
+
+#include <string>
+
+class apu_test : public nht::RomTest {};
+
+TEST_P(apu_test, rom_singles)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    std::string text;
+    EXPECT_EQ(nht::run_blargg_test(console, 600, &text), 0) << text;
+}
+
+INSTANTIATE_TEST_SUITE_P(rom_singles, apu_test,
+                         ::testing::Values("1-len_ctr.nes", "2-len_table.nes",
+                                           "3-irq_flag.nes", "4-jitter.nes",
+                                           "5-len_timing.nes",
+                                           "6-irq_flag_timing.nes",
+                                           "7-dmc_basics.nes",
+                                           "8-dmc_rates.nes"));
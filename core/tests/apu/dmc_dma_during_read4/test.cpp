@@ -0,0 +1,73 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+
+static ::testing::AssertionResult
+pv_run_crc_test(NHConsole io_console,
+                std::initializer_list<std::uint32_t> i_crcs);
+
+class dmc_dma_test : public nht::ConsoleTest<> {};
+
+TEST_F(dmc_dma_test, dma_2007_read)
+{
+    console = nht::new_console("dma_2007_read.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_TRUE(pv_run_crc_test(console, {0x159A7A8F, 0x5E3DF9C4}));
+}
+
+TEST_F(dmc_dma_test, dma_2007_write)
+{
+    console = nht::new_console("dma_2007_write.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_TRUE(pv_run_crc_test(console, {0x28F53CA4}));
+}
+
+TEST_F(dmc_dma_test, dma_4016_read)
+{
+    console = nht::new_console("dma_4016_read.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_TRUE(pv_run_crc_test(console, {0xF0AB808C}));
+}
+
+TEST_F(dmc_dma_test, double_2007_read)
+{
+    console = nht::new_console("double_2007_read.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_TRUE(pv_run_crc_test(
+        console, {0x85CFD627, 0xF018C287, 0x440EF923, 0xE52F41A5}));
+}
+
+TEST_F(dmc_dma_test, read_write_2007)
+{
+    console = nht::new_console("read_write_2007.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_TRUE(pv_run_crc_test(console, {0x0F877C4B}));
+}
+
+::testing::AssertionResult
+pv_run_crc_test(NHConsole io_console,
+                std::initializer_list<std::uint32_t> i_crcs)
+{
+    // The ROMs keep the CRC of what they read inverted at $10-$13, which
+    // matches one of those of the hardware revisions when done.
+    const NHByte *ram = nh_get_ram(io_console);
+    constexpr int MAX_FRAMES = 60;
+    std::uint32_t crc = 0;
+    for (int i = 0; i < MAX_FRAMES; ++i)
+    {
+        nh_run_frame(io_console);
+        crc = ~(std::uint32_t(ram[0x10]) | std::uint32_t(ram[0x11]) << 8 |
+                std::uint32_t(ram[0x12]) << 16 |
+                std::uint32_t(ram[0x13]) << 24);
+        for (std::uint32_t expected : i_crcs)
+        {
+            if (crc == expected)
+            {
+                return ::testing::AssertionSuccess();
+            }
+        }
+    }
+    return ::testing::AssertionFailure()
+           << std::hex << std::uppercase << "CRC " << crc;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <cstdio>
+
+#include "nesish/nesish.h"
+#include "nhbase/path.hpp"
+
+namespace nht {
+
+inline void
+pv_log(NHLogLevel level, const char *msg, void *user)
+{
+    (void)(user);
+    printf("%d: %s\n", level, msg);
+}
+
+inline NHLogger *
+logger()
+{
+    static NHLogger s_logger{pv_log, nullptr, NH_LOG_ERROR};
+    return &s_logger;
+}
+
+/// @brief Power up a new console with ROM "i_rom" next to the executable
+/// inserted, both controllers plugged with no button held.
+/// @return NH_NULL on failure
+inline NHConsole
+new_console(const std::string &i_rom)
+{
+    NHConsole console = nh_new_console(logger());
+    if (!NH_VALID(console))
+    {
+        return NH_NULL;
+    }
+    auto rom_path = nb::resolve_exe_dir(i_rom);
+    if (NH_FAILED(nh_insert_cartridge(console, rom_path.c_str())))
+    {
+        nh_release_console(console);
+        return NH_NULL;
+    }
+    nh_set_buttons(console, NH_CTRL_P1, 0);
+    nh_set_buttons(console, NH_CTRL_P2, 0);
+    nh_power_up(console);
+    return console;
+}
+
+/// @brief Path next to the executable for a file of the running test, named
+/// after it and its parameter, so that tests run in parallel don't share any.
+inline std::string
+test_file(const std::string &i_ext)
+{
+    const ::testing::TestInfo *info =
+        ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string(info->test_suite_name()) + "." +
+                       info->name() + i_ext;
+    for (char &c : name)
+    {
+        if (c == '/')
+        {
+            c = '_';
+        }
+    }
+    return nb::resolve_exe_dir(name);
+}
+
+/// @brief Fixture releasing "console" after each test.
+template <typename Base = ::testing::Test>
+class ConsoleTest : public Base {
+  protected:
+    void
+    SetUp() override
+    {
+        console = NH_NULL;
+    }
+
+    void
+    TearDown() override
+    {
+        if (NH_VALID(console))
+        {
+            nh_release_console(console);
+        }
+    }
+
+    NHConsole console;
+};
+
+/// @brief Fixture of a test run on each ROM of its parameters.
+typedef ConsoleTest<::testing::TestWithParam<const char *>> RomTest;
+
+/// @brief Run a ROM reporting through PRG RAM as blargg's tests do: status at
+/// $6000, signature DE B0 61 at $6001 and text from $6004.
+/// @param o_text Optional, text output of the test
+/// @return Status, 0 if passed, or -1 if not done within "i_max_frames"
+inline int
+run_blargg_test(NHConsole io_console, int i_max_frames, std::string *o_text)
+{
+    constexpr int RUNNING = 0x80;
+    constexpr int NEED_RESET = 0x81;
+    // The reset has to come at least 100 msec later.
+    constexpr int RESET_DELAY = 8;
+
+    int reset_in = -1;
+    for (int frame = 0; frame < i_max_frames; ++frame)
+    {
+        nh_run_frame(io_console);
+        if (reset_in >= 0 && reset_in-- == 0)
+        {
+            nh_reset(io_console);
+            continue;
+        }
+
+        std::size_t size = 0;
+        const NHByte *prg_ram = nh_get_prg_ram(io_console, &size);
+        if (!prg_ram || size < 4 || prg_ram[1] != 0xDE || prg_ram[2] != 0xB0 ||
+            prg_ram[3] != 0x61)
+        {
+            continue;
+        }
+
+        int status = prg_ram[0];
+        if (status == RUNNING)
+        {
+            continue;
+        }
+        if (status == NEED_RESET)
+        {
+            if (reset_in < 0)
+            {
+                reset_in = RESET_DELAY;
+            }
+            continue;
+        }
+
+        if (o_text)
+        {
+            o_text->clear();
+            for (std::size_t i = 4; i < size && prg_ram[i]; ++i)
+            {
+                o_text->push_back(char(prg_ram[i]));
+            }
+        }
+        return status;
+    }
+    return -1;
+}
+
+} // namespace nht
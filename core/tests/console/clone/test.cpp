@@ -0,0 +1,65 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class clone_test : public nht::RomTest {
+  protected:
+    void
+    SetUp() override
+    {
+        nht::RomTest::SetUp();
+        clone = NH_NULL;
+    }
+
+    void
+    TearDown() override
+    {
+        if (NH_VALID(clone))
+        {
+            nh_release_console(clone);
+        }
+        nht::RomTest::TearDown();
+    }
+
+    NHConsole clone;
+};
+
+TEST_P(clone_test, mid_frame)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    for (int i = 0; i < 20; ++i)
+    {
+        nh_run_frame(console);
+    }
+    nh_run_cycles(console, 12345);
+
+    ASSERT_EQ(nh_clone_console(console, &clone), NH_ERR_OK);
+    ASSERT_TRUE(NH_VALID(clone));
+    EXPECT_EQ(nh_state_hash(clone), nh_state_hash(console));
+
+    constexpr int FRAMES = 120;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        NHByte buttons = NHByte(i * 37);
+        nh_set_buttons(console, NH_CTRL_P1, buttons);
+        nh_set_buttons(clone, NH_CTRL_P1, buttons);
+        NHCycle cycles = nh_run_frame(console);
+        ASSERT_EQ(nh_run_frame(clone), cycles) << "frame " << i;
+        ASSERT_EQ(nh_state_hash(clone), nh_state_hash(console))
+            << "frame " << i;
+    }
+
+    // Independent of each other
+    nh_release_console(console);
+    console = NH_NULL;
+    nh_run_frame(clone);
+    EXPECT_NE(nh_state_hash(clone), 0u);
+}
+
+// CNROM, NROM reading the controllers and MMC1
+INSTANTIATE_TEST_SUITE_P(roms, clone_test,
+                         ::testing::Values("cpu_dummy_reads.nes",
+                                           "dma_4016_read.nes",
+                                           "apu_test.nes"));
@@ -0,0 +1,225 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::vector<NHByte>
+pv_read_file(const std::string &i_path);
+static void
+pv_write_file(const std::string &i_path, const std::vector<NHByte> &i_bytes);
+
+class movie_test : public nht::RomTest {
+  protected:
+    void
+    SetUp() override
+    {
+        nht::RomTest::SetUp();
+        movie = NH_NULL;
+        loaded = NH_NULL;
+        path = nht::test_file(".nhm");
+    }
+
+    void
+    TearDown() override
+    {
+        if (NH_VALID(loaded))
+        {
+            nh_release_movie(loaded);
+        }
+        if (NH_VALID(movie))
+        {
+            nh_release_movie(movie);
+        }
+        std::remove(path.c_str());
+        nht::RomTest::TearDown();
+    }
+
+    /// @brief Record "i_frames" frames into "movie" on "console", input
+    /// changing every few frames and a reset halfway.
+    /// @return State hash after each frame
+    std::vector<std::uint64_t>
+    record(int i_frames)
+    {
+        std::vector<std::uint64_t> hashes;
+        for (int i = 0; i < i_frames; ++i)
+        {
+            NHMovieEvent events = i == i_frames / 2 ? NH_MOVIE_EVENT_RESET
+                                                    : NH_MOVIE_EVENT_NONE;
+            NHErr err = nh_movie_record(movie, console, NHByte(i / 10 * 29),
+                                        NHByte(i / 25 * 3), events);
+            if (NH_FAILED(err))
+            {
+                ADD_FAILURE() << "Recording frame " << i << ": " << err;
+                break;
+            }
+            hashes.push_back(nh_state_hash(console));
+        }
+        return hashes;
+    }
+
+    NHMovie movie;
+    NHMovie loaded;
+    std::string path;
+};
+
+TEST_P(movie_test, round_trip)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    // Whatever ran before the first frame doesn't matter.
+    for (int i = 0; i < 7; ++i)
+    {
+        nh_run_frame(console);
+    }
+    movie = nh_new_movie(nht::logger());
+    ASSERT_TRUE(NH_VALID(movie));
+    constexpr int FRAMES = 200;
+    std::vector<std::uint64_t> hashes = record(FRAMES);
+    ASSERT_EQ(nh_movie_frames(movie), std::size_t(FRAMES));
+    ASSERT_EQ(nh_save_movie(movie, path.c_str()), NH_ERR_OK);
+
+    ASSERT_EQ(nh_load_movie(path.c_str(), nht::logger(), &loaded), NH_ERR_OK);
+    ASSERT_EQ(nh_movie_frames(loaded), std::size_t(FRAMES));
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        ASSERT_EQ(nh_movie_play(loaded, console, std::size_t(i)), NH_ERR_OK);
+        ASSERT_EQ(nh_state_hash(console), hashes[i]) << "frame " << i;
+    }
+    EXPECT_EQ(nh_movie_play(loaded, console, FRAMES), NH_ERR_INVALID_ARGUMENT);
+}
+
+TEST_P(movie_test, rejects_bad_files)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    movie = nh_new_movie(nht::logger());
+    ASSERT_TRUE(NH_VALID(movie));
+    record(100);
+    ASSERT_EQ(nh_save_movie(movie, path.c_str()), NH_ERR_OK);
+    const std::vector<NHByte> good = pv_read_file(path);
+    // Header of 16 bytes, then runs of 5
+    ASSERT_GT(good.size(), 16u + 5u);
+
+    auto expect_corrupted = [this](const std::vector<NHByte> &i_bytes,
+                                   const char *i_what) {
+        pv_write_file(path, i_bytes);
+        NHMovie bad = NH_NULL;
+        EXPECT_EQ(nh_load_movie(path.c_str(), nht::logger(), &bad),
+                  NH_ERR_CORRUPTED)
+            << i_what;
+        if (NH_VALID(bad))
+        {
+            nh_release_movie(bad);
+        }
+    };
+
+    std::vector<NHByte> bytes(good.begin(), good.end() - 1);
+    expect_corrupted(bytes, "truncated run");
+    bytes.assign(good.begin(), good.end() - 5);
+    expect_corrupted(bytes, "missing run");
+    bytes.assign(good.begin(), good.begin() + 10);
+    expect_corrupted(bytes, "truncated header");
+
+    bytes = good;
+    bytes.push_back(0);
+    expect_corrupted(bytes, "trailing byte");
+    bytes = good;
+    bytes.insert(bytes.end(), {1, 0, 0, 0, 0});
+    expect_corrupted(bytes, "trailing run");
+
+    bytes = good;
+    bytes[0] ^= 0x01;
+    expect_corrupted(bytes, "magic");
+    bytes = good;
+    bytes[4] ^= 0x01;
+    expect_corrupted(bytes, "version");
+
+    // More frames than the runs there can hold, not to be allocated.
+    bytes.assign(good.begin(), good.begin() + 16);
+    bytes[12] = bytes[13] = bytes[14] = bytes[15] = 0xFF;
+    expect_corrupted(bytes, "frame count overflow");
+    bytes.assign(good.begin(), good.begin() + 16 + 5);
+    bytes[12] = bytes[13] = bytes[14] = bytes[15] = 0xFF;
+    expect_corrupted(bytes, "frame count beyond the runs");
+
+    // And the good one still loads.
+    pv_write_file(path, good);
+    ASSERT_EQ(nh_load_movie(path.c_str(), nht::logger(), &loaded), NH_ERR_OK);
+    EXPECT_EQ(nh_movie_frames(loaded), 100u);
+}
+
+TEST_P(movie_test, seek)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    movie = nh_new_movie(nht::logger());
+    ASSERT_TRUE(NH_VALID(movie));
+    constexpr int FRAMES = 200;
+    std::vector<std::uint64_t> hashes = record(FRAMES);
+
+    auto index_path = nht::test_file(".nhx");
+    ASSERT_EQ(nh_build_movie_index(movie, console, 32, index_path.c_str()),
+              NH_ERR_OK);
+    NHMovieIndex index = NH_NULL;
+    ASSERT_EQ(nh_open_movie_index(index_path.c_str(), movie, nht::logger(),
+                                  &index),
+              NH_ERR_OK);
+
+    // Forward and back, on snapshots and between, then play on.
+    for (int frame : {1, 31, 32, 33, 150, 64, 100, 199, 2, 199})
+    {
+        ASSERT_EQ(nh_movie_seek(index, console, std::size_t(frame)), NH_ERR_OK)
+            << "frame " << frame;
+        ASSERT_EQ(nh_state_hash(console), hashes[frame - 1])
+            << "frame " << frame;
+        for (int i = frame; i < frame + 10 && i < FRAMES; ++i)
+        {
+            ASSERT_EQ(nh_movie_play(movie, console, std::size_t(i)),
+                      NH_ERR_OK);
+            ASSERT_EQ(nh_state_hash(console), hashes[i]) << "frame " << i;
+        }
+    }
+    EXPECT_EQ(nh_movie_seek(index, console, FRAMES + 1),
+              NH_ERR_INVALID_ARGUMENT);
+
+    nh_close_movie_index(index);
+
+    // A count off by 2^27 wraps back to the same covered frames in 32 bits,
+    // and to the same size too if the state size is a multiple of 32.
+    std::vector<NHByte> bytes = pv_read_file(index_path);
+    ASSERT_GE(bytes.size(), 32u);
+    bytes[31] = NHByte(bytes[31] + 0x08);
+    pv_write_file(index_path, bytes);
+    index = NH_NULL;
+    EXPECT_EQ(nh_open_movie_index(index_path.c_str(), movie, nht::logger(),
+                                  &index),
+              NH_ERR_CORRUPTED);
+    if (NH_VALID(index))
+    {
+        nh_close_movie_index(index);
+    }
+    std::remove(index_path.c_str());
+}
+
+// NROM reading the controllers and MMC1
+INSTANTIATE_TEST_SUITE_P(roms, movie_test,
+                         ::testing::Values("dma_4016_read.nes",
+                                           "apu_test.nes"));
+
+std::vector<NHByte>
+pv_read_file(const std::string &i_path)
+{
+    std::ifstream file(i_path, std::ios::binary);
+    return std::vector<NHByte>(std::istreambuf_iterator<char>(file),
+                               std::istreambuf_iterator<char>());
+}
+
+void
+pv_write_file(const std::string &i_path, const std::vector<NHByte> &i_bytes)
+{
+    std::ofstream file(i_path, std::ios::binary | std::ios::trunc);
+    file.write((const char *)i_bytes.data(), std::streamsize(i_bytes.size()));
+}
@@ -0,0 +1,197 @@
+#include "rom_test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+// One way between the players in memory, holding datagrams a few steps at
+// random, and losing, duplicating and reordering some of them.
+struct pv_Link {
+    struct Datagram {
+        int due;
+        std::vector<NHByte> data;
+    };
+
+    const int *now;
+    std::deque<Datagram> queue;
+    std::mt19937 rng;
+};
+
+// What a player sends over and receives from
+struct pv_Ends {
+    pv_Link *out;
+    pv_Link *in;
+};
+
+static void
+pv_send(const void *data, size_t size, void *user);
+static size_t
+pv_recv(void *data, size_t size, void *user);
+
+static NHByte
+pv_input(int i_player, std::size_t i_frame);
+
+class netplay_test : public nht::ConsoleTest<> {
+  protected:
+    void
+    SetUp() override
+    {
+        nht::ConsoleTest<>::SetUp();
+        now = 0;
+        for (int i = 0; i < 2; ++i)
+        {
+            players[i] = NH_NULL;
+            netplays[i] = NH_NULL;
+            links[i].now = &now;
+            links[i].rng.seed(std::uint32_t(i + 1));
+            ends[i] = pv_Ends{&links[1 - i], &links[i]};
+            transports[i] = NHNetTransport{pv_send, pv_recv, &ends[i]};
+        }
+    }
+
+    void
+    TearDown() override
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            if (NH_VALID(netplays[i]))
+            {
+                nh_release_netplay(netplays[i]);
+            }
+            if (NH_VALID(players[i]))
+            {
+                nh_release_console(players[i]);
+            }
+        }
+        nht::ConsoleTest<>::TearDown();
+    }
+
+    int now; // in steps
+    pv_Link links[2]; // to player i
+    pv_Ends ends[2];
+    NHNetTransport transports[2];
+    NHConsole players[2];
+    NHNetplay netplays[2];
+};
+
+TEST_F(netplay_test, converges)
+{
+    const char *rom = "dma_4016_read.nes";
+    for (int i = 0; i < 2; ++i)
+    {
+        players[i] = nht::new_console(rom);
+        ASSERT_TRUE(NH_VALID(players[i]));
+        ASSERT_EQ(nh_new_netplay(players[i], NHCtrlPort(i), &transports[i], 8,
+                                 nht::logger(), &netplays[i]),
+                  NH_ERR_OK);
+    }
+
+    // Hashes of the frames a player had all input for when run
+    std::map<std::size_t, std::uint64_t> confirmed[2];
+    // Taking turns at random, one at times held up for a while, as hosts
+    // don't run in step.
+    std::mt19937 rng(7);
+    constexpr int STEPS = 300;
+    for (now = 0; now < STEPS; ++now)
+    {
+        int first = int(rng() % 2);
+        for (int turn = 0; turn < 2; ++turn)
+        {
+            int i = first ^ turn;
+            if (rng() % 8 == 0)
+            {
+                continue;
+            }
+
+            NHNetplayStats stats;
+            nh_netplay_get_stats(netplays[i], &stats);
+            NHErr err =
+                nh_netplay_run_frame(netplays[i], pv_input(i, stats.frame));
+            ASSERT_TRUE(err == NH_ERR_OK || err == NH_ERR_UNAVAILABLE);
+
+            nh_netplay_get_stats(netplays[i], &stats);
+            if (stats.confirmed >= stats.frame)
+            {
+                confirmed[i][stats.frame] = nh_state_hash(players[i]);
+            }
+        }
+    }
+
+    NHNetplayStats stats[2];
+    nh_netplay_get_stats(netplays[0], &stats[0]);
+    nh_netplay_get_stats(netplays[1], &stats[1]);
+    EXPECT_GT(stats[0].rollbacks + stats[1].rollbacks, 0u);
+    std::size_t frames = std::max(stats[0].frame, stats[1].frame);
+    ASSERT_GT(frames, std::size_t(STEPS / 2));
+
+    // The same as one console with all input in time
+    console = nht::new_console(rom);
+    ASSERT_TRUE(NH_VALID(console));
+    for (std::size_t frame = 1; frame <= frames; ++frame)
+    {
+        nh_set_buttons(console, NH_CTRL_P1, pv_input(0, frame - 1));
+        nh_set_buttons(console, NH_CTRL_P2, pv_input(1, frame - 1));
+        nh_run_frame(console);
+        std::uint64_t hash = nh_state_hash(console);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            auto it = confirmed[i].find(frame);
+            if (it != confirmed[i].end())
+            {
+                ASSERT_EQ(it->second, hash)
+                    << "player " << i << ", frame " << frame;
+            }
+        }
+    }
+    EXPECT_FALSE(confirmed[0].empty());
+    EXPECT_FALSE(confirmed[1].empty());
+}
+
+NHByte
+pv_input(int i_player, std::size_t i_frame)
+{
+    // Held for a while, as players do.
+    return i_player ? NHByte(i_frame / 5 * 11) : NHByte(i_frame / 8 * 37);
+}
+
+void
+pv_send(const void *data, size_t size, void *user)
+{
+    pv_Link *link = ((pv_Ends *)user)->out;
+    unsigned roll = link->rng() % 10;
+    if (roll == 0)
+    {
+        return; // lost
+    }
+    int copies = roll == 1 ? 2 : 1;
+    for (int i = 0; i < copies; ++i)
+    {
+        int due = *link->now + int(link->rng() % 4);
+        link->queue.push_back(pv_Link::Datagram{
+            due, std::vector<NHByte>((const NHByte *)data,
+                                     (const NHByte *)data + size)});
+    }
+}
+
+size_t
+pv_recv(void *data, size_t size, void *user)
+{
+    pv_Link *link = ((pv_Ends *)user)->in;
+    // Whichever is due first, not the first sent
+    for (auto it = link->queue.begin(); it != link->queue.end(); ++it)
+    {
+        if (it->due <= *link->now)
+        {
+            std::size_t got = std::min(size, it->data.size());
+            std::copy(it->data.begin(), it->data.begin() + got,
+                      (NHByte *)data);
+            link->queue.erase(it);
+            return got;
+        }
+    }
+    return 0;
+}
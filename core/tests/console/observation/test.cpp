@@ -0,0 +1,269 @@
+#include "rom_test.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static std::vector<NHByte>
+pv_expected(NHConsole i_console, int i_width, int i_height);
+static std::vector<NHByte>
+pv_rows(const NHByte *i_first, int i_width, int i_height, int i_pitch);
+
+class observation_test : public nht::RomTest {};
+
+TEST_P(observation_test, luma_of_frame)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    // Full size, then binned unevenly with padded and bottom-up rows.
+    constexpr int FULL_W = NH_NES_WIDTH;
+    constexpr int FULL_H = NH_NES_HEIGHT;
+    constexpr int W = 84;
+    constexpr int H = 84;
+    constexpr int PITCH = 96;
+    constexpr NHByte UNTOUCHED = 0xA5;
+    std::vector<NHByte> full(FULL_W * FULL_H, UNTOUCHED);
+    std::vector<NHByte> padded(PITCH * H, UNTOUCHED);
+    std::vector<NHByte> flipped(W * H, UNTOUCHED);
+    NHByte *last_row = flipped.data() + (H - 1) * W;
+
+    constexpr int FRAMES = 60;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            ASSERT_EQ(nh_set_observation(console, full.data(), FULL_W, FULL_H,
+                                         FULL_W),
+                      NH_ERR_OK);
+            break;
+        case 1:
+            ASSERT_EQ(nh_set_observation(console, padded.data(), W, H, PITCH),
+                      NH_ERR_OK);
+            break;
+        default:
+            ASSERT_EQ(nh_set_observation(console, last_row, W, H, -W),
+                      NH_ERR_OK);
+            break;
+        }
+        nh_run_frame(console);
+
+        switch (i % 3)
+        {
+        case 0:
+            ASSERT_EQ(full, pv_expected(console, FULL_W, FULL_H))
+                << "frame " << i;
+            break;
+        case 1:
+            ASSERT_EQ(pv_rows(padded.data(), W, H, PITCH),
+                      pv_expected(console, W, H))
+                << "frame " << i;
+            for (int y = 0; y < H; ++y)
+            {
+                ASSERT_TRUE(std::all_of(
+                    padded.begin() + y * PITCH + W,
+                    padded.begin() + (y + 1) * PITCH,
+                    [](NHByte b) { return b == UNTOUCHED; }))
+                    << "row " << y;
+            }
+            break;
+        default:
+            ASSERT_EQ(pv_rows(last_row, W, H, -W), pv_expected(console, W, H))
+                << "frame " << i;
+            break;
+        }
+    }
+    // Something on screen to compare
+    auto expected = pv_expected(console, FULL_W, FULL_H);
+    EXPECT_NE(std::count(expected.begin(), expected.end(), expected[0]),
+              std::ptrdiff_t(expected.size()));
+
+    // Stopped
+    ASSERT_EQ(nh_set_observation(console, nullptr, 0, 0, 0), NH_ERR_OK);
+    std::vector<NHByte> before = flipped;
+    nh_run_frame(console);
+    EXPECT_EQ(flipped, before);
+}
+
+TEST_P(observation_test, invalid_argument)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    constexpr int W = 84;
+    constexpr int H = 84;
+    std::vector<NHByte> pixels((NH_NES_WIDTH + 1) * (NH_NES_HEIGHT + 1));
+    NHByte *mid = pixels.data() + pixels.size() / 2;
+    // Larger than a frame
+    EXPECT_EQ(nh_set_observation(console, pixels.data(), NH_NES_WIDTH + 1, H,
+                                 NH_NES_WIDTH + 1),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_set_observation(console, pixels.data(), W, NH_NES_HEIGHT + 1,
+                                 W),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_set_observation(console, pixels.data(), 0, H, W),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_set_observation(console, pixels.data(), W, 0, W),
+              NH_ERR_INVALID_ARGUMENT);
+    // Rows overlapping
+    EXPECT_EQ(nh_set_observation(console, pixels.data(), W, H, W - 1),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_set_observation(console, mid, W, H, -(W - 1)),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_set_observation(console, mid, W, H, 0),
+              NH_ERR_INVALID_ARGUMENT);
+
+    // Nothing written after a failure.
+    std::fill(pixels.begin(), pixels.end(), NHByte(0xA5));
+    nh_run_frame(console);
+    EXPECT_TRUE(std::all_of(pixels.begin(), pixels.end(),
+                            [](NHByte b) { return b == 0xA5; }));
+}
+
+TEST_P(observation_test, pool)
+{
+    auto rom_path = nb::resolve_exe_dir(GetParam());
+    NHRom rom = NH_NULL;
+    ASSERT_EQ(nh_load_rom(rom_path.c_str(), nht::logger(), &rom), NH_ERR_OK);
+    NHPool pool = NH_NULL;
+    constexpr int CONSOLES = 3;
+    NHErr err = nh_new_pool(rom, CONSOLES, 2, nht::logger(), &pool);
+    nh_release_rom(rom);
+    ASSERT_EQ(err, NH_ERR_OK);
+
+    // One batch, with a gap after each observation
+    constexpr int W = 84;
+    constexpr int H = 84;
+    constexpr std::ptrdiff_t STRIDE = W * H + 16;
+    std::vector<NHByte> batch(STRIDE * CONSOLES);
+    EXPECT_EQ(
+        nh_pool_set_observations(pool, batch.data(), STRIDE, W, H, W - 1),
+        NH_ERR_INVALID_ARGUMENT);
+    ASSERT_EQ(nh_pool_set_observations(pool, batch.data(), STRIDE, W, H, W),
+              NH_ERR_OK);
+
+    constexpr int STEPS = 40;
+    NHByte actions[CONSOLES];
+    for (int step = 0; step < STEPS; ++step)
+    {
+        for (int i = 0; i < CONSOLES; ++i)
+        {
+            actions[i] = NHByte(step * 7 + i * 13);
+        }
+        nh_pool_step(pool, actions, nullptr);
+        for (int i = 0; i < CONSOLES; ++i)
+        {
+            ASSERT_EQ(pv_rows(batch.data() + i * STRIDE, W, H, W),
+                      pv_expected(nh_pool_get_console(pool, i), W, H))
+                << "console " << i << ", step " << step;
+        }
+    }
+
+    // Stopped for all
+    ASSERT_EQ(nh_pool_set_observations(pool, nullptr, 0, 0, 0, 0), NH_ERR_OK);
+    std::vector<NHByte> before = batch;
+    nh_pool_step(pool, actions, nullptr);
+    EXPECT_EQ(batch, before);
+    nh_release_pool(pool);
+}
+
+TEST_P(observation_test, ram)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    const NHByte *ram = nh_get_ram(console);
+    ASSERT_NE(ram, nullptr);
+
+    // Early on, while the ROM is still at work
+    constexpr int FRAMES = 5;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        nh_run_frame(console);
+    }
+    std::vector<NHByte> saved_ram(ram, ram + NH_RAM_SIZE);
+    std::vector<NHByte> state(nh_state_size(console));
+    ASSERT_EQ(nh_save_state(console, state.data(), state.size()), NH_ERR_OK);
+    // Reading has no side effect.
+    std::uint64_t hash = nh_state_hash(console);
+    EXPECT_EQ(std::memcmp(nh_get_ram(console), saved_ram.data(), NH_RAM_SIZE),
+              0);
+    EXPECT_EQ(nh_state_hash(console), hash);
+
+    // The same view as the game goes on, and as states are loaded.
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        nh_run_frame(console);
+    }
+    ASSERT_EQ(nh_get_ram(console), ram);
+    EXPECT_NE(std::vector<NHByte>(ram, ram + NH_RAM_SIZE), saved_ram);
+    ASSERT_EQ(nh_load_state(console, state.data(), state.size()), NH_ERR_OK);
+    EXPECT_EQ(std::vector<NHByte>(ram, ram + NH_RAM_SIZE), saved_ram);
+
+    NHConsole clone = NH_NULL;
+    ASSERT_EQ(nh_clone_console(console, &clone), NH_ERR_OK);
+    const NHByte *clone_ram = nh_get_ram(clone);
+    EXPECT_NE(clone_ram, ram);
+    EXPECT_EQ(std::vector<NHByte>(clone_ram, clone_ram + NH_RAM_SIZE),
+              saved_ram);
+    nh_release_console(clone);
+}
+
+// CNROM and NROM, with text on screen
+INSTANTIATE_TEST_SUITE_P(roms, observation_test,
+                         ::testing::Values("cpu_dummy_reads.nes",
+                                           "vram_access.nes",
+                                           "dma_4016_read.nes"));
+
+std::vector<NHByte>
+pv_expected(NHConsole i_console, int i_width, int i_height)
+{
+    // Rec. 601 luma of the RGB frame
+    NHFrame frame = nh_get_frm(i_console);
+    const NHByte *rgb = nh_frm_data(frame);
+    std::vector<int> luma(NH_NES_WIDTH * NH_NES_HEIGHT);
+    for (std::size_t i = 0; i < luma.size(); ++i)
+    {
+        const NHByte *p = rgb + i * 3;
+        luma[i] = (299 * p[0] + 587 * p[1] + 114 * p[2] + 500) / 1000;
+    }
+
+    // Averaged over the pixels each covers, rounded half up
+    std::vector<NHByte> pixels(std::size_t(i_width * i_height));
+    for (int y = 0; y < i_height; ++y)
+    {
+        int top = y * NH_NES_HEIGHT / i_height;
+        int bottom = (y + 1) * NH_NES_HEIGHT / i_height;
+        for (int x = 0; x < i_width; ++x)
+        {
+            int left = x * NH_NES_WIDTH / i_width;
+            int right = (x + 1) * NH_NES_WIDTH / i_width;
+            int sum = 0;
+            for (int v = top; v < bottom; ++v)
+            {
+                for (int u = left; u < right; ++u)
+                {
+                    sum += luma[std::size_t(v * NH_NES_WIDTH + u)];
+                }
+            }
+            int count = (bottom - top) * (right - left);
+            pixels[std::size_t(y * i_width + x)] =
+                NHByte((sum + count / 2) / count);
+        }
+    }
+    return pixels;
+}
+
+std::vector<NHByte>
+pv_rows(const NHByte *i_first, int i_width, int i_height, int i_pitch)
+{
+    std::vector<NHByte> pixels;
+    for (int y = 0; y < i_height; ++y)
+    {
+        const NHByte *row = i_first + std::ptrdiff_t(y) * i_pitch;
+        pixels.insert(pixels.end(), row, row + i_width);
+    }
+    return pixels;
+}
@@ -0,0 +1,112 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+static NHConsole
+pv_power_up(NHRom i_rom);
+
+class pool_test : public ::testing::TestWithParam<const char *> {
+  protected:
+    void
+    SetUp() override
+    {
+        rom = NH_NULL;
+        pool = NH_NULL;
+    }
+
+    void
+    TearDown() override
+    {
+        for (NHConsole console : consoles)
+        {
+            nh_release_console(console);
+        }
+        if (NH_VALID(pool))
+        {
+            nh_release_pool(pool);
+        }
+        if (NH_VALID(rom))
+        {
+            nh_release_rom(rom);
+        }
+    }
+
+    NHRom rom;
+    NHPool pool;
+    std::vector<NHConsole> consoles; // standalone
+};
+
+TEST_P(pool_test, matches_standalone)
+{
+    auto rom_path = nb::resolve_exe_dir(GetParam());
+    ASSERT_EQ(nh_load_rom(rom_path.c_str(), nht::logger(), &rom), NH_ERR_OK);
+
+    constexpr int CONSOLES = 4;
+    constexpr int EPISODE = 30;
+    constexpr int STEPS = 70;
+    ASSERT_EQ(nh_new_pool(rom, CONSOLES, 3, nht::logger(), &pool), NH_ERR_OK);
+    nh_pool_set_episode(pool, EPISODE);
+    std::uint64_t power_up_hash = nh_state_hash(nh_pool_get_console(pool, 0));
+    for (int i = 0; i < CONSOLES; ++i)
+    {
+        consoles.push_back(pv_power_up(rom));
+        ASSERT_TRUE(NH_VALID(consoles.back()));
+        ASSERT_EQ(nh_state_hash(nh_pool_get_console(pool, i)), power_up_hash);
+    }
+    EXPECT_FALSE(NH_VALID(nh_pool_get_console(pool, CONSOLES)));
+
+    NHByte actions[CONSOLES];
+    NHByte dones[CONSOLES];
+    for (int step = 0; step < STEPS; ++step)
+    {
+        for (int i = 0; i < CONSOLES; ++i)
+        {
+            actions[i] = NHByte(step * 7 + i * 13);
+        }
+        nh_pool_step(pool, actions, dones);
+
+        // One after another, starting over the same way at the episode end.
+        bool done = (step + 1) % EPISODE == 0;
+        for (int i = 0; i < CONSOLES; ++i)
+        {
+            nh_set_buttons(consoles[i], NH_CTRL_P1, actions[i]);
+            nh_run_frame(consoles[i]);
+            if (done)
+            {
+                nh_release_console(consoles[i]);
+                consoles[i] = pv_power_up(rom);
+                ASSERT_TRUE(NH_VALID(consoles[i]));
+            }
+
+            ASSERT_EQ(dones[i], NHByte(done))
+                << "console " << i << ", step " << step;
+            NHConsole pooled = nh_pool_get_console(pool, i);
+            ASSERT_EQ(nh_state_hash(pooled), nh_state_hash(consoles[i]))
+                << "console " << i << ", step " << step;
+            if (done)
+            {
+                ASSERT_EQ(nh_state_hash(pooled), power_up_hash);
+            }
+        }
+    }
+}
+
+// NROM reading the controller and MMC1
+INSTANTIATE_TEST_SUITE_P(roms, pool_test,
+                         ::testing::Values("dma_4016_read.nes",
+                                           "apu_test.nes"));
+
+NHConsole
+pv_power_up(NHRom i_rom)
+{
+    NHConsole console = nh_new_console(nht::logger());
+    if (NH_FAILED(nh_insert_rom(console, i_rom)))
+    {
+        nh_release_console(console);
+        return NH_NULL;
+    }
+    nh_set_buttons(console, NH_CTRL_P1, 0);
+    nh_power_up(console);
+    return console;
+}
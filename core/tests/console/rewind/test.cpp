@@ -0,0 +1,89 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+static std::vector<std::uint64_t>
+pv_run(NHConsole io_console, int i_frames);
+
+class rewind_test : public nht::RomTest {};
+
+TEST_P(rewind_test, every_frame)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    ASSERT_EQ(nh_set_rewind(console, 1, 16 * 1024 * 1024), NH_ERR_OK);
+    EXPECT_EQ(nh_rewind(console, 1, nullptr), NH_ERR_UNAVAILABLE);
+
+    // hashes[i] after frame i + 1, the first snapshot
+    constexpr int FRAMES = 120;
+    std::vector<std::uint64_t> hashes = pv_run(console, FRAMES);
+
+    int frame = FRAMES - 1;
+    for (int k : {1, 2, 7, 30})
+    {
+        int rewound = -1;
+        ASSERT_EQ(nh_rewind(console, k, &rewound), NH_ERR_OK);
+        ASSERT_EQ(rewound, k);
+        frame -= k;
+        ASSERT_EQ(nh_state_hash(console), hashes[frame]) << "frame " << frame;
+    }
+
+    // The way forward again is the same.
+    std::vector<std::uint64_t> again = pv_run(console, FRAMES - 1 - frame);
+    for (std::size_t i = 0; i < again.size(); ++i)
+    {
+        ASSERT_EQ(again[i], hashes[frame + 1 + i]) << "frame " << i;
+    }
+
+    // All the way back to the first.
+    int rewound = -1;
+    ASSERT_EQ(nh_rewind(console, FRAMES * 2, &rewound), NH_ERR_OK);
+    EXPECT_EQ(rewound, FRAMES - 1);
+    EXPECT_EQ(nh_state_hash(console), hashes[0]);
+}
+
+TEST_P(rewind_test, wraps)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    // Room for some deltas only
+    ASSERT_EQ(nh_set_rewind(console, 1, 8 * 1024), NH_ERR_OK);
+
+    constexpr int FRAMES = 300;
+    std::vector<std::uint64_t> hashes = pv_run(console, FRAMES);
+
+    int frame = FRAMES - 1;
+    for (;;)
+    {
+        int rewound = -1;
+        ASSERT_EQ(nh_rewind(console, 1, &rewound), NH_ERR_OK);
+        if (rewound == 0)
+        {
+            break;
+        }
+        ASSERT_EQ(rewound, 1);
+        --frame;
+        ASSERT_EQ(nh_state_hash(console), hashes[frame]) << "frame " << frame;
+    }
+    // The oldest were dropped, but not all.
+    EXPECT_GT(frame, 0);
+    EXPECT_LT(frame, FRAMES - 1);
+}
+
+// NROM and MMC1 with CHR RAM, CNROM
+INSTANTIATE_TEST_SUITE_P(roms, rewind_test,
+                         ::testing::Values("vram_access.nes", "apu_test.nes",
+                                           "cpu_dummy_reads.nes"));
+
+std::vector<std::uint64_t>
+pv_run(NHConsole io_console, int i_frames)
+{
+    std::vector<std::uint64_t> hashes;
+    for (int i = 0; i < i_frames; ++i)
+    {
+        nh_run_frame(io_console);
+        hashes.push_back(nh_state_hash(io_console));
+    }
+    return hashes;
+}
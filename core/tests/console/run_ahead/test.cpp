@@ -0,0 +1,133 @@
+#include "rom_test.hpp"
+
+#include <cstddef>
+#include <vector>
+
+static void
+pv_write(const double *i_samples, std::size_t i_count, void *i_user);
+static std::vector<NHByte>
+pv_frame(NHConsole i_console);
+
+class run_ahead_test : public nht::RomTest {
+  protected:
+    void
+    SetUp() override
+    {
+        nht::RomTest::SetUp();
+        plain = NH_NULL;
+        clone = NH_NULL;
+    }
+
+    void
+    TearDown() override
+    {
+        if (NH_VALID(clone))
+        {
+            nh_release_console(clone);
+        }
+        if (NH_VALID(plain))
+        {
+            nh_release_console(plain);
+        }
+        nht::RomTest::TearDown();
+    }
+
+    NHConsole plain;
+    NHConsole clone;
+};
+
+TEST_P(run_ahead_test, matches_plain_console)
+{
+    constexpr int RUN_AHEAD = 2;
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    plain = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(plain));
+    ASSERT_EQ(nh_set_run_ahead(console, RUN_AHEAD), NH_ERR_OK);
+
+    std::vector<double> samples;
+    std::vector<double> plain_samples;
+    NHAudioSink sink{pv_write, &samples};
+    NHAudioSink plain_sink{pv_write, &plain_samples};
+    nh_plug_audio_sink(console, &sink);
+    nh_plug_audio_sink(plain, &plain_sink);
+
+    constexpr int FRAMES = 60;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        NHByte buttons = NHByte(i * 37);
+        nh_set_buttons(console, NH_CTRL_P1, buttons);
+        nh_set_buttons(plain, NH_CTRL_P1, buttons);
+        if (i % 3 == 2)
+        {
+            // More than a frame, ending mid-frame
+            constexpr NHCycle CYCLES = 40000;
+            nh_run_cycles(console, CYCLES);
+            nh_run_cycles(plain, CYCLES);
+        }
+        else
+        {
+            nh_run_frame(console);
+            nh_run_frame(plain);
+        }
+        ASSERT_EQ(nh_state_hash(console), nh_state_hash(plain))
+            << "frame " << i;
+        // None of the frames run ahead is heard.
+        ASSERT_FALSE(plain_samples.empty());
+        ASSERT_EQ(samples, plain_samples) << "frame " << i;
+        samples.clear();
+        plain_samples.clear();
+
+        // Shown as the plain console would a few frames later with the same
+        // input.
+        ASSERT_EQ(nh_clone_console(plain, &clone), NH_ERR_OK);
+        for (int j = 0; j < RUN_AHEAD; ++j)
+        {
+            nh_run_frame(clone);
+        }
+        ASSERT_EQ(pv_frame(console), pv_frame(clone)) << "frame " << i;
+        nh_release_console(clone);
+        clone = NH_NULL;
+    }
+
+    // Off again, frames are those run.
+    ASSERT_EQ(nh_set_run_ahead(console, 0), NH_ERR_OK);
+    nh_run_frame(console);
+    nh_run_frame(plain);
+    EXPECT_EQ(nh_state_hash(console), nh_state_hash(plain));
+    EXPECT_EQ(pv_frame(console), pv_frame(plain));
+    EXPECT_EQ(samples, plain_samples);
+
+    nh_unplug_audio_sink(console);
+    nh_unplug_audio_sink(plain);
+}
+
+TEST(run_ahead, negative_frames)
+{
+    NHConsole console = nht::new_console("apu_test.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    EXPECT_EQ(nh_set_run_ahead(console, -1), NH_ERR_INVALID_ARGUMENT);
+    nh_release_console(console);
+}
+
+// NROM reading the controllers, MMC1 with sound and CNROM
+INSTANTIATE_TEST_SUITE_P(roms, run_ahead_test,
+                         ::testing::Values("dma_4016_read.nes",
+                                           "apu_test.nes",
+                                           "cpu_dummy_reads.nes"));
+
+void
+pv_write(const double *i_samples, std::size_t i_count, void *i_user)
+{
+    auto samples = static_cast<std::vector<double> *>(i_user);
+    samples->insert(samples->end(), i_samples, i_samples + i_count);
+}
+
+std::vector<NHByte>
+pv_frame(NHConsole i_console)
+{
+    NHFrame frame = nh_get_frm(i_console);
+    const NHByte *indices = nh_frm_indices(frame);
+    return std::vector<NHByte>(indices, indices + nh_frm_width(frame) *
+                                                      nh_frm_height(frame));
+}
@@ -0,0 +1,62 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+
+class run_cycles_test : public nht::RomTest {
+  protected:
+    void
+    SetUp() override
+    {
+        nht::RomTest::SetUp();
+        stepped = NH_NULL;
+    }
+
+    void
+    TearDown() override
+    {
+        if (NH_VALID(stepped))
+        {
+            nh_release_console(stepped);
+        }
+        nht::RomTest::TearDown();
+    }
+
+    NHConsole stepped;
+};
+
+TEST_P(run_cycles_test, idle_skip_in_chunks)
+{
+    // Run in chunks of all sizes with idle loops skipped and DMA done at once
+    // wherever possible, against a cycle at a time.
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    nh_set_idle_skip(console, 1);
+    stepped = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(stepped));
+
+    constexpr NHCycle CHUNKS[] = {1, 7, 113, 2273, 29781, 100000};
+    constexpr int ROUNDS = 8;
+    NHCycle cycles = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        for (NHCycle chunk : CHUNKS)
+        {
+            nh_run_cycles(console, chunk);
+            for (NHCycle i = 0; i < chunk; ++i)
+            {
+                nh_tick(stepped, nullptr);
+            }
+            cycles += chunk;
+
+            ASSERT_EQ(nh_state_hash(console), nh_state_hash(stepped))
+                << "after " << cycles << " cycles";
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(roms, run_cycles_test,
+                         ::testing::Values("4-irq_and_dma.nes",
+                                           "05-nmi_timing.nes",
+                                           "7-dmc_basics.nes",
+                                           "sprdma_and_dmc_dma.nes",
+                                           "dma_2007_read.nes"));
@@ -0,0 +1,138 @@
+#include "rom_test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+static std::vector<NHByte>
+pv_frame(NHConsole i_console);
+
+class state_test : public nht::RomTest {};
+
+TEST_P(state_test, round_trip)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    constexpr int FRAMES = 30;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        nh_run_frame(console);
+    }
+
+    std::vector<NHByte> state(nh_state_size(console));
+    ASSERT_FALSE(state.empty());
+    ASSERT_EQ(nh_save_state(console, state.data(), state.size()), NH_ERR_OK);
+    std::uint64_t saved_hash = nh_state_hash(console);
+
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::vector<NHByte>> frames;
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        nh_run_frame(console);
+        hashes.push_back(nh_state_hash(console));
+        frames.push_back(pv_frame(console));
+    }
+
+    ASSERT_EQ(nh_load_state(console, state.data(), state.size()), NH_ERR_OK);
+    EXPECT_EQ(nh_state_hash(console), saved_hash);
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        nh_run_frame(console);
+        ASSERT_EQ(nh_state_hash(console), hashes[i]) << "frame " << i;
+        ASSERT_EQ(pv_frame(console), frames[i]) << "frame " << i;
+    }
+}
+
+TEST_P(state_test, stable_size)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    std::size_t size = nh_state_size(console);
+    ASSERT_GT(size, 0u);
+
+    std::vector<NHByte> state(size);
+    EXPECT_EQ(nh_save_state(console, state.data(), size - 1),
+              NH_ERR_INVALID_ARGUMENT);
+    for (int i = 0; i < 10; ++i)
+    {
+        nh_run_frame(console);
+        EXPECT_EQ(nh_state_size(console), size);
+    }
+    ASSERT_EQ(nh_save_state(console, state.data(), size), NH_ERR_OK);
+    nh_reset(console);
+    EXPECT_EQ(nh_state_size(console), size);
+    ASSERT_EQ(nh_load_state(console, state.data(), size), NH_ERR_OK);
+    EXPECT_EQ(nh_state_size(console), size);
+}
+
+TEST_P(state_test, rejects_bad_states)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+    std::vector<NHByte> state(nh_state_size(console));
+    ASSERT_EQ(nh_save_state(console, state.data(), state.size()), NH_ERR_OK);
+    for (int i = 0; i < 10; ++i)
+    {
+        nh_run_frame(console);
+    }
+    std::uint64_t hash = nh_state_hash(console);
+
+    // Header: magic, version, size and ROM hash, 4 bytes each
+    struct Case {
+        std::size_t offset;
+        NHErr err;
+    };
+    const Case cases[] = {
+        {0, NH_ERR_CORRUPTED},
+        {4, NH_ERR_CORRUPTED},
+        {8, NH_ERR_CORRUPTED},
+        {12, NH_ERR_INVALID_ARGUMENT},
+    };
+    for (const Case &c : cases)
+    {
+        std::vector<NHByte> bad = state;
+        bad[c.offset] ^= 0x01;
+        EXPECT_EQ(nh_load_state(console, bad.data(), bad.size()), c.err)
+            << "offset " << c.offset;
+        EXPECT_EQ(nh_state_hash(console), hash) << "offset " << c.offset;
+    }
+
+    EXPECT_EQ(nh_load_state(console, state.data(), state.size() - 1),
+              NH_ERR_CORRUPTED);
+    EXPECT_EQ(nh_load_state(console, nullptr, state.size()),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_state_hash(console), hash);
+}
+
+// NROM, NROM with CHR RAM, MMC1 and CNROM
+INSTANTIATE_TEST_SUITE_P(mappers, state_test,
+                         ::testing::Values("nestest.nes", "dma_2007_read.nes",
+                                           "apu_test.nes",
+                                           "cpu_dummy_reads.nes"));
+
+class state_cart_test : public nht::ConsoleTest<> {};
+
+TEST_F(state_cart_test, rejects_other_cartridge)
+{
+    console = nht::new_console("dma_2007_read.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    std::vector<NHByte> state(nh_state_size(console));
+    ASSERT_EQ(nh_save_state(console, state.data(), state.size()), NH_ERR_OK);
+    nh_release_console(console);
+
+    console = nht::new_console("dma_2007_write.nes");
+    ASSERT_TRUE(NH_VALID(console));
+    ASSERT_EQ(nh_state_size(console), state.size());
+    std::uint64_t hash = nh_state_hash(console);
+    EXPECT_EQ(nh_load_state(console, state.data(), state.size()),
+              NH_ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(nh_state_hash(console), hash);
+}
+
+std::vector<NHByte>
+pv_frame(NHConsole i_console)
+{
+    NHFrame frame = nh_get_frm(i_console);
+    const NHByte *indices = nh_frm_indices(frame);
+    return std::vector<NHByte>(indices, indices + nh_frm_width(frame) *
+                                                      nh_frm_height(frame));
+}
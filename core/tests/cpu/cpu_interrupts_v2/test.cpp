@@ -0,0 +1,21 @@
+#include "rom_test.hpp"
+
+#include <string>
+
+class cpu_interrupts_test : public nht::RomTest {};
+
+TEST_P(cpu_interrupts_test, rom_singles)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    std::string text;
+    EXPECT_EQ(nht::run_blargg_test(console, 600, &text), 0) << text;
+}
+
+INSTANTIATE_TEST_SUITE_P(rom_singles, cpu_interrupts_test,
+                         ::testing::Values("1-cli_latency.nes",
+                                           "2-nmi_and_brk.nes",
+                                           "3-nmi_and_irq.nes",
+                                           "4-irq_and_dma.nes",
+                                           "5-branch_delays_irq.nes"));
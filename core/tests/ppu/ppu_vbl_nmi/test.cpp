@@ -0,0 +1,26 @@
+#include "rom_test.hpp"
+
+#include <string>
+
+class ppu_vbl_nmi_test : public nht::RomTest {};
+
+TEST_P(ppu_vbl_nmi_test, rom_singles)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    std::string text;
+    EXPECT_EQ(nht::run_blargg_test(console, 600, &text), 0) << text;
+}
+
+INSTANTIATE_TEST_SUITE_P(rom_singles, ppu_vbl_nmi_test,
+                         ::testing::Values("01-vbl_basics.nes",
+                                           "02-vbl_set_time.nes",
+                                           "03-vbl_clear_time.nes",
+                                           "04-nmi_control.nes",
+                                           "05-nmi_timing.nes",
+                                           "06-suppression.nes",
+                                           "07-nmi_on_timing.nes",
+                                           "08-nmi_off_timing.nes",
+                                           "09-even_odd_frames.nes",
+                                           "10-even_odd_timing.nes"));
@@ -0,0 +1,18 @@
+#include "rom_test.hpp"
+
+#include <string>
+
+class sprdma_and_dmc_dma_test : public nht::RomTest {};
+
+TEST_P(sprdma_and_dmc_dma_test, rom_singles)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    std::string text;
+    EXPECT_EQ(nht::run_blargg_test(console, 600, &text), 0) << text;
+}
+
+INSTANTIATE_TEST_SUITE_P(rom_singles, sprdma_and_dmc_dma_test,
+                         ::testing::Values("sprdma_and_dmc_dma.nes",
+                                           "sprdma_and_dmc_dma_512.nes"));
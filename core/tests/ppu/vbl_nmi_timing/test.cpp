@@ -0,0 +1,29 @@
+#include "rom_test.hpp"
+
+class vbl_nmi_timing_test : public nht::RomTest {};
+
+TEST_P(vbl_nmi_timing_test, roms)
+{
+    console = nht::new_console(GetParam());
+    ASSERT_TRUE(NH_VALID(console));
+
+    // Each ROM counts its tests up in $F8 from 2, and stops there at the first
+    // one failed, or sets 1 after all passed.
+    const NHByte *ram = nh_get_ram(console);
+    constexpr NHAddr RESULT = 0xF8;
+    constexpr int MAX_FRAMES = 600;
+    for (int i = 0; i < MAX_FRAMES && ram[RESULT] != 1; ++i)
+    {
+        nh_run_frame(console);
+    }
+    EXPECT_EQ(ram[RESULT], 1) << "Failed #" << int(ram[RESULT]);
+}
+
+INSTANTIATE_TEST_SUITE_P(roms, vbl_nmi_timing_test,
+                         ::testing::Values("1.frame_basics.nes",
+                                           "2.vbl_timing.nes",
+                                           "3.even_odd_frames.nes",
+                                           "4.vbl_clear_timing.nes",
+                                           "5.nmi_suppression.nes",
+                                           "6.nmi_disable.nes",
+                                           "7.nmi_timing.nes"));
@@ -108,6 +108,8 @@ namespace sh {
 #define DEBUG_AUDIO_PCM 0 // Record audio pcm file
 
 #define FRAME_TIME (1.0 / 60.0)
+#define REWIND_KEY GLFW_KEY_BACKSPACE // Hold to play backwards
+#define REWIND_CAPACITY (32 * 1024 * 1024)
 #define AUDIO_SAMPLE_RATE 48000 // Most common rate for audio hardware
 #define AUDIO_BUF_SIZE 512      // Close to 1 frame worth of buffer
 // 800 = 1 / 60 * 48000, x2 for peak storage
@@ -382,6 +384,11 @@ Application::init()
     {
         goto l_err;
     }
+
+    /* Receive emulator samples */
+    m_audio_sink.write = audio_sink;
+    m_audio_sink.user = this;
+    nh_plug_audio_sink(m_emu, &m_audio_sink);
 #else
     (void)(audio_playback);
 #endif
@@ -429,6 +436,10 @@ Application::release()
     release_game(); // if any
 
 #if !SH_NO_AUDIO
+    if (NH_VALID(m_emu))
+    {
+        nh_unplug_audio_sink(m_emu);
+    }
     audio_shutdown();
 
 #ifndef SH_TGT_WEB
@@ -598,43 +609,27 @@ Application::tick(double i_delta_s)
     /* Emulate */
     if (running_game() && !m_paused)
     {
-        NHCycle ticks = nh_advance(m_emu, i_delta_s);
-        for (decltype(ticks) i = 0; i < ticks; ++i)
+        if (glfwGetKey(m_win, REWIND_KEY) == GLFW_PRESS)
         {
-            if (nh_tick(m_emu, nullptr))
+            // A frame further back each tick, run from the snapshot before it
+            // to have the frame to show, unheard: its samples play forward.
+            if (!NH_FAILED(nh_rewind(m_emu, 2, nullptr)))
             {
 #if !SH_NO_AUDIO
-                double sample = m_muted ? 0.0 : nh_get_sample(m_emu);
-                m_resampler->clock(short(sample * 32767));
-                // Once clocked, samples must be drained to avoid
-                // buffer overflow.
-                short buf[AUDIO_BUF_SIZE];
-                while (m_resampler->samples_avail(buf, AUDIO_BUF_SIZE))
-                {
-                    for (decltype(AUDIO_BUF_SIZE) j = 0; j < AUDIO_BUF_SIZE;
-                         ++j)
-                    {
-                        // If failed, sample gets dropped, but we are free
-                        // of inconsistent emulation due to blocking delay
-                        if (!to_AudioBuffer(m_audio_buf)
-                                 ->try_send(buf[j] / 32767.f))
-                        {
-#if DEBUG_AUDIO
-                            SH_LOG_WARN(m_logger, "Sample gets dropped");
+                nh_unplug_audio_sink(m_emu);
 #endif
-                        }
-
-#ifndef SH_TGT_WEB
-                        if (m_pcm_writer->is_open() && !m_muted)
-                        {
-                            m_pcm_writer->write_s16le(buf[j]);
-                        }
-#endif
-                    }
-                }
+                nh_run_frame(m_emu);
+#if !SH_NO_AUDIO
+                nh_plug_audio_sink(m_emu, &m_audio_sink);
 #endif
             }
         }
+        else
+        {
+            NHCycle ticks = nh_advance(m_emu, i_delta_s);
+            // Samples are delivered to audio_sink().
+            nh_run_cycles(m_emu, ticks);
+        }
     }
 
     /* Render */
@@ -726,6 +721,45 @@ Application::tick(double i_delta_s)
 #endif
 }
 
+#if !SH_NO_AUDIO
+void
+Application::audio_sink(const double *samples, size_t count, void *user)
+{
+    Application *thiz = (Application *)user;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        double sample = thiz->m_muted ? 0.0 : samples[i];
+        thiz->m_resampler->clock(short(sample * 32767));
+        // Once clocked, samples must be drained to avoid
+        // buffer overflow.
+        short buf[AUDIO_BUF_SIZE];
+        while (thiz->m_resampler->samples_avail(buf, AUDIO_BUF_SIZE))
+        {
+            for (decltype(AUDIO_BUF_SIZE) j = 0; j < AUDIO_BUF_SIZE; ++j)
+            {
+                // If failed, sample gets dropped, but we are free
+                // of inconsistent emulation due to blocking delay
+                if (!to_AudioBuffer(thiz->m_audio_buf)
+                         ->try_send(buf[j] / 32767.f))
+                {
+#if DEBUG_AUDIO
+                    SH_LOG_WARN(thiz->m_logger, "Sample gets dropped");
+#endif
+                }
+
+#ifndef SH_TGT_WEB
+                if (thiz->m_pcm_writer->is_open() && !thiz->m_muted)
+                {
+                    thiz->m_pcm_writer->write_s16le(buf[j]);
+                }
+#endif
+            }
+        }
+    }
+}
+#endif
+
 void
 Application::load_game(const char *i_id_path, const char *i_real_path)
 {
@@ -777,6 +811,11 @@ Application::load_game(const char *i_id_path, const char *i_real_path)
 
     /* Powerup */
     nh_power_up(m_emu);
+    // A snapshot every frame, so that it plays backwards smoothly.
+    if (NH_FAILED(nh_set_rewind(m_emu, 1, REWIND_CAPACITY)))
+    {
+        goto l_err;
+    }
 
     /* Flag running */
     SH_TRY
@@ -846,6 +885,7 @@ Application::release_game()
 
     if (NH_VALID(m_emu))
     {
+        nh_set_rewind(m_emu, 0, 0);
         nh_remove_cartridge(m_emu);
     }
 }
@@ -86,6 +86,11 @@ struct Application {
     key_callback(GLFWwindow *window, int vkey, int scancode, int action,
                  int mods);
 
+#if !SH_NO_AUDIO
+    static void
+    audio_sink(const double *samples, size_t count, void *user);
+#endif
+
   private:
     GLFWwindow *m_win;
     bool m_glfw_inited;
@@ -111,6 +116,7 @@ struct Application {
 #endif
 
 #if !SH_NO_AUDIO
+    NHAudioSink m_audio_sink;
     void *m_audio_buf;
     AudioData *m_audio_data;
     Resampler *m_resampler;